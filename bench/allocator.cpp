@@ -0,0 +1,69 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+
+// counts every trip through the global operator new
+static uint64_t allocations = 0;
+
+void *operator new(size_t size) {
+    ++allocations;
+    if (void *ptr = std::malloc(size))
+        return ptr;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+void operator delete(void *ptr, size_t) noexcept { std::free(ptr); }
+
+namespace {
+    using namespace utils;
+    constexpr uint64_t messages = 200000;
+
+    // create, fill and destroy one message buffer per iteration
+    template<class _buffer, class... _args>
+    void cycle(const char *name, _args &&... args) {
+        const uint64_t before = allocations;
+        const double ns = bench::measure(messages, [&] {
+            _buffer buffer(0x40, policy_t::growable, args...);
+            for (int i = 0; i < 16; ++i) {
+                buffer.setInt(i);
+                buffer.setString("field value");
+            }
+            bench::do_not_optimize(buffer.data());
+        });
+        char label[96];
+        std::snprintf(label, sizeof(label), "%s create/fill/destroy", name);
+        bench::report(label, ns, "ns/msg");
+        std::snprintf(label, sizeof(label), "%s operator new calls", name);
+        bench::report(label, double(allocations - before) / messages, "allocs/msg");
+    }
+}
+
+int main() {
+    cycle<wmemory_t>("std::allocator");
+    cycle<heap_wmemory_t>("heap_allocator");
+    cycle<concurrent_wmemory_t>("concurrent_allocator");
+    {
+        std::pmr::unsynchronized_pool_resource pool;
+        cycle<pmr_wmemory_t>("pmr unsynchronized_pool_resource", &pool);
+    }
+    {
+        arena_t arena(0x10000);
+        // reset the arena for each message, like a per-request allocator would
+        const uint64_t before = allocations;
+        const double ns = bench::measure(messages, [&] {
+            {
+                pmr_wmemory_t buffer(0x40, policy_t::growable, &arena);
+                for (int i = 0; i < 16; ++i) {
+                    buffer.setInt(i);
+                    buffer.setString("field value");
+                }
+                bench::do_not_optimize(buffer.data());
+            }
+            arena.reset();
+        });
+        bench::report("pmr arena_t create/fill/destroy", ns, "ns/msg");
+        bench::report("pmr arena_t operator new calls", double(allocations - before) / messages, "allocs/msg");
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,65 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+#include <random>
+
+namespace {
+    using namespace utils;
+
+    // the record `index` of a flat file: load it whole, then walk the records before it
+    size_t flat_lookup(const char *filename, const size_t &index) {
+        wmemory_t buffer(nullptr);
+        io::deserialize(&buffer, filename);
+        buffer.rewind();
+        for (size_t i = 0; i < index; ++i)
+            buffer.get_string_view();
+        return buffer.get_string_view().size();
+    }
+}
+
+// 100,000 records of ~1 KB: fetching random records from a flat io::serialize file against an archive
+int main(int argc, char *argv[]) {
+    const std::string base = argc > 1 ? argv[1] : "bench_archive";
+    const std::string flat = base + ".bin", archive = base + ".arc";
+    constexpr size_t count = 100000;
+
+    std::mt19937_64 random(42);
+    wmemory_t records(count * 0x420);
+    {
+        io::archive_writer_t writer(archive.c_str());
+        std::string record;
+        for (size_t i = 0; i < count; ++i) {
+            record.assign(0x300 + random() % 0x200, char('a' + i % 26));
+            records.setString(record);
+            writer.append(std::span<const uint8_t>(reinterpret_cast<const uint8_t *>(record.data()), record.size()));
+        }
+    }
+    io::serialize(&records, flat.c_str());
+
+    std::vector<size_t> lookups(1000);
+    for (size_t &index: lookups)
+        index = random() % count;
+
+    size_t next = 0;
+    const double scanned = bench::measure(20, [&] {
+        bench::do_not_optimize(flat_lookup(flat.c_str(), lookups[next++ % lookups.size()]));
+    });
+    bench::report("flat file: deserialize + walk to record", scanned / 1e3, "us/record");
+
+    const double opened = bench::measure(100, [&] {
+        io::archive_reader_t reader(archive.c_str());
+        bench::do_not_optimize(reader.size());
+    });
+    bench::report("archive: open", opened / 1e3, "us");
+
+    io::archive_reader_t reader(archive.c_str());
+    next = 0;
+    const double random_access = bench::measure(100000, [&] {
+        bench::do_not_optimize(reader.record(lookups[next++ % lookups.size()]).size());
+    });
+    bench::report("archive: random record", random_access, "ns/record");
+
+    std::remove(flat.c_str());
+    std::remove(archive.c_str());
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,53 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+
+// a request that allocates 64 small objects and then drops all of them
+int main() {
+    using namespace utils;
+    constexpr uint64_t requests = 100000;
+    constexpr int objects = 64;
+
+    const double heap = bench::measure(requests, [] {
+        void *blocks[objects];
+        for (int i = 0; i < objects; ++i)
+            blocks[i] = alloc_(16 + (i * 24) % 200);
+        for (void *block: blocks)
+            free_(block);
+        bench::do_not_optimize(blocks);
+    });
+    bench::report("alloc_ + free_ per object", heap, "ns/request");
+
+    heap_t local(0x100000);
+    const double instance = bench::measure(requests, [&] {
+        void *blocks[objects];
+        for (int i = 0; i < objects; ++i)
+            blocks[i] = local.alloc(16 + (i * 24) % 200);
+        for (void *block: blocks)
+            local.free(block);
+        bench::do_not_optimize(blocks);
+    });
+    bench::report("heap_t instance, alloc + free per object", instance, "ns/request");
+
+    arena_t arena(0x4000, mmap_resource());
+    const double bump = bench::measure(requests, [&] {
+        void *blocks[objects];
+        for (int i = 0; i < objects; ++i)
+            blocks[i] = arena.alloc(16 + (i * 24) % 200);
+        arena.reset();
+        bench::do_not_optimize(blocks);
+    });
+    bench::report("arena_t, bump + one reset", bump, "ns/request");
+
+    alignas(ALIGNMENT) static uint8_t storage[0x4000];
+    arena_t fixed(storage, sizeof(storage));
+    const double stack = bench::measure(requests, [&] {
+        void *blocks[objects];
+        for (int i = 0; i < objects; ++i)
+            blocks[i] = fixed.alloc(16 + (i * 24) % 200);
+        fixed.reset();
+        bench::do_not_optimize(blocks);
+    });
+    bench::report("arena_t over static storage", stack, "ns/request");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,66 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+#include <numeric>
+
+namespace {
+    using namespace utils;
+
+    template<class _typename, class _setter, class _getter>
+    void run(const char *type, _setter &&set, _getter &&get) {
+        constexpr size_t count = 1000000;
+        std::vector<_typename> values(count), decoded(count);
+        std::iota(values.begin(), values.end(), _typename(0));
+        const double bytes = double(count * sizeof(_typename));
+
+        for (const int encoding: {encoding_t::fixed, encoding_t::compact}) {
+            const char *name = encoding == encoding_t::fixed ? "fixed" : "compact";
+            wmemory_t buffer(count * (sizeof(_typename) + 2) + 0x10);
+            buffer.set_encoding(encoding);
+            char label[64];
+
+            const double loop_write = bench::measure(20, [&] {
+                buffer.rewind();
+                for (const _typename &value: values)
+                    set(buffer, value);
+                bench::do_not_optimize(buffer.data());
+            });
+            const double loop_read = bench::measure(20, [&] {
+                buffer.rewind();
+                for (_typename &value: decoded)
+                    value = get(buffer);
+                bench::do_not_optimize(decoded.data());
+            });
+            const double bulk_write = bench::measure(20, [&] {
+                buffer.rewind();
+                buffer.set_array(values);
+                bench::do_not_optimize(buffer.data());
+            });
+            const double bulk_read = bench::measure(20, [&] {
+                buffer.rewind();
+                buffer.get_array(decoded);
+                bench::do_not_optimize(decoded.data());
+            });
+
+            std::snprintf(label, sizeof(label), "%s %s per-element write", name, type);
+            bench::report(label, bytes / loop_write, "GB/s");
+            std::snprintf(label, sizeof(label), "%s %s set_array", name, type);
+            bench::report(label, bytes / bulk_write, "GB/s");
+            std::snprintf(label, sizeof(label), "%s %s per-element read", name, type);
+            bench::report(label, bytes / loop_read, "GB/s");
+            std::snprintf(label, sizeof(label), "%s %s get_array", name, type);
+            bench::report(label, bytes / bulk_read, "GB/s");
+        }
+    }
+}
+
+// 1M element arrays: setX/get_X loops against set_array/get_array, in GB/s of payload
+int main() {
+    run<int>("int", [](wmemory_t &buffer, const int &value) { buffer.setInt(value); },
+             [](wmemory_t &buffer) { return buffer.get_int(); });
+    run<float>("float", [](wmemory_t &buffer, const float &value) { buffer.setFloat(value); },
+               [](wmemory_t &buffer) { return buffer.get_float(); });
+    run<double>("double", [](wmemory_t &buffer, const double &value) { buffer.setDouble(value); },
+                [](wmemory_t &buffer) { return buffer.get_double(); });
+    return EXIT_SUCCESS;
+}
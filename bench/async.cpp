@@ -0,0 +1,82 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+
+namespace {
+    using namespace utils;
+
+    // every pass creates its files, as a fresh checkpoint would
+    void reset(const std::filesystem::path &directory) {
+        std::filesystem::remove_all(directory);
+        std::filesystem::create_directories(directory);
+    }
+
+    double elapsed_ms(const std::chrono::steady_clock::time_point &start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // checkpoints every buffer through `engine`, reports the time the caller was blocked and the total
+    void run(const char *name, io::async_t &engine, std::vector<wmemory_t> &buffers,
+             const std::vector<std::string> &names, const double &megabytes) {
+        std::atomic<size_t> pending{buffers.size()};
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < buffers.size(); ++i)
+            engine.serialize(&buffers[i], names[i].c_str(), [&pending](std::exception_ptr error) {
+                if (error)
+                    std::rethrow_exception(error);
+                pending.fetch_sub(1, std::memory_order_release);
+            });
+        const double submitted = elapsed_ms(start);
+        while (pending.load(std::memory_order_acquire) != 0x00)
+            std::this_thread::yield();
+        const double total = elapsed_ms(start);
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "%s caller blocked", name);
+        bench::report(label, submitted, "ms");
+        std::snprintf(label, sizeof(label), "%s all checkpoints done", name);
+        bench::report(label, total, "ms");
+        std::snprintf(label, sizeof(label), "%s throughput", name);
+        bench::report(label, megabytes / total * 1e3, "MB/s");
+    }
+}
+
+// 1,000 concurrent 64 KB checkpoints: blocking io::serialize against io_uring and the thread pool
+int main(int argc, char *argv[]) {
+    const std::filesystem::path directory = argc > 1 ? argv[1] : "bench_async";
+    constexpr size_t count = 1000;
+    constexpr uintmax_t size = 0x10000;
+
+    std::vector<wmemory_t> buffers;
+    std::vector<std::string> names;
+    buffers.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        buffers.emplace_back(size);
+        for (uintmax_t j = 0; j < size / sizeof(int); ++j)
+            buffers.back().setInt(static_cast<int>(i ^ j));
+        names.push_back((directory / ("checkpoint_" + std::to_string(i) + ".bin")).string());
+    }
+    const double megabytes = double(count * size) / 1e6;
+
+    reset(directory);
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i)
+        io::serialize(&buffers[i], names[i].c_str());
+    const double blocking = elapsed_ms(start);
+    bench::report("io::serialize caller blocked", blocking, "ms");
+    bench::report("io::serialize throughput", megabytes / blocking * 1e3, "MB/s");
+
+    reset(directory);
+    {
+        io::async_t engine(io::backend_t::uring);
+        run(engine.backend() == io::backend_t::uring ? "io_uring" : "io_uring (unavailable, threads)", engine,
+            buffers, names, megabytes);
+    }
+    reset(directory);
+    {
+        io::async_t engine(io::backend_t::threads);
+        run("thread pool", engine, buffers, names, megabytes);
+    }
+    std::filesystem::remove_all(directory);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,61 @@
+#ifndef SERIALIZER_BENCH_H
+#define SERIALIZER_BENCH_H
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cmath>
+
+#ifndef BENCH_NAME
+#define BENCH_NAME "bench" // set per executable by CMakeLists.txt
+#endif
+
+namespace bench {
+    // keep the compiler from optimizing away a value computed by the benchmark
+    template<class _typename>
+    inline void do_not_optimize(const _typename &value) {
+        asm volatile("" : : "r,m"(value) : "memory");
+    }
+
+    /**
+     * Runs `fn` `iterations` times and returns the mean time of one call in nanoseconds.
+     */
+    template<class _function>
+    double measure(const uint64_t &iterations, _function &&fn) {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint64_t i = 0; i < iterations; ++i)
+            fn();
+        const auto stop = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(stop - start).count() / double(iterations);
+    }
+
+    // writes `text` as a JSON string
+    inline void print_string(const char *text) {
+        std::putchar('"');
+        for (; *text != '\0'; ++text) {
+            if (*text == '"' || *text == '\\')
+                std::putchar('\\');
+            std::putchar(*text);
+        }
+        std::putchar('"');
+    }
+
+    /**
+     * Prints one result as a JSON object on its own line, `value` is expressed in `unit`.
+     *
+     * Every line holds `benchmark` (the executable, set by the build through `BENCH_NAME`),
+     * `name`, `value` and `unit`, so the output of all benchmarks can be concatenated and
+     * tracked over time.
+     */
+    inline void report(const char *name, const double &value, const char *unit) {
+        std::printf("{\"benchmark\": ");
+        print_string(BENCH_NAME);
+        std::printf(", \"name\": ");
+        print_string(name);
+        if (std::isfinite(value))
+            std::printf(", \"value\": %.3f, \"unit\": ", value);
+        else std::printf(", \"value\": null, \"unit\": ");
+        print_string(unit);
+        std::printf("}\n");
+    }
+}
+#endif //SERIALIZER_BENCH_H
@@ -0,0 +1,97 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+#include <random>
+
+namespace {
+    using namespace utils;
+
+    struct message_t {
+        uint64_t user;
+        long long timestamp_delta;
+        int score;
+        uint32_t count;
+        short status;
+        bool flag;
+        double price;
+        std::string name;
+        std::string tags[3];
+    };
+
+    void encode(wmemory_t &buffer, const message_t &message) {
+        buffer.setULong(message.user);
+        buffer.setLong(message.timestamp_delta);
+        buffer.setInt(message.score);
+        buffer.setUInt(message.count);
+        buffer.setShort(message.status);
+        buffer.setBool(message.flag);
+        buffer.setDouble(message.price);
+        buffer.setStringView(message.name);
+        for (const std::string &tag: message.tags)
+            buffer.setStringView(tag);
+    }
+
+    void decode(wmemory_t &buffer, message_t &message) {
+        message.user = buffer.get_uint64();
+        message.timestamp_delta = buffer.get_llong();
+        message.score = buffer.get_int();
+        message.count = buffer.get_uint();
+        message.status = buffer.get_short();
+        message.flag = buffer.get_bool();
+        message.price = buffer.get_double();
+        buffer.get_string_view();
+        for (int i = 0; i < 3; ++i)
+            buffer.get_string_view();
+    }
+}
+
+// fixed-width layout against encoding_t::compact on small, realistic values
+int main() {
+    constexpr size_t count = 10000;
+    std::mt19937_64 rng(3);
+    std::vector<message_t> messages(count);
+    for (message_t &message: messages) {
+        message.user = rng() % 5000000;
+        message.timestamp_delta = int64_t(rng() % 2000) - 1000;
+        message.score = int(rng() % 200) - 100;
+        message.count = rng() % 50;
+        message.status = short(rng() % 5);
+        message.flag = rng() & 1;
+        message.price = double(rng() % 100000) / 100.0;
+        message.name = "user_" + std::to_string(rng() % 100000);
+        message.tags[0] = "eu", message.tags[1] = "mobile", message.tags[2] = "v2";
+    }
+
+    for (const int encoding: {encoding_t::fixed, encoding_t::compact}) {
+        const char *name = encoding == encoding_t::fixed ? "fixed" : "compact";
+        wmemory_t buffer(count * 128, policy_t::growable);
+        buffer.set_encoding(encoding);
+        const double encode_ns = bench::measure(50, [&] {
+            buffer.rewind();
+            for (const message_t &message: messages)
+                encode(buffer, message);
+            bench::do_not_optimize(buffer.data());
+        }) / count;
+        const uintmax_t bytes = buffer.lens();
+        message_t decoded;
+        const double decode_ns = bench::measure(50, [&] {
+            buffer.rewind();
+            for (size_t i = 0; i < count; ++i)
+                decode(buffer, decoded);
+            bench::do_not_optimize(decoded);
+        }) / count;
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "%s bytes per message", name);
+        bench::report(label, double(bytes) / count, "B/msg");
+        std::snprintf(label, sizeof(label), "%s encode throughput", name);
+        bench::report(label, double(bytes) / count / encode_ns * 1e3, "MB/s");
+        std::snprintf(label, sizeof(label), "%s decode throughput", name);
+        bench::report(label, double(bytes) / count / decode_ns * 1e3, "MB/s");
+        std::snprintf(label, sizeof(label), "%s encode", name);
+        bench::report(label, encode_ns, "ns/msg");
+        std::snprintf(label, sizeof(label), "%s decode", name);
+        bench::report(label, decode_ns, "ns/msg");
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,74 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+#include <random>
+
+namespace {
+    using namespace utils;
+
+    // a snapshot as our services write it: repeated strings and small ints in 8-byte slots
+    void fill(wmemory_t &buffer, const uintmax_t &size) {
+        static const char *names[] = {"orders", "users", "sessions", "inventory", "payments"};
+        std::mt19937_64 random(7);
+        while (buffer.lens() + 0x40 < size) {
+            buffer.setString(names[random() % 5]);
+            buffer.setLong(static_cast<long long>(random() % 1000));
+            buffer.setLong(static_cast<long long>(random() % 100000));
+            buffer.setDouble(static_cast<double>(random() % 10000) / 100);
+        }
+    }
+}
+
+// 64 MB snapshot on tmpfs: raw io::serialize against serialize_compressed, plus the codec alone
+int main(int argc, char *argv[]) {
+    const std::string base = argc > 1 ? argv[1] : "bench_compress";
+    const std::string raw = base + ".bin", packed = base + ".lz";
+    constexpr uintmax_t size = 0x4000000;
+    const double megabytes = double(size) / 1e6;
+
+    wmemory_t snapshot(size);
+    fill(snapshot, size);
+
+    std::vector<uint8_t> block(lz::bound(0x10000)), out(0x10000);
+    uintmax_t compressed = 0x00;
+    const double encode = bench::measure(1, [&] {
+        compressed = 0x00;
+        for (uintmax_t offset = 0; offset < snapshot.lens(); offset += 0x10000)
+            compressed += lz::compress(snapshot.data() + offset, std::min<uintmax_t>(0x10000, snapshot.lens() - offset),
+                                       block.data());
+    });
+    bench::report("lz::compress 64 KB blocks", megabytes / encode * 1e9, "MB/s");
+    bench::report("lz ratio", double(snapshot.lens()) / double(compressed), "x");
+    const uintmax_t first = lz::compress(snapshot.data(), 0x10000, block.data());
+    const double decode = bench::measure(1000, [&] {
+        bench::do_not_optimize(lz::decompress(block.data(), first, out.data(), out.size()));
+    });
+    bench::report("lz::decompress 64 KB block", 0x10000 / decode * 1e3, "MB/s");
+
+    const double written_raw = bench::measure(5, [&] { io::serialize(&snapshot, raw.c_str()); });
+    const double written_packed = bench::measure(5, [&] { io::serialize_compressed(&snapshot, packed.c_str()); });
+    bench::report("io::serialize", megabytes / written_raw * 1e9, "MB/s");
+    bench::report("io::serialize_compressed", megabytes / written_packed * 1e9, "MB/s");
+    bench::report("file size ratio", double(std::filesystem::file_size(raw)) / double(std::filesystem::file_size(packed)), "x");
+
+    wmemory_t loaded(nullptr);
+    const double read_raw = bench::measure(5, [&] { io::deserialize(&loaded, raw.c_str()); });
+    const double read_single = bench::measure(5, [&] { io::deserialize_compressed(&loaded, packed.c_str(), 1); });
+    const double read_parallel = bench::measure(5, [&] { io::deserialize_compressed(&loaded, packed.c_str()); });
+    bench::report("io::deserialize", megabytes / read_raw * 1e9, "MB/s");
+    bench::report("io::deserialize_compressed, 1 thread", megabytes / read_single * 1e9, "MB/s");
+    bench::report("io::deserialize_compressed, all cores", megabytes / read_parallel * 1e9, "MB/s");
+
+    io::compressed_reader_t reader(packed.c_str());
+    std::mt19937_64 random(1);
+    uint8_t record[0x40];
+    const double lookup = bench::measure(10000, [&] {
+        reader.read(random() % (reader.size() - sizeof(record)), record);
+        bench::do_not_optimize(record[0]);
+    });
+    bench::report("compressed_reader_t 64-byte random read", lookup / 1e3, "us");
+
+    std::remove(raw.c_str());
+    std::remove(packed.c_str());
+    return EXIT_SUCCESS;
+}
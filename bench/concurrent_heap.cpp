@@ -0,0 +1,59 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+#include <thread>
+
+// alloc/free throughput across threads: the heap behind one mutex against concurrent::alloc_
+namespace {
+    constexpr size_t operations = 200000; // alloc/free pairs per thread
+    constexpr size_t live = 32; // blocks each thread keeps alive
+
+    template<class _alloc, class _free>
+    double run(const unsigned &threads, _alloc &&alloc, _free &&free) {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> workers;
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.emplace_back([&, t] {
+                void *slots[live] = {};
+                for (size_t i = 0; i < operations; ++i) {
+                    const size_t slot = (i * 7 + t) % live;
+                    free(slots[slot]);
+                    slots[slot] = alloc(16 + (i * 37) % 480);
+                }
+                for (void *slot: slots)
+                    free(slot);
+            });
+        }
+        for (std::thread &worker: workers)
+            worker.join();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return double(operations) * threads / seconds / 1e6;
+    }
+}
+
+int main() {
+    using namespace utils;
+    std::mutex mutex;
+    const unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= cores * 2 && threads <= 16; threads *= 2) {
+        char label[64];
+        const double locked = run(threads, [&](const size_t &size) {
+            std::lock_guard<std::mutex> lock(mutex);
+            return alloc_(size);
+        }, [&](void *ptr) {
+            std::lock_guard<std::mutex> lock(mutex);
+            free_(ptr);
+        });
+        std::snprintf(label, sizeof(label), "alloc_/free_ + mutex, %u threads", threads);
+        bench::report(label, locked, "Mops/s");
+
+        const double concurrent = run(threads, [](const size_t &size) {
+            return concurrent::alloc_(size);
+        }, [](void *ptr) {
+            concurrent::free_(ptr);
+        });
+        std::snprintf(label, sizeof(label), "concurrent::alloc_/free_, %u threads", threads);
+        bench::report(label, concurrent, "Mops/s");
+    }
+    return EXIT_SUCCESS;
+}
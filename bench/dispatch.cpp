@@ -0,0 +1,92 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+
+namespace {
+    using namespace utils;
+
+    // the runtime variant dispatch wmemory_t::insert used before, kept as the baseline
+    struct legacy_t {
+        std::vector<uint8_t> buffer;
+        uintmax_t m_size = 0x00, m_lens = 0x00;
+
+        explicit legacy_t(const uintmax_t &size) : buffer(size), m_size(size) {}
+
+        template<class _typename>
+        void insert(const _typename &value) {
+            const variant &var = value;
+            if (var.index() == std::variant_npos)
+                throw std::invalid_argument("invalid variant access");
+            else if (var.index() == support_t::variant_str) {
+                const std::string str = std::get<std::string>(var);
+                if (m_lens + str.size() > m_size)
+                    throw std::runtime_error("maximum buffer size exceeded");
+                const size_t lens = str.size();
+                std::memcpy(buffer.data() + m_lens, &lens, sizeof(size_t));
+                m_lens += sizeof(size_t);
+                std::memcpy(buffer.data() + m_lens, str.c_str(), lens);
+                m_lens += lens;
+            } else if (var.index() == support_t::variant_strview) {
+                const std::string_view str = std::get<std::string_view>(var);
+                if (m_lens + str.size() > m_size)
+                    throw std::runtime_error("maximum buffer size exceeded");
+                const size_t lens = str.size();
+                std::memcpy(buffer.data() + m_lens, &lens, sizeof(size_t));
+                m_lens += sizeof(size_t);
+                std::memcpy(buffer.data() + m_lens, str.data(), lens);
+                m_lens += lens;
+            } else {
+                if (m_lens + sizeof(_typename) > m_size)
+                    throw std::runtime_error("maxium buffer size exceeded");
+                const _typename object = std::get<_typename>(var);
+                std::memcpy(buffer.data() + m_lens, &object, sizeof(_typename));
+                m_lens += sizeof(_typename);
+            }
+        }
+    };
+
+    constexpr uint64_t iterations = 2000000;
+    constexpr uintmax_t capacity = 0x4000;
+
+    template<class _typename, class _setter>
+    void compare(const char *name, const _typename &value, _setter &&setter) {
+        legacy_t legacy(capacity);
+        const double before = bench::measure(iterations, [&] {
+            if (legacy.m_lens + sizeof(size_t) + 0x40 > capacity)
+                legacy.m_lens = 0x00;
+            legacy.insert(value);
+            bench::do_not_optimize(legacy.buffer.data());
+        });
+        wmemory_t buffer(capacity);
+        const double after = bench::measure(iterations, [&] {
+            if (!buffer.is_enough(sizeof(size_t) + 0x40))
+                buffer.resize(0x00), buffer.resize(capacity);
+            setter(buffer, value);
+            bench::do_not_optimize(buffer.data());
+        });
+        char label[64];
+        std::snprintf(label, sizeof(label), "%s variant dispatch", name);
+        bench::report(label, before, "ns/op");
+        std::snprintf(label, sizeof(label), "%s compile-time dispatch", name);
+        bench::report(label, after, "ns/op");
+    }
+}
+
+int main() {
+    compare("setBytes", char('a'), [](wmemory_t &b, const char &v) { b.setBytes(v); });
+    compare("setUBytes", uint8_t(0x7f), [](wmemory_t &b, const uint8_t &v) { b.setUBytes(v); });
+    compare("setShort", short(-3), [](wmemory_t &b, const short &v) { b.setShort(v); });
+    compare("setUShort", uint16_t(3), [](wmemory_t &b, const uint16_t &v) { b.setUShort(v); });
+    compare("setInt", int(-42), [](wmemory_t &b, const int &v) { b.setInt(v); });
+    compare("setUInt", uint32_t(42), [](wmemory_t &b, const uint32_t &v) { b.setUInt(v); });
+    compare("setLong", (long long) -1, [](wmemory_t &b, const long long &v) { b.setLong(v); });
+    compare("setULong", uint64_t(1), [](wmemory_t &b, const uint64_t &v) { b.setULong(v); });
+    compare("setBool", true, [](wmemory_t &b, const bool &v) { b.setBool(v); });
+    compare("setFloat", 1.5f, [](wmemory_t &b, const float &v) { b.setFloat(v); });
+    compare("setDouble", 2.5, [](wmemory_t &b, const double &v) { b.setDouble(v); });
+    compare("setString", std::string("a string well past the SSO size"),
+            [](wmemory_t &b, const std::string &v) { b.setString(v); });
+    compare("setStringView", std::string_view("a string well past the SSO size"),
+            [](wmemory_t &b, const std::string_view &v) { b.setStringView(v); });
+    return EXIT_SUCCESS;
+}
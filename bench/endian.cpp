@@ -0,0 +1,67 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+
+namespace {
+    using namespace utils;
+
+    void run(const char *name, const int &encoding) {
+        constexpr size_t count = 1000000;
+        std::vector<int> ints(count);
+        std::vector<double> doubles(count);
+        for (size_t i = 0; i < count; ++i)
+            ints[i] = int(i * 2654435761u), doubles[i] = double(i) * 0.5;
+        wmemory_t buffer(count * sizeof(double) + 0x10);
+        buffer.set_encoding(encoding);
+        char label[64];
+
+        const double int_write = bench::measure(20, [&] {
+            buffer.rewind();
+            for (const int &value: ints)
+                buffer.setInt(value);
+            bench::do_not_optimize(buffer.data());
+        }) / count;
+        int sum = 0;
+        const double int_read = bench::measure(20, [&] {
+            buffer.rewind();
+            for (size_t i = 0; i < count; ++i)
+                sum += buffer.get_int();
+            bench::do_not_optimize(sum);
+        }) / count;
+        const double double_write = bench::measure(20, [&] {
+            buffer.rewind();
+            for (const double &value: doubles)
+                buffer.setDouble(value);
+            bench::do_not_optimize(buffer.data());
+        }) / count;
+        const double array_write = bench::measure(20, [&] {
+            buffer.rewind();
+            buffer.set_array(doubles);
+            bench::do_not_optimize(buffer.data());
+        });
+        const double array_read = bench::measure(20, [&] {
+            buffer.rewind();
+            buffer.get_array(doubles);
+            bench::do_not_optimize(doubles.data());
+        });
+
+        std::snprintf(label, sizeof(label), "%s setInt", name);
+        bench::report(label, int_write, "ns/op");
+        std::snprintf(label, sizeof(label), "%s get_int", name);
+        bench::report(label, int_read, "ns/op");
+        std::snprintf(label, sizeof(label), "%s setDouble", name);
+        bench::report(label, double_write, "ns/op");
+        std::snprintf(label, sizeof(label), "%s set_array<double> 1M", name);
+        bench::report(label, double(count * sizeof(double)) / array_write, "GB/s");
+        std::snprintf(label, sizeof(label), "%s get_array<double> 1M", name);
+        bench::report(label, double(count * sizeof(double)) / array_read, "GB/s");
+    }
+}
+
+// host order against the explicit wire orders, the one matching the host must cost nothing
+int main() {
+    run("host", encoding_t::fixed);
+    run("little", encoding_t::little);
+    run("big", encoding_t::big);
+    return EXIT_SUCCESS;
+}
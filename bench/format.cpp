@@ -0,0 +1,49 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+
+// typical 5 and 10-argument log lines: utils::format against format_to into a stack buffer and a wmemory_t
+int main() {
+    constexpr uint64_t iterations = 1000000;
+    const std::string user = "alice";
+    int request = 0;
+
+    const double format5 = bench::measure(iterations, [&] {
+        bench::do_not_optimize(utils::format("[{}] user={} request={} latency={}ms status={}",
+                                             "INFO", user, ++request, 12.75, 200));
+    });
+    const double format10 = bench::measure(iterations, [&] {
+        bench::do_not_optimize(utils::format(
+            "[{}] {} user={} request={} latency={}ms status={} bytes={} cache={} shard={} retry={}",
+            "INFO", "GET /orders", user, ++request, 12.75, 200, 48213LL, true, 7u, 0));
+    });
+
+    char line[256];
+    const double stack5 = bench::measure(iterations, [&] {
+        bench::do_not_optimize(utils::format_to(line, "[{}] user={} request={} latency={}ms status={}",
+                                                "INFO", user, ++request, 12.75, 200));
+        bench::do_not_optimize(line[0]);
+    });
+    const double stack10 = bench::measure(iterations, [&] {
+        bench::do_not_optimize(utils::format_to(
+            line, "[{}] {} user={} request={} latency={}ms status={} bytes={} cache={} shard={} retry={}",
+            "INFO", "GET /orders", user, ++request, 12.75, 200, 48213LL, true, 7u, 0));
+        bench::do_not_optimize(line[0]);
+    });
+
+    utils::wmemory_t log(0x10000, utils::policy_t::growable);
+    const double buffer10 = bench::measure(iterations, [&] {
+        if (log.lens() > 0xF000)
+            log.rewind();
+        utils::format_to(&log, "[{}] {} user={} request={} latency={}ms status={} bytes={} cache={} shard={} retry={}\n",
+                         "INFO", "GET /orders", user, ++request, 12.75, 200, 48213LL, true, 7u, 0);
+        bench::do_not_optimize(log.lens());
+    });
+
+    bench::report("utils::format, 5 args", format5, "ns/call");
+    bench::report("utils::format, 10 args", format10, "ns/call");
+    bench::report("format_to stack buffer, 5 args", stack5, "ns/call");
+    bench::report("format_to stack buffer, 10 args", stack10, "ns/call");
+    bench::report("format_to wmemory_t, 10 args", buffer10, "ns/call");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,90 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+#include <random>
+
+namespace {
+    // group_digit as it was before the lookup-table rewrite, kept for comparison
+    template<typename IntegerType>
+    std::string legacy_group_digit(IntegerType number, char separator = ',') {
+        // Buffer to hold the resulting string
+        char buffer[50];
+        // Buffer to hold the temporary number
+        char temp[50];
+
+        // Handle potential negative number
+        bool is_negative = (number < 0);
+        if (is_negative) {
+            number = -number;
+        }
+
+        int idx = 0;
+        int len = 0;
+
+        // Convert number to string in reverse
+        do {
+            temp[len++] = '0' + number % 10;
+            number /= 10;
+        } while (number > 0);
+
+        // Now insert separators while copying temp to buffer in proper order
+        int group_count = 0;
+        for (int i = 0; i < len; ++i) {
+            if (group_count == 3) {
+                buffer[idx++] = separator;
+                group_count = 0;
+            }
+            buffer[idx++] = temp[len - 1 - i];
+            ++group_count;
+        }
+
+        // Add minus sign if the number was negative
+        if (is_negative) {
+            buffer[idx++] = '-';
+        }
+
+        // Reverse the buffer to get the final string
+        for (int i = 0; i < idx / 2; ++i) {
+            std::swap(buffer[i], buffer[idx - 1 - i]);
+        }
+
+        // Null-terminate the string
+        buffer[idx] = '\0';
+
+        return std::string(buffer);
+    }
+}
+
+// one million counters of mixed magnitudes: the old group_digit against the single-pass versions
+int main() {
+    constexpr size_t count = 1000000;
+    std::mt19937_64 random(11);
+    std::vector<int64_t> counters(count);
+    for (int64_t &counter: counters)
+        counter = static_cast<int64_t>(random() >> (random() % 60));
+
+    size_t next = 0;
+    const double legacy = bench::measure(count, [&] {
+        bench::do_not_optimize(legacy_group_digit(counters[next++ % count]));
+    });
+    next = 0;
+    const double string = bench::measure(count, [&] {
+        bench::do_not_optimize(utils::group_digit(counters[next++ % count]));
+    });
+    char out[32];
+    next = 0;
+    const double buffer = bench::measure(count, [&] {
+        bench::do_not_optimize(utils::group_digit(out, counters[next++ % count]));
+        bench::do_not_optimize(out[0]);
+    });
+    std::vector<char> text(count * 28);
+    const double batch = bench::measure(10, [&] {
+        bench::do_not_optimize(utils::group_digits(text, counters));
+    }) / count;
+
+    bench::report("group_digit, before", legacy, "ns/number");
+    bench::report("group_digit -> std::string", string, "ns/number");
+    bench::report("group_digit -> caller buffer", buffer, "ns/number");
+    bench::report("group_digits batch", batch, "ns/number");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,39 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+
+// compares the manual check-and-resize pattern from the README with policy_t::growable
+int main() {
+    using namespace utils;
+    constexpr uint64_t messages = 20000;
+    constexpr int fields = 64;
+
+    const double manual = bench::measure(messages, [] {
+        wmemory_t buffer(0x1);
+        for (int i = 0; i < fields; ++i) {
+            if (buffer.lens() + sizeof(int) > buffer.size())
+                buffer.resize(buffer.size() + sizeof(int));
+            buffer.setInt(i);
+        }
+        bench::do_not_optimize(buffer.data());
+    });
+    bench::report("manual resize, 64 x setInt", manual, "ns/msg");
+
+    const double growable = bench::measure(messages, [] {
+        wmemory_t buffer(0x1, policy_t::growable);
+        for (int i = 0; i < fields; ++i)
+            buffer.setInt(i);
+        bench::do_not_optimize(buffer.data());
+    });
+    bench::report("policy_t::growable, 64 x setInt", growable, "ns/msg");
+
+    const double hinted = bench::measure(messages, [] {
+        wmemory_t buffer(0x1, policy_t::growable);
+        buffer.reserve(fields * sizeof(int));
+        for (int i = 0; i < fields; ++i)
+            buffer.setInt(i);
+        bench::do_not_optimize(buffer.data());
+    });
+    bench::report("policy_t::growable + reserve, 64 x setInt", hinted, "ns/msg");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,116 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+#include <random>
+
+namespace {
+    using namespace utils;
+
+    // the first-fit heap alloc_ used before, kept as the baseline
+    struct first_fit_t {
+        alignas(ALIGNMENT) uint8_t memory[HEAP_SIZE];
+        BlockHeader *head = reinterpret_cast<BlockHeader *>(memory);
+
+        first_fit_t() {
+            head->size = HEAP_SIZE - sizeof(BlockHeader);
+            head->is_free = true;
+            head->next = nullptr;
+        }
+
+        void *alloc(size_t size) {
+            size = align(size);
+            for (BlockHeader *current = head; current != nullptr; current = current->next) {
+                if (current->is_free && current->size >= size) {
+                    if (current->size >= size + sizeof(BlockHeader) + ALIGNMENT) {
+                        BlockHeader *block = reinterpret_cast<BlockHeader *>(
+                            reinterpret_cast<uint8_t *>(current) + sizeof(BlockHeader) + size);
+                        block->size = current->size - size - sizeof(BlockHeader);
+                        block->is_free = true;
+                        block->next = current->next;
+                        current->size = size;
+                        current->next = block;
+                    }
+                    current->is_free = false;
+                    return reinterpret_cast<uint8_t *>(current) + sizeof(BlockHeader);
+                }
+            }
+            return nullptr;
+        }
+
+        void free(void *ptr) {
+            if (ptr == nullptr)
+                return;
+            BlockHeader *block = reinterpret_cast<BlockHeader *>(static_cast<uint8_t *>(ptr) - sizeof(BlockHeader));
+            block->is_free = true;
+            for (BlockHeader *current = head; current != nullptr;) {
+                BlockHeader *next = current->next;
+                if (current->is_free && next != nullptr && next->is_free) {
+                    current->size += next->size + sizeof(BlockHeader);
+                    current->next = next->next;
+                } else current = next;
+            }
+        }
+    };
+
+    // largest free block over total free bytes, 1.0 means no fragmentation
+    double contiguity(BlockHeader *head) {
+        size_t largest = 0, total = 0;
+        for (BlockHeader *block = head; block != nullptr; block = block->next) {
+            if (block->is_free) {
+                largest = std::max(largest, block->size);
+                total += block->size;
+            }
+        }
+        return total == 0 ? 1.0 : double(largest) / double(total);
+    }
+
+    // random mixed-size churn keeping the heap about 60 % full
+    template<class _alloc, class _free>
+    void churn(const char *name, BlockHeader *head, _alloc &&alloc, _free &&free) {
+        std::mt19937 rng(42);
+        std::vector<void *> live;
+        std::vector<double> latency;
+        size_t failed = 0, used = 0;
+        std::vector<size_t> sizes;
+        for (int i = 0; i < 200000; ++i) {
+            if (used < HEAP_SIZE * 6 / 10 || live.empty()) {
+                const size_t size = rng() % 4 == 0 ? 256 + rng() % 4096 : 8 + rng() % 120;
+                const auto start = std::chrono::steady_clock::now();
+                void *ptr = alloc(size);
+                latency.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+                if (ptr == nullptr) {
+                    ++failed;
+                    continue;
+                }
+                live.push_back(ptr), sizes.push_back(size), used += size;
+            } else {
+                const size_t index = rng() % live.size();
+                free(live[index]);
+                used -= sizes[index];
+                live[index] = live.back(), live.pop_back();
+                sizes[index] = sizes.back(), sizes.pop_back();
+            }
+        }
+        std::sort(latency.begin(), latency.end());
+        char label[96];
+        std::snprintf(label, sizeof(label), "%s alloc p50", name);
+        bench::report(label, latency[latency.size() / 2], "ns");
+        std::snprintf(label, sizeof(label), "%s alloc p99", name);
+        bench::report(label, latency[latency.size() * 99 / 100], "ns");
+        std::snprintf(label, sizeof(label), "%s failed allocations", name);
+        bench::report(label, double(failed), "count");
+        std::snprintf(label, sizeof(label), "%s largest free / total free", name);
+        bench::report(label, contiguity(head), "ratio");
+        for (void *ptr: live)
+            free(ptr);
+    }
+}
+
+int main() {
+    static first_fit_t first_fit;
+    churn("first fit", first_fit.head, [](const size_t &size) { return first_fit.alloc(size); },
+          [](void *ptr) { first_fit.free(ptr); });
+    churn("segregated fit", free_list, [](const size_t &size) { return alloc_(size); },
+          [](void *ptr) { free_(ptr); });
+    return EXIT_SUCCESS;
+}
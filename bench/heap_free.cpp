@@ -0,0 +1,34 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+#include <random>
+
+// free_ latency with many live blocks, constant time thanks to the boundary tags
+int main() {
+    using namespace utils;
+    for (const size_t blocks: {1000, 10000}) {
+        std::mt19937 rng(7);
+        std::vector<void *> live;
+        for (size_t i = 0; i < blocks; ++i)
+            live.push_back(alloc_(16 + rng() % 32));
+
+        std::vector<double> latency;
+        for (int i = 0; i < 100000; ++i) {
+            const size_t index = rng() % live.size();
+            const auto start = std::chrono::steady_clock::now();
+            free_(live[index]);
+            latency.push_back(std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+            live[index] = alloc_(16 + rng() % 32);
+        }
+        std::sort(latency.begin(), latency.end());
+
+        char label[64];
+        std::snprintf(label, sizeof(label), "free_ p50, %zu live blocks", blocks);
+        bench::report(label, latency[latency.size() / 2], "ns");
+        std::snprintf(label, sizeof(label), "free_ p99, %zu live blocks", blocks);
+        bench::report(label, latency[latency.size() * 99 / 100], "ns");
+        for (void *ptr: live)
+            free_(ptr);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,54 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+
+// io::deserialize (one copy into the buffer) against io::map (no copy, lazy page-in)
+int main(int argc, char *argv[]) {
+    using namespace utils;
+    const char *filename = argc > 1 ? argv[1] : "bench_mapped.bin";
+    constexpr uintmax_t count = 0x1000000; // 64 MB of ints
+
+    wmemory_t source(count * sizeof(int));
+    for (uintmax_t i = 0; i < count; ++i)
+        source.setInt(static_cast<int>(i));
+    io::serialize(&source, filename);
+    source.cleanup();
+
+    const auto scan = [](wmemory_t &buffer) {
+        int64_t sum = 0;
+        for (uintmax_t i = 0; i < count; ++i)
+            sum += buffer.get_int();
+        bench::do_not_optimize(sum);
+    };
+
+    const double copied = bench::measure(8, [&] {
+        wmemory_t buffer(nullptr);
+        io::deserialize(&buffer, filename);
+        scan(buffer);
+    });
+    bench::report("io::deserialize + scan 64 MB", copied / 1e6, "ms");
+
+    const double mapped = bench::measure(8, [&] {
+        wmemory_t buffer(nullptr);
+        io::map(&buffer, filename);
+        scan(buffer);
+    });
+    bench::report("io::map + scan 64 MB", mapped / 1e6, "ms");
+
+    const double sequential = bench::measure(8, [&] {
+        wmemory_t buffer(nullptr);
+        io::map(&buffer, filename, io::advice_t::sequential);
+        scan(buffer);
+    });
+    bench::report("io::map(sequential) + scan 64 MB", sequential / 1e6, "ms");
+
+    const double open_only = bench::measure(64, [&] {
+        wmemory_t buffer(nullptr);
+        io::map(&buffer, filename);
+        bench::do_not_optimize(buffer.data());
+    });
+    bench::report("io::map without touching pages", open_only / 1e3, "us");
+
+    std::remove(filename);
+    return EXIT_SUCCESS;
+}
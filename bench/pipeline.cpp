@@ -0,0 +1,73 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+#include <deque>
+
+namespace {
+    constexpr size_t stages = 8;
+    constexpr uintmax_t message = 0x100000; // 1 MB
+
+    uint64_t allocations = 0x00;
+
+    // std::allocator counting the buffers it hands out, each one past the first is a copy
+    template<class _typename>
+    struct counting_allocator : std::allocator<_typename> {
+        template<class _other>
+        struct rebind {
+            using other = counting_allocator<_other>;
+        };
+
+        counting_allocator() = default;
+
+        template<class _other>
+        counting_allocator(const counting_allocator<_other> &) noexcept {
+        }
+
+        _typename *allocate(const size_t &count) {
+            ++allocations;
+            return std::allocator<_typename>::allocate(count);
+        }
+    };
+
+    using buffer_t = utils::basic_wmemory_t<counting_allocator<uint8_t> >;
+
+    // a producer/consumer pipeline: every stage pops a buffer from its queue, stamps it and pushes it to the next
+    template<bool _move>
+    void run(std::deque<buffer_t> (&queues)[stages + 1]) {
+        for (size_t stage = 0; stage < stages; ++stage) {
+            if constexpr (_move) {
+                buffer_t buffer = std::move(queues[stage].front());
+                queues[stage].pop_front();
+                buffer.data()[stage] = static_cast<uint8_t>(stage);
+                queues[stage + 1].push_back(std::move(buffer));
+            } else {
+                buffer_t buffer = queues[stage].front();
+                queues[stage].pop_front();
+                buffer.data()[stage] = static_cast<uint8_t>(stage);
+                queues[stage + 1].push_back(buffer);
+            }
+        }
+        queues[0].push_back(std::move(queues[stages].front()));
+        queues[stages].pop_front();
+    }
+}
+
+// a 1 MB buffer through 8 stages, copied (the behaviour before move support) and moved
+int main() {
+    constexpr uint64_t copies = 200, moves = 200000;
+    std::deque<buffer_t> queues[stages + 1];
+    queues[0].emplace_back(message);
+
+    allocations = 0x00;
+    const double copied = bench::measure(copies, [&] { run<false>(queues); });
+    const uint64_t copy_allocations = allocations;
+    allocations = 0x00;
+    const double moved = bench::measure(moves, [&] { run<true>(queues); });
+    const uint64_t move_allocations = allocations;
+
+    bench::report("8 stages, copy", copied / 1000.0, "us/message");
+    bench::report("8 stages, move", moved / 1000.0, "us/message");
+    bench::report("buffer allocations, copy", double(copy_allocations) / double(copies), "per message");
+    bench::report("buffer allocations, move", double(move_allocations) / double(moves), "per message");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,47 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+
+// new/fill/delete per message, as in the README, against buffers recycled by buffer_pool_t
+int main() {
+    using namespace utils;
+    constexpr uint64_t messages = 500000;
+    constexpr uintmax_t capacity = 0x400;
+
+    const auto fill = [](wmemory_t &buffer) {
+        for (int i = 0; i < 32; ++i) {
+            buffer.setInt(i);
+            buffer.setStringView("pooled");
+        }
+        bench::do_not_optimize(buffer.data());
+    };
+
+    const double fresh = bench::measure(messages, [&] {
+        wmemory_t *buffer = new wmemory_t(capacity);
+        fill(*buffer);
+        delete buffer;
+    });
+    bench::report("new wmemory_t per message", fresh, "ns/msg");
+
+    buffer_pool_t &pool = buffer_pool_t::local(capacity);
+    const double pooled = bench::measure(messages, [&] {
+        buffer_pool_t::handle_t buffer = pool.acquire();
+        fill(*buffer);
+    });
+    bench::report("buffer_pool_t::acquire per message", pooled, "ns/msg");
+    bench::report("buffer_pool_t hits", double(pool.hits()), "count");
+    bench::report("buffer_pool_t misses", double(pool.misses()), "count");
+
+    // buffers filled here and released by a consumer thread
+    std::vector<buffer_pool_t::handle_t> batch;
+    const double remote = bench::measure(messages / 256, [&] {
+        for (int i = 0; i < 256; ++i) {
+            batch.push_back(pool.acquire());
+            fill(*batch.back());
+        }
+        std::thread consumer([&] { batch.clear(); });
+        consumer.join();
+    }) / 256;
+    bench::report("acquire + cross-thread return", remote, "ns/msg");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,87 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+
+namespace {
+    using namespace utils;
+
+    struct order_t {
+        uint64_t id;
+        long long timestamp;
+        double price;
+        double quantity;
+        int side;
+        uint32_t flags;
+        std::string symbol;
+    };
+}
+
+template<>
+struct utils::schema_t<order_t> {
+    static constexpr auto fields = std::make_tuple(&order_t::id, &order_t::timestamp, &order_t::price,
+                                                   &order_t::quantity, &order_t::side, &order_t::flags,
+                                                   &order_t::symbol);
+};
+
+namespace {
+    void encode(wmemory_t &buffer, const order_t &order) {
+        buffer.setULong(order.id);
+        buffer.setLong(order.timestamp);
+        buffer.setDouble(order.price);
+        buffer.setDouble(order.quantity);
+        buffer.setInt(order.side);
+        buffer.setUInt(order.flags);
+        buffer.setStringView(order.symbol);
+    }
+
+    void decode(wmemory_t &buffer, order_t &order) {
+        order.id = buffer.get_uint64();
+        order.timestamp = buffer.get_llong();
+        order.price = buffer.get_double();
+        order.quantity = buffer.get_double();
+        order.side = buffer.get_int();
+        order.flags = buffer.get_uint();
+        order.symbol = buffer.get_string_view();
+    }
+}
+
+// hand-written setX / get_X sequences against the fused set_struct / get_struct
+int main() {
+    constexpr size_t count = 100000;
+    std::vector<order_t> orders(count);
+    for (size_t i = 0; i < count; ++i)
+        orders[i] = {i, (long long) i * 1000, 100.25 + i, 3.0, int(i & 1), uint32_t(i), "EURUSD"};
+    wmemory_t buffer(count * 96);
+    order_t decoded;
+
+    const double manual_encode = bench::measure(50, [&] {
+        buffer.rewind();
+        for (const order_t &order: orders)
+            encode(buffer, order);
+        bench::do_not_optimize(buffer.data());
+    }) / count;
+    const double manual_decode = bench::measure(50, [&] {
+        buffer.rewind();
+        for (size_t i = 0; i < count; ++i)
+            decode(buffer, decoded);
+        bench::do_not_optimize(decoded);
+    }) / count;
+    const double schema_encode = bench::measure(50, [&] {
+        buffer.rewind();
+        for (const order_t &order: orders)
+            buffer.set_struct(order);
+        bench::do_not_optimize(buffer.data());
+    }) / count;
+    const double schema_decode = bench::measure(50, [&] {
+        buffer.rewind();
+        for (size_t i = 0; i < count; ++i)
+            buffer.get_struct(decoded);
+        bench::do_not_optimize(decoded);
+    }) / count;
+
+    bench::report("setX sequence encode", manual_encode, "ns/msg");
+    bench::report("set_struct encode", schema_encode, "ns/msg");
+    bench::report("get_X sequence decode", manual_decode, "ns/msg");
+    bench::report("get_struct decode", schema_decode, "ns/msg");
+    return EXIT_SUCCESS;
+}
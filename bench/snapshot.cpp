@@ -0,0 +1,70 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+
+namespace {
+    using namespace utils;
+
+    double elapsed_ms(const std::chrono::steady_clock::time_point &start) {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    // commits the snapshots `group` at a time, one round of syncs per group
+    double grouped(std::vector<wmemory_t> &buffers, const std::vector<std::string> &names, const size_t &group) {
+        const auto start = std::chrono::steady_clock::now();
+        for (size_t first = 0; first < buffers.size(); first += group) {
+            std::vector<std::unique_ptr<io::snapshot_t> > snapshots;
+            std::vector<io::snapshot_t *> pointers;
+            for (size_t i = first; i < std::min(first + group, buffers.size()); ++i) {
+                snapshots.push_back(std::make_unique<io::snapshot_t>(names[i].c_str()));
+                snapshots.back()->write(&buffers[i]);
+                pointers.push_back(snapshots.back().get());
+            }
+            io::commit(std::span<io::snapshot_t *const>(pointers));
+        }
+        return elapsed_ms(start);
+    }
+}
+
+// 200 snapshots of 64 KB: io::serialize (not durable) against one commit per file and group commits
+// run it on the disk the snapshots live on, tmpfs makes every sync free
+int main(int argc, char *argv[]) {
+    const std::filesystem::path directory = argc > 1 ? argv[1] : "bench_snapshot";
+    constexpr size_t count = 200;
+    constexpr uintmax_t size = 0x10000;
+    std::filesystem::create_directories(directory);
+
+    std::vector<wmemory_t> buffers;
+    std::vector<std::string> names;
+    buffers.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        buffers.emplace_back(size);
+        for (uintmax_t j = 0; j < size / sizeof(int); ++j)
+            buffers.back().setInt(static_cast<int>(i ^ j));
+        names.push_back((directory / ("snapshot_" + std::to_string(i) + ".bin")).string());
+    }
+    const double megabytes = double(count * size) / 1e6;
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i)
+        io::serialize(&buffers[i], names[i].c_str());
+    double total = elapsed_ms(start);
+    bench::report("io::serialize, not durable", megabytes / total * 1e3, "MB/s");
+
+    start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < count; ++i) {
+        io::snapshot_t snapshot(names[i].c_str());
+        snapshot.write(&buffers[i]);
+        snapshot.commit();
+    }
+    total = elapsed_ms(start);
+    bench::report("snapshot_t::commit per file", megabytes / total * 1e3, "MB/s");
+
+    for (const size_t group: {size_t(10), size_t(50), count}) {
+        char label[64];
+        std::snprintf(label, sizeof(label), "io::commit groups of %zu", group);
+        bench::report(label, megabytes / grouped(buffers, names, group) * 1e3, "MB/s");
+    }
+    std::filesystem::remove_all(directory);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,49 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+#include <string>
+
+// hot paths built twice by CMakeLists.txt, bench_stats with __SERIALIZER_STATS__ and bench_stats_off without
+int main() {
+    constexpr uint64_t iterations = 10000000;
+    const std::string suffix = utils::stats::enabled ? ", stats on" : ", stats off";
+
+    utils::wmemory_t buffer(0x10000);
+    const double set_int = bench::measure(iterations, [&] {
+        if (!buffer.is_enough(sizeof(int)))
+            buffer.rewind();
+        buffer.setInt(0x12345678);
+    });
+    buffer.rewind();
+    const double get_int = bench::measure(iterations, [&] {
+        if (!buffer.is_enough(sizeof(int)))
+            buffer.rewind();
+        bench::do_not_optimize(buffer.get_int());
+    });
+
+    constexpr uint64_t appends = 100000;
+    const double growable = bench::measure(100, [&] {
+        utils::wmemory_t log(0x40, utils::policy_t::growable);
+        for (uint64_t i = 0; i < appends; ++i)
+            log.setLong(static_cast<long long>(i));
+        bench::do_not_optimize(log.lens());
+    }) / double(appends);
+
+    utils::wmemory_t file(0x1000);
+    file.skip(0x1000);
+    const double serialize = bench::measure(2000, [&] {
+        utils::io::serialize(&file, "/tmp/serializer_stats.bin");
+    });
+    std::remove("/tmp/serializer_stats.bin");
+
+    const double snapshot = bench::measure(1000, [] {
+        bench::do_not_optimize(utils::stats::snapshot().size());
+    });
+
+    bench::report(("setInt" + suffix).c_str(), set_int, "ns/value");
+    bench::report(("get_int" + suffix).c_str(), get_int, "ns/value");
+    bench::report(("growable setLong" + suffix).c_str(), growable, "ns/value");
+    bench::report(("serialize 4 KB" + suffix).c_str(), serialize, "ns/file");
+    bench::report(("snapshot" + suffix).c_str(), snapshot, "ns/call");
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,38 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+
+// building the whole payload then io::serialize, against io::stream_writer_t / io::stream_reader_t
+int main(int argc, char *argv[]) {
+    using namespace utils;
+    const char *filename = argc > 1 ? argv[1] : "bench_stream.bin";
+    constexpr uintmax_t count = 0x1000000; // 16M ints, 64 MB
+    constexpr double megabytes = count * sizeof(int) / 1048576.0;
+
+    const double in_memory = bench::measure(4, [&] {
+        wmemory_t buffer(count * sizeof(int));
+        for (uintmax_t i = 0; i < count; ++i)
+            buffer.setInt(static_cast<int>(i));
+        io::serialize(&buffer, filename);
+    });
+    bench::report("wmemory_t + io::serialize (64 MB resident)", megabytes / (in_memory / 1e9), "MB/s");
+
+    const double streamed = bench::measure(4, [&] {
+        io::stream_writer_t writer(filename);
+        for (uintmax_t i = 0; i < count; ++i)
+            writer.setInt(static_cast<int>(i));
+    });
+    bench::report("io::stream_writer_t (64 KB resident)", megabytes / (streamed / 1e9), "MB/s");
+
+    const double read = bench::measure(4, [&] {
+        io::stream_reader_t reader(filename);
+        int64_t sum = 0;
+        for (uintmax_t i = 0; i < count; ++i)
+            sum += reader.get_int();
+        bench::do_not_optimize(sum);
+    });
+    bench::report("io::stream_reader_t (64 KB resident)", megabytes / (read / 1e9), "MB/s");
+
+    std::remove(filename);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,165 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+#include <random>
+
+namespace {
+    using namespace utils;
+
+    constexpr uint64_t values = 0x100000;
+
+    // writes then reads back `values` values of one type, reports ns per value each way
+    template<class _typename, class _set, class _get>
+    void scalar(const char *setter, const char *getter, _set &&set, _get &&get) {
+        wmemory_t buffer(values * sizeof(_typename));
+        uint64_t next = 0;
+        const double write = bench::measure(values, [&] { set(buffer, static_cast<_typename>(next++)); });
+        buffer.rewind();
+        const double read = bench::measure(values, [&] { bench::do_not_optimize(get(buffer)); });
+        bench::report(setter, write, "ns/value");
+        bench::report(getter, read, "ns/value");
+    }
+
+    void scalars() {
+        scalar<char>("setBytes", "get_bytes", [](wmemory_t &b, char v) { b.setBytes(v); },
+                     [](wmemory_t &b) { return b.get_bytes(); });
+        scalar<short>("setShort", "get_short", [](wmemory_t &b, short v) { b.setShort(v); },
+                      [](wmemory_t &b) { return b.get_short(); });
+        scalar<int>("setInt", "get_int", [](wmemory_t &b, int v) { b.setInt(v); },
+                    [](wmemory_t &b) { return b.get_int(); });
+        scalar<long long>("setLong", "get_long", [](wmemory_t &b, long long v) { b.setLong(v); },
+                          [](wmemory_t &b) { return b.get_long(); });
+        scalar<float>("setFloat", "get_float", [](wmemory_t &b, float v) { b.setFloat(v); },
+                      [](wmemory_t &b) { return b.get_float(); });
+        scalar<double>("setDouble", "get_double", [](wmemory_t &b, double v) { b.setDouble(v); },
+                       [](wmemory_t &b) { return b.get_double(); });
+        scalar<uint8_t>("setUBytes", "get_bytes as uint8_t", [](wmemory_t &b, uint8_t v) { b.setUBytes(v); },
+                        [](wmemory_t &b) { return static_cast<uint8_t>(b.get_bytes()); });
+        scalar<uint16_t>("setUShort", "get_ushort", [](wmemory_t &b, uint16_t v) { b.setUShort(v); },
+                         [](wmemory_t &b) { return b.get_ushort(); });
+        scalar<uint32_t>("setUInt", "get_uint", [](wmemory_t &b, uint32_t v) { b.setUInt(v); },
+                         [](wmemory_t &b) { return b.get_uint(); });
+        scalar<uint64_t>("setULong", "get_uint64", [](wmemory_t &b, uint64_t v) { b.setULong(v); },
+                         [](wmemory_t &b) { return b.get_uint64(); });
+        scalar<bool>("setBool", "get_bool", [](wmemory_t &b, bool v) { b.setBool(v); },
+                     [](wmemory_t &b) { return b.get_bool(); });
+    }
+
+    // setString then get_string / get_string_view on strings of a few typical sizes
+    void strings() {
+        for (const size_t size: {size_t(8), size_t(64), size_t(1024)}) {
+            const std::string value(size, 's');
+            constexpr uint64_t count = 0x10000;
+            wmemory_t buffer(count * (size + sizeof(uint64_t)));
+            const double write = bench::measure(count, [&] { buffer.setString(value); });
+            buffer.rewind();
+            const double copy = bench::measure(count, [&] { bench::do_not_optimize(buffer.get_string()); });
+            buffer.rewind();
+            const double view = bench::measure(count, [&] { bench::do_not_optimize(buffer.get_string_view()); });
+            char label[64];
+            std::snprintf(label, sizeof(label), "setString %zu B", size);
+            bench::report(label, write, "ns/string");
+            std::snprintf(label, sizeof(label), "get_string %zu B", size);
+            bench::report(label, copy, "ns/string");
+            std::snprintf(label, sizeof(label), "get_string_view %zu B", size);
+            bench::report(label, view, "ns/string");
+        }
+    }
+
+    // io::serialize / io::deserialize of files from 4 KB to 64 MB
+    void files(const std::filesystem::path &directory) {
+        const std::string filename = (directory / "bench_suite.bin").string();
+        for (const uintmax_t size: {uintmax_t(0x1000), uintmax_t(0x100000), uintmax_t(0x4000000)}) {
+            wmemory_t buffer(size);
+            std::memset(buffer.data(), 0x5A, size);
+            buffer.skip(size);
+            const uint64_t iterations = std::clamp<uint64_t>(0x10000000 / size, 5, 1000);
+            const double written = bench::measure(iterations, [&] { io::serialize(&buffer, filename.c_str()); });
+            wmemory_t loaded(nullptr);
+            const double read = bench::measure(iterations, [&] { io::deserialize(&loaded, filename.c_str()); });
+            char label[64];
+            std::snprintf(label, sizeof(label), "io::serialize %ju KB", size >> 10);
+            bench::report(label, double(size) / written * 1e3, "MB/s");
+            std::snprintf(label, sizeof(label), "io::deserialize %ju KB", size >> 10);
+            bench::report(label, double(size) / read * 1e3, "MB/s");
+        }
+        std::remove(filename.c_str());
+    }
+
+    void text() {
+        constexpr uint64_t iterations = 200000;
+        const std::string user = "alice";
+        int request = 0;
+        bench::report("utils::format 5 args", bench::measure(iterations, [&] {
+            bench::do_not_optimize(format("[{}] user={} request={} latency={}ms status={}", "INFO", user, ++request,
+                                          12.75, 200));
+        }), "ns/call");
+        char line[128];
+        bench::report("utils::format_to 5 args", bench::measure(iterations, [&] {
+            bench::do_not_optimize(format_to(line, "[{}] user={} request={} latency={}ms status={}", "INFO", user,
+                                             ++request, 12.75, 200));
+        }), "ns/call");
+
+        std::mt19937_64 random(3);
+        std::vector<int64_t> counters(0x10000);
+        for (int64_t &counter: counters)
+            counter = static_cast<int64_t>(random() >> (random() % 60));
+        size_t next = 0;
+        bench::report("group_digit", bench::measure(iterations, [&] {
+            bench::do_not_optimize(group_digit(counters[next++ % counters.size()]));
+        }), "ns/call");
+        next = 0;
+        bench::report("group_digit into buffer", bench::measure(iterations, [&] {
+            bench::do_not_optimize(group_digit(line, counters[next++ % counters.size()]));
+        }), "ns/call");
+    }
+
+    // alloc_ / free_ of mixed sizes on a heap left fragmented by freeing every other block
+    void fragmented_heap() {
+        std::mt19937 random(42);
+        const auto size = [&] { return random() % 4 == 0 ? 256 + random() % 4096 : 8 + random() % 120; };
+        std::vector<void *> kept;
+        for (size_t used = 0; used < HEAP_SIZE * 6 / 10;) {
+            const size_t bytes = size();
+            if (void *ptr = alloc_(bytes))
+                kept.push_back(ptr), used += bytes;
+            else break;
+        }
+        for (size_t i = 0; i < kept.size(); i += 2)
+            free_(kept[i]);
+
+        constexpr size_t rounds = 200, burst = 200;
+        std::vector<void *> live(burst);
+        double allocating = 0.0, freeing = 0.0;
+        size_t failed = 0;
+        for (size_t round = 0; round < rounds; ++round) {
+            std::vector<size_t> sizes(burst);
+            for (size_t &bytes: sizes)
+                bytes = size();
+            size_t index = 0;
+            allocating += bench::measure(burst, [&] { live[index] = alloc_(sizes[index]), ++index; });
+            index = 0;
+            freeing += bench::measure(burst, [&] { free_(live[index++]); });
+            failed += std::count(live.begin(), live.end(), nullptr);
+        }
+        bench::report("alloc_ fragmented heap", allocating / rounds, "ns/call");
+        bench::report("free_ fragmented heap", freeing / rounds, "ns/call");
+        bench::report("alloc_ fragmented heap failures", double(failed) / double(rounds * burst), "ratio");
+        for (size_t i = 1; i < kept.size(); i += 2)
+            free_(kept[i]);
+    }
+}
+
+// the paths services depend on, one JSON line per result: run it after every change and keep the output
+// the optional argument is the directory of the io files, tmpfs by default to leave the disk out
+int main(int argc, char *argv[]) {
+    std::filesystem::path directory = argc > 1 ? argv[1] : "/dev/shm";
+    if (!std::filesystem::is_directory(directory))
+        directory = std::filesystem::temp_directory_path();
+    scalars();
+    strings();
+    files(directory);
+    text();
+    fragmented_heap();
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,60 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+
+namespace {
+    using namespace utils;
+
+    void run(const char *filename, const size_t &count, const uintmax_t &payload) {
+        wmemory_t header(0x40);
+        header.setULong(count);
+        header.setULong(payload);
+        std::vector<wmemory_t> payloads;
+        payloads.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            payloads.emplace_back(payload);
+            for (uintmax_t j = 0; j < payload / sizeof(int); ++j)
+                payloads.back().setInt(static_cast<int>(i + j));
+        }
+        const double megabytes = double(header.lens() + count * payload) / 1e6;
+        char label[64];
+
+        const double concatenated = bench::measure(30, [&] {
+            wmemory_t file(header.lens() + count * payload);
+            std::memcpy(file.data(), header.data(), header.lens());
+            file.skip(header.lens());
+            for (wmemory_t &buffer: payloads) {
+                std::memcpy(file.data() + file.lens(), buffer.data(), buffer.lens());
+                file.skip(buffer.lens());
+            }
+            io::serialize(&file, filename);
+        });
+
+        std::vector<std::span<const uint8_t> > parts{{header.data(), header.lens()}};
+        for (wmemory_t &buffer: payloads)
+            parts.emplace_back(buffer.data(), buffer.lens());
+        const double buffered = bench::measure(30, [&] {
+            io::serialize(std::span<const std::span<const uint8_t> >(parts), filename);
+        });
+        const double direct = bench::measure(30, [&] {
+            io::serialize(std::span<const std::span<const uint8_t> >(parts), filename, io::output_t::direct);
+        });
+
+        std::snprintf(label, sizeof(label), "concatenate + write %zu x %ju B", count, payload);
+        bench::report(label, megabytes / concatenated * 1e9, "MB/s");
+        std::snprintf(label, sizeof(label), "writev %zu x %ju B", count, payload);
+        bench::report(label, megabytes / buffered * 1e9, "MB/s");
+        std::snprintf(label, sizeof(label), "O_DIRECT %zu x %ju B", count, payload);
+        bench::report(label, megabytes / direct * 1e9, "MB/s");
+    }
+}
+
+// a header plus many payload buffers: concatenate then write, against writev and O_DIRECT
+// run it on tmpfs (e.g. /dev/shm/bench.bin) to leave the disk out of the comparison
+int main(int argc, char *argv[]) {
+    const char *filename = argc > 1 ? argv[1] : "bench_vectored.bin";
+    run(filename, 4096, 0x400);
+    run(filename, 256, 0x10000);
+    std::remove(filename);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,48 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "bench.h"
+
+// unchecked wmemory_t::get_X against read_view_t, checked per value and per record
+int main() {
+    using namespace utils;
+    constexpr size_t count = 1000000;
+    wmemory_t buffer(count * 16);
+    for (size_t i = 0; i < count; ++i) {
+        buffer.setInt(int(i));
+        buffer.setInt(int(i) * 3);
+        buffer.setDouble(double(i) * 0.5);
+    }
+    double sum = 0.0;
+
+    const double unchecked = bench::measure(20, [&] {
+        buffer.rewind();
+        for (size_t i = 0; i < count; ++i)
+            sum += buffer.get_int() + buffer.get_int() + buffer.get_double();
+        bench::do_not_optimize(sum);
+    }) / count;
+
+    const double per_value = bench::measure(20, [&] {
+        read_view_t view = buffer.view();
+        for (size_t i = 0; i < count; ++i)
+            sum += view.get_int() + view.get_int() + view.get_double();
+        bench::do_not_optimize(sum);
+        bench::do_not_optimize(view.ok());
+    }) / count;
+
+    const double per_record = bench::measure(20, [&] {
+        read_view_t view = buffer.view();
+        int a = 0, b = 0;
+        double c = 0;
+        for (size_t i = 0; i < count; ++i) {
+            view.read(a, b, c);
+            sum += a + b + c;
+        }
+        bench::do_not_optimize(sum);
+        bench::do_not_optimize(view.ok());
+    }) / count;
+
+    bench::report("wmemory_t get_int/get_double (unchecked)", unchecked, "ns/record");
+    bench::report("read_view_t get_int/get_double", per_value, "ns/record");
+    bench::report("read_view_t read(int, int, double)", per_record, "ns/record");
+    return EXIT_SUCCESS;
+}
@@ -2,12 +2,17 @@
 #define SERIALIZER_H
 #if _MSC_VER
 #include <io.h>
+#include <fcntl.h>
 #include <stdint.h>
+#include <stdlib.h>
 #elif defined(__MINGW32__) || defined(__MINGW64__)
 #include <unistd.h>
 #include <cstdint>
 #define _STD ::std::
 #endif
+#ifndef _STD
+#define _STD ::std::
+#endif
 #include <string>
 #include <memory>
 #include <vector>
@@ -19,11 +24,46 @@
 #include <concepts>
 #include <type_traits>
 #include <tuple>
+#include <span>
+#include <ranges>
+#include <utility>
 #include <new>
 #include <iostream>
 #include <algorithm>
 #include <filesystem>
 #include <functional>
+#include <memory_resource>
+#include <bit>
+#include <chrono>
+#include <limits>
+#include <charconv>
+#include <array>
+#include <cerrno>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <future>
+#include <deque>
+#include <condition_variable>
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#define __SERIALIZER_POSIX__
+#endif
+#if defined(__linux__) && __has_include(<linux/io_uring.h>)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#if defined(__NR_io_uring_setup) && defined(IORING_FEAT_FAST_POLL) // headers of 5.7 or later
+#define __SERIALIZER_URING__
+#endif
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define __SERIALIZER_SSE2__
+#endif
 #ifdef __USING_SERIALIZER__
 namespace utils {
     // initialize variant for support data-type
@@ -48,745 +88,5600 @@ namespace utils {
         static constexpr int variant_double = 12;
     };
 
-    class wmemory_t {
+    // class to define how wmemory_t behave once the reserved size is exceeded
+    class policy_t {
     public:
-        wmemory_t(const std::nullptr_t &) {
-            m_size = 0x00, m_lens = 0x00;
-            buffer.clear();
+        static constexpr int fixed = 0; // throw std::runtime_error, the default behaviour
+        static constexpr int growable = 1; // grow the capacity geometrically, amortized O(1) append
+    };
+
+    // class to define the wire layout of the values written into wmemory_t
+    class encoding_t {
+    public:
+        static constexpr int fixed = 0x0; // host layout, fixed width, the default behaviour
+        static constexpr int compact = 0x1; // LEB128 lengths and integers, zigzag for signed integers
+        static constexpr int little = 0x2; // little-endian values, byte-swapped on big-endian hosts only
+        static constexpr int big = 0x4; // big-endian (network order) values, byte-swapped on little-endian hosts only
+    };
+
+    // the wire layout relies on these widths, only byte order differs between hosts
+    static_assert(sizeof(short) == 2 && sizeof(int) == 4 && sizeof(long long) == 8, "unsupported integer widths");
+    static_assert(std::numeric_limits<float>::is_iec559 && std::numeric_limits<double>::is_iec559,
+                  "float and double must be IEEE 754");
+
+    namespace detail {
+        template<class _typename, class _variant>
+        struct variant_index;
+
+        template<class _typename, class... _types>
+        struct variant_index<_typename, std::variant<_types...> > {
+            static constexpr size_t value = [] {
+                size_t index = 0x00;
+                const bool found = ((std::is_same_v<_typename, _types> ? true : (++index, false)) || ...);
+                return found ? index : std::variant_npos;
+            }();
+        };
+    }
+
+    // support_t index of a type at compile time, std::variant_npos if it is not supported
+    template<class _typename>
+    inline constexpr size_t support_v = detail::variant_index<std::remove_cvref_t<_typename>, variant>::value;
+
+    // types that wmemory_t can store, one of the alternatives of `variant`
+    template<class _typename>
+    concept supported = support_v<_typename> != std::variant_npos;
+
+    // types that are stored as a size_t length followed by the characters
+    template<class _typename>
+    concept string_like = support_v<_typename> == support_t::variant_str
+                          || support_v<_typename> == support_t::variant_strview;
+
+    // types that can be written in bulk with set_array / get_array
+    template<class _typename>
+    concept array_like = supported<_typename> && !string_like<_typename>;
+
+    // integers that encoding_t::compact stores as varints, single bytes are kept as is
+    template<class _typename>
+    concept varint_like = std::is_integral_v<_typename> && !std::is_same_v<_typename, bool>
+                          && sizeof(_typename) > 1;
+
+    namespace detail {
+        // maps signed integers to unsigned ones so small magnitudes stay small: 0, -1, 1, -2 ...
+        template<class _typename>
+        constexpr uint64_t zigzag(const _typename &value) noexcept {
+            if constexpr (std::is_signed_v<_typename>) {
+                const int64_t wide = value;
+                return (uint64_t(wide) << 1) ^ uint64_t(wide >> 63);
+            } else return value;
         }
 
-        /**
-       * Constructs a `wmemory_t` object with the specified size.
-       *
-       * @param size The size to reserve for the internal buffer. Must be greater than zero.
-       *
-       * @throws std::invalid_argument If the size is less than or equal to zero.
-       *
-       * @return A newly constructed `wmemory_t` object with reserved size.
-       */
-        wmemory_t(const uintmax_t &size) {
-            if (size <= 0x000)
-                throw std::invalid_argument("size must be greater than zero");
-            buffer.reserve(size);
-            m_size = size, m_lens = 0x00;
-            _STD memset(buffer.data(), 0x0, m_size);
+        template<class _typename>
+        constexpr _typename unzigzag(const uint64_t &value) noexcept {
+            if constexpr (std::is_signed_v<_typename>)
+                return static_cast<_typename>(int64_t(value >> 1) ^ -int64_t(value & 1));
+            else return static_cast<_typename>(value);
         }
 
-        ~wmemory_t() {
-            buffer.clear();
-            m_size = 0, m_lens = 0;
+        // bytes taken by the LEB128 encoding of `value`
+        constexpr uintmax_t varint_size(const uint64_t &value) noexcept {
+            return (std::bit_width(value | 1) + 6) / 7;
         }
 
-        /**
-         * Constructs a `wmemory_t` object from the provided vector of bytes.
-         *
-         * @param con A vector of `uint8_t` representing the initial content to be used
-         *            for constructing the internal buffer.
-         *
-         * @return A newly constructed `wmemory_t` object initialized with the contents
-         *         of the provided vector.
-         */
-        wmemory_t(const std::vector<uint8_t> &con) {
-            buffer.reserve(con.size());
-            m_size = con.size(), m_lens = 0x00;
-            _STD memset(buffer.data(), 0x0, m_size);
+        // writes `value` as a LEB128 varint, 7 bits per byte, low bits first, returns the end
+        inline uint8_t *write_varint(uint8_t *out, uint64_t value) noexcept {
+            while (value >= 0x80) {
+                *out++ = static_cast<uint8_t>(value) | 0x80;
+                value >>= 7;
+            }
+            *out++ = static_cast<uint8_t>(value);
+            return out;
         }
 
-        /**
-         * Constructs a `wmemory_t` object with the given data and size.
-         *
-         * @param data A pointer to the initial data to be used for constructing the internal buffer.
-         *             Must not be null.
-         * @param size The size of the data to reserve for the internal buffer. Must be greater than zero.
-         *
-         * @throws std::invalid_argument If the data pointer is null or the size is less than or equal to zero.
-         *
-         * @return A newly constructed `wmemory_t` object initialized with the provided data and size.
-         */
-        wmemory_t(uint8_t *data, const uintmax_t &size) {
-            if (data != nullptr && size >= 1) {
-                buffer.reserve(size);
-                _STD memcpy(buffer.data(), data, size);
-                m_size = size, m_lens = 0x00;
-            } else throw std::invalid_argument("data is null or size is negative");
+        // reads a LEB128 varint that must end before `end`, returns false if it runs past it
+        inline bool read_varint(const uint8_t *&in, const uint8_t *end, uint64_t &value) noexcept {
+            value = 0x00;
+            for (int shift = 0; in < end && shift < 64; shift += 7) {
+                const uint8_t byte = *in++;
+                value |= uint64_t(byte & 0x7f) << shift;
+                if (!(byte & 0x80))
+                    return true;
+            }
+            return false;
         }
 
-        wmemory_t(const wmemory_t &next) {
-            if (next.m_size != 0x00 && next.buffer.data()) {
-                buffer.clear();
-                buffer = next.buffer;
-                m_size = next.m_size, m_lens = next.m_lens;
+        // reads a LEB128 varint and advances `in` past it
+        inline uint64_t read_varint(const uint8_t *&in) noexcept {
+            uint64_t value = 0x00;
+            for (int shift = 0; shift < 64; shift += 7) {
+                const uint8_t byte = *in++;
+                value |= uint64_t(byte & 0x7f) << shift;
+                if (!(byte & 0x80))
+                    break;
             }
+            return value;
         }
 
-        void resize(const uintmax_t &size) {
-            buffer.resize(size);
+        inline uint16_t bswap(const uint16_t &value) noexcept {
+#if _MSC_VER
+            return _byteswap_ushort(value);
+#else
+            return __builtin_bswap16(value);
+#endif
         }
 
-        void reserve(const uintmax_t &size) {
-            buffer.reserve(size);
+        inline uint32_t bswap(const uint32_t &value) noexcept {
+#if _MSC_VER
+            return _byteswap_ulong(value);
+#else
+            return __builtin_bswap32(value);
+#endif
         }
 
-        void reserve(uint8_t *data, const uintmax_t &size) {
-            if (data != nullptr && size >= 1) {
-                buffer.reserve(size);
-                _STD memcpy(buffer.data(), data, size);
-                m_size = size, m_lens = 0x00;
-            } else throw std::invalid_argument("data is null or size is negative");
+        inline uint64_t bswap(const uint64_t &value) noexcept {
+#if _MSC_VER
+            return _byteswap_uint64(value);
+#else
+            return __builtin_bswap64(value);
+#endif
         }
 
-        /**
-         * Cleans up the internal buffer and resets its size and length indicators.
-         *
-         * This function clears the internal buffer if it contains any data,
-         * and then sets the length and size indicators to zero.
-         *
-         * @note This function is marked as `noexcept` and guarantees not to throw any exceptions.
-         */
-        constexpr void cleanup() noexcept {
-            if (buffer.data()) {
-                buffer.clear();
-                m_lens = 0x00, m_size = 0x00;
-            }
+        // whether `encoding` asks for the byte order this host does not use
+        constexpr bool swapped(const int &encoding) noexcept {
+            return encoding & (std::endian::native == std::endian::little ? encoding_t::big : encoding_t::little);
         }
 
-        /**
-         * Checks if there is enough space in the internal buffer to accommodate additional data.
-         *
-         * @param size The size of the data to be checked against the remaining space in the buffer.
-         *             It should be a positive integer.
-         *
-         * @return `true` if there is enough space in the buffer, `false` otherwise.
-         */
-        constexpr bool is_enough(const uintmax_t &size) const {
-            return m_lens + size <= m_size;
+        // converts between host and wire order, the same operation both ways
+        template<class _typename>
+        inline _typename wire_order(const _typename &value, const int &encoding) noexcept {
+            if constexpr (sizeof(_typename) == 1)
+                return value;
+            else {
+                using _word = std::conditional_t<sizeof(_typename) == 2, uint16_t,
+                    std::conditional_t<sizeof(_typename) == 4, uint32_t, uint64_t> >;
+                if (!swapped(encoding))
+                    return value;
+                return std::bit_cast<_typename>(bswap(std::bit_cast<_word>(value)));
+            }
         }
 
         /**
-         * Increases the internal length by the specified size.
+         * Copies `count` elements of `_size` bytes, reversing the bytes of each one.
          *
-         * @param size The size to add to the internal length. Must be greater than zero.
+         * Runs 16 bytes at a time with SSE2 where available, `out` may equal `in`.
          */
-        void skip(const uintmax_t &size) {
-            if (size <= 0x000)
-                return;
-            m_lens += size;
+        template<size_t _size>
+        inline void swap_copy(uint8_t *out, const uint8_t *in, const size_t &count) noexcept {
+            using _word = std::conditional_t<_size == 2, uint16_t, std::conditional_t<_size == 4, uint32_t, uint64_t> >;
+            size_t i = 0x00;
+#ifdef __SERIALIZER_SSE2__
+            for (constexpr size_t lanes = 16 / _size; i + lanes <= count; i += lanes) {
+                __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i * _size));
+                // reverse the 16-bit words of each element, then the bytes of each word
+                if constexpr (_size == 4) {
+                    value = _mm_shufflehi_epi16(_mm_shufflelo_epi16(value, 0xb1), 0xb1);
+                } else if constexpr (_size == 8) {
+                    value = _mm_shufflehi_epi16(_mm_shufflelo_epi16(value, 0x1b), 0x1b);
+                }
+                value = _mm_or_si128(_mm_slli_epi16(value, 8), _mm_srli_epi16(value, 8));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i * _size), value);
+            }
+#endif
+            for (; i < count; ++i) {
+                _word word;
+                _STD memcpy(&word, in + i * _size, _size);
+                word = bswap(word);
+                _STD memcpy(out + i * _size, &word, _size);
+            }
         }
 
-        constexpr auto setBytes(const char &value) noexcept -> void {
-            insert(value);
+        // most bytes a value of this type can take on the wire
+        template<class _typename>
+        constexpr uintmax_t encoded_max(const int &encoding) noexcept {
+            if constexpr (varint_like<_typename>)
+                return encoding & encoding_t::compact ? (sizeof(_typename) * 8 + 6) / 7 : sizeof(_typename);
+            else return sizeof(_typename);
         }
+    }
 
-        constexpr auto setShort(const short &value) noexcept -> void {
-            insert(value);
-        }
+    /**
+     * Describes the fields of a struct for `set_struct` / `get_struct`, specialize it as
+     *
+     *     template<> struct utils::schema_t<point> {
+     *         static constexpr auto fields = std::make_tuple(&point::x, &point::y, &point::name);
+     *     };
+     *
+     * Fields are written in the order listed, each one can be an arithmetic type, a
+     * `std::string`, a `std::vector` of primitives (but `bool`) or another described struct.
+     */
+    template<class _typename>
+    struct schema_t;
 
-        constexpr auto setInt(const int &value) noexcept -> void {
-            insert(value);
-        }
+    // structs with a `schema_t` specialization
+    template<class _typename>
+    concept described = requires { std::tuple_size<decltype(schema_t<_typename>::fields)>::value; };
 
-        constexpr auto setLong(const long long &value) noexcept -> void {
-            insert(value);
-        }
+    namespace detail {
+        template<class _typename>
+        struct is_vector : std::false_type {
+        };
 
-        constexpr auto setFloat(const float &value) noexcept -> void {
-            insert(value);
-        }
+        template<class _typename, class _allocator>
+        struct is_vector<std::vector<_typename, _allocator> > : std::true_type {
+        };
 
-        constexpr auto setDouble(const double &value) noexcept -> void {
-            insert(value);
-        }
+        // fields copied as raw bytes in fixed-width encodings
+        template<class _typename>
+        concept raw_field = std::is_arithmetic_v<_typename> && sizeof(_typename) <= 8;
 
-        constexpr auto setUBytes(const uint8_t &value) noexcept -> void {
-            insert(value);
-        }
+        template<class _typename>
+        concept field_like = raw_field<_typename> || described<_typename>
+                             || std::is_same_v<_typename, std::string>
+                             || (is_vector<_typename>::value && array_like<typename _typename::value_type>
+                                 && !std::is_same_v<typename _typename::value_type, bool>);
 
-        constexpr auto setUShort(const uint16_t &value) noexcept -> void {
-            insert(value);
-        }
+        template<class _struct, class _member>
+        _member member_of(_member _struct::*);
 
-        constexpr auto setUInt(const uint32_t &value) noexcept -> void {
-            insert(value);
+        // type of the `_index`-th field of `_struct`
+        template<class _struct, size_t _index>
+        using field_type = decltype(member_of(std::get<_index>(schema_t<_struct>::fields)));
+
+        template<class _struct>
+        constexpr size_t field_count = std::tuple_size_v<std::remove_cvref_t<decltype(schema_t<_struct>::fields)> >;
+
+        template<class _struct, size_t _index>
+        constexpr decltype(auto) field(_struct &value) noexcept {
+            return value.*std::get<_index>(schema_t<std::remove_const_t<_struct> >::fields);
         }
 
-        constexpr auto setULong(const uint64_t &value) noexcept -> void {
-            insert(value);
+        // bytes written for a struct regardless of its content: primitives and length prefixes
+        template<described _struct>
+        consteval uintmax_t schema_fixed_size() noexcept {
+            return []<size_t... _index>(std::index_sequence<_index...>) {
+                return (uintmax_t(0x00) + ... + [] {
+                    using _field = field_type<_struct, _index>;
+                    static_assert(field_like<_field>, "unsupported field type in schema_t");
+                    if constexpr (raw_field<_field>)
+                        return uintmax_t(sizeof(_field));
+                    else if constexpr (described<_field>)
+                        return schema_fixed_size<_field>();
+                    else return uintmax_t(sizeof(uint64_t));
+                }());
+            }(std::make_index_sequence<field_count<_struct> >());
         }
 
-        constexpr auto setString(const std::string_view &value) noexcept -> void {
-            insert(value);
+        // bytes written for the strings and vectors of a struct
+        template<described _struct>
+        uintmax_t schema_dynamic_size(const _struct &value) noexcept {
+            return [&]<size_t... _index>(std::index_sequence<_index...>) {
+                return (uintmax_t(0x00) + ... + [&] {
+                    using _field = field_type<_struct, _index>;
+                    const _field &member = field<const _struct, _index>(value);
+                    if constexpr (raw_field<_field>)
+                        return uintmax_t(0x00);
+                    else if constexpr (described<_field>)
+                        return schema_dynamic_size(member);
+                    else return uintmax_t(member.size() * sizeof(typename _field::value_type));
+                }());
+            }(std::make_index_sequence<field_count<_struct> >());
         }
 
-        constexpr auto setStringView(const std::string_view &value) noexcept -> void {
-            insert(value);
+        // index of the first field at or after `_first` that is not a raw field
+        template<class _struct, size_t _first>
+        consteval size_t run_end() noexcept {
+            if constexpr (_first == field_count<_struct>)
+                return _first;
+            else if constexpr (!raw_field<field_type<_struct, _first> >)
+                return _first;
+            else return run_end<_struct, _first + 1>();
         }
 
-        constexpr auto setBool(const bool &value) noexcept -> void {
-            insert(value);
+        // whether fields [_first, _last) sit back to back in memory, folded to a constant by the optimizer
+        template<class _struct, size_t _first, size_t _last>
+        bool contiguous(const _struct &value) noexcept {
+            return [&]<size_t... _index>(std::index_sequence<_index...>) {
+                return ((reinterpret_cast<const uint8_t *>(&field<const _struct, _first + _index>(value))
+                         + sizeof(field_type<_struct, _first + _index>)
+                         == reinterpret_cast<const uint8_t *>(&field<const _struct, _first + _index + 1>(value))) && ...);
+            }(std::make_index_sequence<_last - _first - 1>());
         }
 
-    private:
         /**
-         * Retrieves a value of type `_typename` from the internal buffer.
+         * Writes the fields [_first, end) of `value` at `out` in a fixed-width encoding.
          *
-         * The method decodes different types from the internal buffer based on
-         * the type held by the variant. It handles cases of `std::string_view`,
-         * `std::string`, and other primitive types specified by the variant.
-         *
-         * Note: If an invalid variant type is passed through, it might show an error
-         * at compile time. Ensure that the variant type is supported.
-         *
-         * @throws std::bad_variant_access If the variant holds an invalid type.
-         *
-         * @return The value of type `_typename` retrieved from the buffer.
+         * The caller checked the room for the whole struct. A run of raw fields laid out back to
+         * back in the struct is written with a single memcpy when no byte swap is needed.
          */
-        template<class _typename>
-        constexpr _typename get() noexcept(false) {
-            _typename value;
-            const variant &var = value;
-            if (var.index() == std::variant_npos)
-                throw std::bad_variant_access();
-            else if (var.index() == support_t::variant_strview) {
-                const size_t size = *(size_t *) &buffer.data()[m_lens];
-                m_lens += sizeof(size_t);
-                value = std::string_view((char *) buffer.data() + m_lens, size);
-                m_lens += size;
-            } else if (var.index() == support_t::variant_str) {
-                const size_t size = *(size_t *) &buffer.data()[m_lens];
-                m_lens += sizeof(size_t);
-                value = std::string((char *) buffer.data() + m_lens, size);
-                m_lens += size;
-            } else {
-                _STD memcpy(&value, buffer.data() + m_lens, sizeof(_typename));
-                m_lens += sizeof(_typename);
+        template<described _struct, size_t _first = 0x00>
+        void encode_fields(uint8_t *&out, const _struct &value, const int &encoding) noexcept {
+            if constexpr (_first < field_count<_struct>) {
+                using _field = field_type<_struct, _first>;
+                if constexpr (raw_field<_field>) {
+                    constexpr size_t last = run_end<_struct, _first>();
+                    const uint8_t *begin = reinterpret_cast<const uint8_t *>(&field<const _struct, _first>(value));
+                    if (!swapped(encoding) && contiguous<_struct, _first, last>(value)) {
+                        const uint8_t *end = reinterpret_cast<const uint8_t *>(&field<const _struct, last - 1>(value))
+                                             + sizeof(field_type<_struct, last - 1>);
+                        _STD memcpy(out, begin, end - begin);
+                        out += end - begin;
+                    } else {
+                        [&]<size_t... _index>(std::index_sequence<_index...>) {
+                            ((out = [&](uint8_t *at) {
+                                const auto wire = wire_order(field<const _struct, _first + _index>(value), encoding);
+                                _STD memcpy(at, &wire, sizeof(wire));
+                                return at + sizeof(wire);
+                            }(out)), ...);
+                        }(std::make_index_sequence<last - _first>());
+                    }
+                    encode_fields<_struct, last>(out, value, encoding);
+                } else {
+                    const _field &member = field<const _struct, _first>(value);
+                    if constexpr (described<_field>)
+                        encode_fields(out, member, encoding);
+                    else {
+                        using _element = typename _field::value_type;
+                        const uint64_t count = wire_order(uint64_t(member.size()), encoding);
+                        _STD memcpy(out, &count, sizeof(uint64_t));
+                        out += sizeof(uint64_t);
+                        if (sizeof(_element) > 1 && swapped(encoding))
+                            swap_copy<sizeof(_element)>(out, reinterpret_cast<const uint8_t *>(member.data()),
+                                                        member.size());
+                        else if (!member.empty())
+                            _STD memcpy(out, member.data(), member.size() * sizeof(_element));
+                        out += member.size() * sizeof(_element);
+                    }
+                    encode_fields<_struct, _first + 1>(out, value, encoding);
+                }
             }
-            return value;
         }
 
-    public:
-        /**
-         * Retrieves a string from the internal buffer.
-         *
-         * This method reads a size value from the buffer, then reads and returns
-         * a string of that size starting from the current buffer position.
-         *
-         * @return A string extracted from the buffer. Returns an empty string if the buffer size is zero.
-         *
-         * @exception noexcept This function is declared noexcept and will not throw exceptions.
-         */
-        const std::string get_string() noexcept(true) {
-            if (m_size != 0x00) {
-                size_t size = *(size_t *) &buffer.data()[m_lens];
-                m_lens += sizeof(size_t);
-                std::string value = std::string((char *) buffer.data() + m_lens, size);
-                m_lens += size;
-                return value;
-            }
-            return std::string("");
+        // wire size of the raw fields [_first, _last)
+        template<class _struct, size_t _first, size_t _last>
+        consteval uintmax_t run_size() noexcept {
+            return []<size_t... _index>(std::index_sequence<_index...>) {
+                return (uintmax_t(0x00) + ... + sizeof(field_type<_struct, _first + _index>));
+            }(std::make_index_sequence<_last - _first>());
         }
 
         /**
-         * Retrieves a string view from the internal buffer.
-         *
-         * This function extracts a string view from the internal buffer starting at the current position
-         * specified by `m_lens`. The length of the string is determined by reading a `size_t` value from the buffer.
-         * `m_lens` is then incremented by the size of the string and returns the string view.
+         * Reads back what `encode_fields` wrote, raw runs are copied into the struct in one go as well.
          *
-         * @return A `std::string_view` object representing the extracted string. If the internal size `m_size`
-         * is zero, an empty string view is returned.
+         * Every run and every string or vector is checked against `end` before it is read, a length
+         * read from the wire is checked before anything is allocated for it.
          *
-         * @note This function is marked as `noexcept(true)`, which means it is guaranteed not to throw exceptions.
+         * @throws std::out_of_range If the fields run past `end`.
          */
-        const std::string_view get_string_view() noexcept(true) {
-            if (m_size != 0x00) {
-                size_t size = *(size_t *) &buffer.data()[m_lens];
-                m_lens += sizeof(size_t);
-                std::string_view value = std::string_view((char *) buffer.data() + m_lens, size);
-                m_lens += size;
-                return value;
+        template<described _struct, size_t _first = 0x00>
+        void decode_fields(const uint8_t *&in, const uint8_t *end, _struct &value, const int &encoding) {
+            if constexpr (_first < field_count<_struct>) {
+                using _field = field_type<_struct, _first>;
+                if constexpr (raw_field<_field>) {
+                    constexpr size_t last = run_end<_struct, _first>();
+                    if (uintmax_t(end - in) < run_size<_struct, _first, last>())
+                        throw std::out_of_range("struct runs past the end of the buffer");
+                    uint8_t *begin = reinterpret_cast<uint8_t *>(&field<_struct, _first>(value));
+                    if (!swapped(encoding) && contiguous<_struct, _first, last>(value)) {
+                        const uint8_t *end = reinterpret_cast<const uint8_t *>(&field<_struct, last - 1>(value))
+                                             + sizeof(field_type<_struct, last - 1>);
+                        _STD memcpy(begin, in, end - begin);
+                        in += end - begin;
+                    } else {
+                        [&]<size_t... _index>(std::index_sequence<_index...>) {
+                            ([&](auto &member) {
+                                _STD memcpy(&member, in, sizeof(member));
+                                member = wire_order(member, encoding);
+                                in += sizeof(member);
+                            }(field<_struct, _first + _index>(value)), ...);
+                        }(std::make_index_sequence<last - _first>());
+                    }
+                    decode_fields<_struct, last>(in, end, value, encoding);
+                } else {
+                    _field &member = field<_struct, _first>(value);
+                    if constexpr (described<_field>)
+                        decode_fields(in, end, member, encoding);
+                    else {
+                        using _element = typename _field::value_type;
+                        uint64_t count;
+                        if (uintmax_t(end - in) < sizeof(uint64_t))
+                            throw std::out_of_range("struct runs past the end of the buffer");
+                        _STD memcpy(&count, in, sizeof(uint64_t));
+                        count = wire_order(count, encoding);
+                        in += sizeof(uint64_t);
+                        if (count > uintmax_t(end - in) / sizeof(_element))
+                            throw std::out_of_range("struct runs past the end of the buffer");
+                        member.resize(count);
+                        if (sizeof(_element) > 1 && swapped(encoding))
+                            swap_copy<sizeof(_element)>(reinterpret_cast<uint8_t *>(member.data()), in, count);
+                        else if (count != 0x00)
+                            _STD memcpy(member.data(), in, count * sizeof(_element));
+                        in += count * sizeof(_element);
+                    }
+                    decode_fields<_struct, _first + 1>(in, end, value, encoding);
+                }
             }
-            return std::string_view("");
         }
+    }
 
-        /**
-         * Retrieves the next byte from the buffer.
-         *
-         * This function extracts a single byte from the buffer if the buffer is not empty.
-         * It advances the internal position index after reading the byte.
-         *
-         * @return The next byte from the buffer, or -1 if the buffer is empty.
-         *
-         * @note The function is marked as `noexcept(true)`, indicating it does not throw exceptions.
-         */
-        const char get_bytes() noexcept(true) {
-            if (m_size != 0x00) {
-                const char value = *(char *) &buffer.data()[m_lens];
-                m_lens += sizeof(char);
-                return value;
+    /**
+     * Opt-in counters and latency histograms for buffers, file I/O and the heap, compiled in
+     * when `__SERIALIZER_STATS__` is defined before including the header. Without it every
+     * hook is an empty inline function and `snapshot` returns an empty string.
+     *
+     * Counters are kept per thread, each one only written by its own thread with a relaxed
+     * load and store, and summed by `snapshot`. Histograms are shared relaxed atomics, they
+     * only time operations that are slow anyway (resizes, system calls).
+     */
+    namespace stats {
+#ifdef __SERIALIZER_STATS__
+        constexpr bool enabled = true;
+#else
+        constexpr bool enabled = false;
+#endif
+
+        // class to define the counters, `names` holds their exported names in the same order
+        class counter_t {
+        public:
+            static constexpr size_t buffer_writes = 0; // values written into a wmemory_t
+            static constexpr size_t buffer_write_bytes = 1;
+            static constexpr size_t buffer_reads = 2; // values read from a wmemory_t
+            static constexpr size_t buffer_read_bytes = 3;
+            static constexpr size_t buffer_resizes = 4; // growths of a growable wmemory_t
+            static constexpr size_t buffer_overflows = 5; // writes rejected with "maximum buffer size exceeded"
+            static constexpr size_t io_writes = 6; // write system calls, or io_uring requests
+            static constexpr size_t io_write_bytes = 7;
+            static constexpr size_t io_reads = 8; // read system calls, or io_uring requests
+            static constexpr size_t io_read_bytes = 9;
+            static constexpr size_t io_errors = 10; // failed reads and writes
+            static constexpr size_t count = 11;
+
+            static constexpr const char *names[count] = {
+                "serializer_buffer_writes_total", "serializer_buffer_write_bytes_total",
+                "serializer_buffer_reads_total", "serializer_buffer_read_bytes_total",
+                "serializer_buffer_resizes_total", "serializer_buffer_overflows_total",
+                "serializer_io_writes_total", "serializer_io_write_bytes_total",
+                "serializer_io_reads_total", "serializer_io_read_bytes_total",
+                "serializer_io_errors_total",
+            };
+        };
+
+        // class to define the latency histograms, `names` holds their exported names in the same order
+        class histogram_t {
+        public:
+            static constexpr size_t buffer_resize = 0;
+            static constexpr size_t io_write = 1;
+            static constexpr size_t io_read = 2;
+            static constexpr size_t count = 3;
+            static constexpr size_t buckets = 40; // bucket `i` counts latencies under 2^i ns, the last one is open
+
+            static constexpr const char *names[count] = {
+                "serializer_buffer_resize_ns", "serializer_io_write_ns", "serializer_io_read_ns",
+            };
+        };
+
+#ifdef __SERIALIZER_STATS__
+        namespace detail {
+            struct local_t;
+
+            // the counters of every live thread, and the totals of the threads that exited
+            struct registry_t {
+                std::mutex mutex;
+                std::vector<local_t *> threads;
+                uint64_t retired[counter_t::count] = {};
+            };
+
+            inline registry_t &registry() {
+                static registry_t instance;
+                return instance;
+            }
+
+            // counters of one thread, only written by that thread
+            struct local_t {
+                std::atomic<uint64_t> values[counter_t::count] = {};
+
+                local_t() {
+                    std::lock_guard<std::mutex> lock(registry().mutex);
+                    registry().threads.push_back(this);
+                }
+
+                ~local_t() {
+                    registry_t &shared = registry();
+                    std::lock_guard<std::mutex> lock(shared.mutex);
+                    for (size_t i = 0; i < counter_t::count; ++i)
+                        shared.retired[i] += values[i].load(std::memory_order_relaxed);
+                    std::erase(shared.threads, this);
+                }
+            };
+
+            inline local_t &local() {
+                thread_local local_t instance;
+                return instance;
+            }
+
+            struct buckets_t {
+                std::atomic<uint64_t> counts[histogram_t::buckets] = {};
+                std::atomic<uint64_t> sum{0};
+            };
+
+            inline buckets_t (&histograms())[histogram_t::count] {
+                static buckets_t instances[histogram_t::count];
+                return instances;
             }
-            return -1;
         }
+#endif
 
         /**
-         * Retrieves a `short` value from the internal buffer if available.
-         *
-         * If the buffer is not empty, extracts a `short` value from the current position
-         * and updates the position accordingly.
+         * Adds `value` to a counter of the calling thread.
          *
-         * @return The extracted `short` value, or -1 if the buffer is empty.
+         * @param counter One of `counter_t`.
          */
-        const short get_short() noexcept(true) {
-            if (m_size != 0x00) {
-                const short value = *(short *) &buffer.data()[m_lens];
-                m_lens += sizeof(short);
-                return value;
-            }
-            return -1;
+        inline void add(const size_t &counter, const uint64_t &value = 1) noexcept {
+#ifdef __SERIALIZER_STATS__
+            std::atomic<uint64_t> &slot = detail::local().values[counter];
+            slot.store(slot.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+#else
+            (void) counter, (void) value;
+#endif
         }
 
         /**
-         * Retrieves an integer from the internal buffer.
-         *
-         * @return The next integer from the buffer if available, otherwise returns -1.
-         *
-         * This method is marked noexcept and guarantees not to throw exceptions.
+         * Records one latency.
          *
-         * The method reads an integer from the current buffer position indicated by `m_lens`,
-         * increments `m_lens` by the size of an integer, and returns the extracted value.
-         * If `m_size` is zero, indicating that no data is available, the method returns -1.
+         * @param histogram One of `histogram_t`.
+         * @param nanoseconds The latency to record.
          */
-        const int get_int() noexcept(true) {
-            if (m_size != 0x00) {
-                const int value = *(int *) &buffer.data()[m_lens];
-                m_lens += sizeof(int);
-                return value;
-            }
-            return -1;
+        inline void record(const size_t &histogram, const uint64_t &nanoseconds) noexcept {
+#ifdef __SERIALIZER_STATS__
+            detail::buckets_t &target = detail::histograms()[histogram];
+            target.counts[std::min<size_t>(std::bit_width(nanoseconds), histogram_t::buckets - 1)]
+                    .fetch_add(1, std::memory_order_relaxed);
+            target.sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+#else
+            (void) histogram, (void) nanoseconds;
+#endif
+        }
+
+        // records the lifetime of the scope into a histogram
+        class timer_t {
+        public:
+            explicit timer_t(const size_t &histogram) noexcept {
+#ifdef __SERIALIZER_STATS__
+                m_histogram = histogram;
+                m_start = std::chrono::steady_clock::now();
+#else
+                (void) histogram;
+#endif
+            }
+
+            ~timer_t() {
+#ifdef __SERIALIZER_STATS__
+                const auto elapsed = std::chrono::steady_clock::now() - m_start;
+                record(m_histogram, std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+#endif
+            }
+
+            timer_t(const timer_t &) = delete;
+            timer_t &operator=(const timer_t &) = delete;
+
+#ifdef __SERIALIZER_STATS__
+        private:
+            size_t m_histogram = 0x00;
+            std::chrono::steady_clock::time_point m_start;
+#endif
+        };
+
+        // counts one value and the bytes `position` moved by, once the scope ends
+        class tally_t {
+        public:
+            constexpr tally_t(const size_t &values, const size_t &bytes, const uintmax_t &position) noexcept
+#ifdef __SERIALIZER_STATS__
+                : m_values(values), m_bytes(bytes), m_position(position), m_start(position) {
+            }
+#else
+            {
+                (void) values, (void) bytes, (void) position;
+            }
+#endif
+
+            constexpr ~tally_t() {
+#ifdef __SERIALIZER_STATS__
+                if (!std::is_constant_evaluated() && m_position != m_start) {
+                    add(m_values);
+                    add(m_bytes, m_position - m_start);
+                }
+#endif
+            }
+
+            tally_t(const tally_t &) = delete;
+            tally_t &operator=(const tally_t &) = delete;
+
+#ifdef __SERIALIZER_STATS__
+        private:
+            size_t m_values, m_bytes;
+            const uintmax_t &m_position;
+            uintmax_t m_start;
+#endif
+        };
+
+        /**
+         * Current value of a counter, summed over every thread.
+         *
+         * @param counter One of `counter_t`.
+         */
+        inline uint64_t value(const size_t &counter) {
+#ifdef __SERIALIZER_STATS__
+            detail::registry_t &shared = detail::registry();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            uint64_t total = shared.retired[counter];
+            for (const detail::local_t *thread: shared.threads)
+                total += thread->values[counter].load(std::memory_order_relaxed);
+            return total;
+#else
+            (void) counter;
+            return 0x00;
+#endif
+        }
+
+        /**
+         * Renders every counter, histogram and default heap gauge in the Prometheus text format.
+         *
+         * @return The exposition text, empty if `__SERIALIZER_STATS__` is not defined.
+         */
+        inline std::string snapshot();
+    }
+
+    /**
+     * Bounds-checked reader over bytes it does not own, with its own read position.
+     *
+     * A read that does not fit does not throw: it sets a sticky error flag, returns a zero
+     * value and leaves the position unchanged, every later read fails too. A record can be
+     * decoded first and validated once with `ok()`. `read` checks a whole fixed-size record
+     * with a single comparison.
+     */
+    class read_view_t {
+    public:
+        read_view_t() noexcept = default;
+
+        /**
+         * Constructs a view over `size` bytes starting at `data`.
+         *
+         * @param data The bytes to read, they must outlive the view.
+         * @param size The number of readable bytes.
+         * @param encoding The `encoding_t` flags the bytes were written with.
+         */
+        read_view_t(const uint8_t *data, const uintmax_t &size, const int &encoding = encoding_t::fixed) noexcept
+            : m_data(data), m_size(size), m_encoding(encoding) {
+        }
+
+        /**
+         * Reads a fixed-size record of arithmetic values with one bounds check.
+         *
+         * In `encoding_t::compact` the values have no fixed size and are checked one by one.
+         *
+         * @param values The variables to read into, in wire order.
+         *
+         * @return `false` if the record does not fit, the error flag is then set and,
+         *         in fixed-width encodings, none of `values` is modified.
+         */
+        template<detail::raw_field... _types>
+        bool read(_types &... values) noexcept {
+            if (m_encoding & encoding_t::compact) {
+                ((values = get<_types>()), ...);
+                return !m_failed;
+            }
+            constexpr uintmax_t size = (sizeof(_types) + ... + 0x00);
+            if (m_failed || m_size - m_lens < size)
+                return fail();
+            ((values = unchecked<_types>()), ...);
+            return true;
+        }
+
+        const char get_bytes() noexcept { return get<char>(); }
+        const short get_short() noexcept { return get<short>(); }
+        const int get_int() noexcept { return get<int>(); }
+        const int64_t get_long() noexcept { return get<int64_t>(); }
+        const long long get_llong() noexcept { return get<long long>(); }
+        const uint8_t get_ubytes() noexcept { return get<uint8_t>(); }
+        const uint16_t get_ushort() noexcept { return get<uint16_t>(); }
+        const uint32_t get_uint() noexcept { return get<uint32_t>(); }
+        const uint64_t get_uint64() noexcept { return get<uint64_t>(); }
+        const bool get_bool() noexcept { return get<bool>(); }
+        const float get_float() noexcept { return get<float>(); }
+        const double get_double() noexcept { return get<double>(); }
+
+        /**
+         * Retrieves a string view pointing into the viewed bytes.
+         *
+         * @return The string, empty if its length prefix or characters do not fit.
+         */
+        const std::string_view get_string_view() noexcept {
+            const uintmax_t start = m_lens;
+            const size_t size = get_length();
+            if (m_failed || m_size - m_lens < size) {
+                m_lens = start;
+                fail();
+                return std::string_view("");
+            }
+            const std::string_view value(reinterpret_cast<const char *>(m_data) + m_lens, size);
+            m_lens += size;
+            return value;
+        }
+
+        const std::string get_string() {
+            return std::string(get_string_view());
+        }
+
+        /**
+         * Reads an array written by `set_array` into the given range.
+         *
+         * @param out A contiguous range large enough for the stored elements.
+         *
+         * @return The number of elements read, 0 with the error flag set if the array does
+         *         not fit in `out` or in the remaining bytes.
+         */
+        template<std::ranges::contiguous_range _range>
+            requires array_like<std::ranges::range_value_t<_range> >
+        size_t get_array(_range &&out) noexcept {
+            using _typename = std::ranges::range_value_t<_range>;
+            const uintmax_t start = m_lens;
+            const size_t count = get_length();
+            _typename *data = std::ranges::data(out);
+            if (m_failed || count > std::ranges::size(out))
+                return m_lens = start, fail(), 0x00;
+            if (varint_like<_typename> && (m_encoding & encoding_t::compact)) {
+                for (size_t i = 0; i < count; ++i)
+                    data[i] = get<_typename>();
+                if (m_failed)
+                    return m_lens = start, 0x00;
+                return count;
+            }
+            if ((m_size - m_lens) / sizeof(_typename) < count)
+                return m_lens = start, fail(), 0x00;
+            if (sizeof(_typename) > 1 && detail::swapped(m_encoding))
+                detail::swap_copy<sizeof(_typename)>(reinterpret_cast<uint8_t *>(data), m_data + m_lens, count);
+            else if (count != 0x00)
+                _STD memcpy(data, m_data + m_lens, count * sizeof(_typename));
+            m_lens += count * sizeof(_typename);
+            return count;
+        }
+
+        /**
+         * Moves the read position forward by `size` bytes.
+         *
+         * @return `false` with the error flag set if fewer than `size` bytes remain.
+         */
+        bool skip(const uintmax_t &size) noexcept {
+            if (m_failed || m_size - m_lens < size)
+                return fail();
+            m_lens += size;
+            return true;
+        }
+
+        // moves back to the first byte and clears the error flag
+        constexpr void rewind() noexcept {
+            m_lens = 0x00, m_failed = false;
+        }
+
+        constexpr bool ok() const noexcept { return !m_failed; }
+        constexpr explicit operator bool() const noexcept { return !m_failed; }
+        constexpr const uint8_t *data() const noexcept { return m_data; }
+        constexpr uintmax_t size() const noexcept { return m_size; }
+        constexpr uintmax_t position() const noexcept { return m_lens; }
+        constexpr uintmax_t remaining() const noexcept { return m_size - m_lens; }
+
+    private:
+        bool fail() noexcept {
+            m_failed = true;
+            return false;
+        }
+
+        // reads a value already known to fit
+        template<class _typename>
+        _typename unchecked() noexcept {
+            if constexpr (std::is_same_v<_typename, bool>)
+                return m_data[m_lens++] != 0x00;
+            else {
+                _typename value;
+                _STD memcpy(&value, m_data + m_lens, sizeof(_typename));
+                m_lens += sizeof(_typename);
+                return detail::wire_order(value, m_encoding);
+            }
+        }
+
+        template<class _typename>
+        _typename get() noexcept {
+            if constexpr (varint_like<_typename>) {
+                if (m_encoding & encoding_t::compact) {
+                    uint64_t value;
+                    return get_varint(value) ? detail::unzigzag<_typename>(value) : _typename();
+                }
+            }
+            if (m_failed || m_size - m_lens < sizeof(_typename)) {
+                fail();
+                return _typename();
+            }
+            return unchecked<_typename>();
+        }
+
+        bool get_varint(uint64_t &value) noexcept {
+            if (m_failed)
+                return false;
+            if (m_size - m_lens >= 10) {
+                // the longest varint fits, no check per byte
+                const uint8_t *in = m_data + m_lens;
+                value = detail::read_varint(in);
+                m_lens = in - m_data;
+                return true;
+            }
+            value = 0x00;
+            for (uintmax_t at = m_lens, shift = 0; at < m_size && shift < 64; ++at, shift += 7) {
+                value |= uint64_t(m_data[at] & 0x7f) << shift;
+                if (!(m_data[at] & 0x80)) {
+                    m_lens = at + 1;
+                    return true;
+                }
+            }
+            return fail();
+        }
+
+        size_t get_length() noexcept {
+            if (m_encoding & encoding_t::compact) {
+                uint64_t value;
+                return get_varint(value) ? static_cast<size_t>(value) : 0x00;
+            }
+            return static_cast<size_t>(get<uint64_t>());
+        }
+
+    private:
+        const uint8_t *m_data = nullptr; // viewed bytes, not owned
+        uintmax_t m_size = 0x00; // number of readable bytes
+        uintmax_t m_lens = 0x00; // read position
+        int m_encoding = encoding_t::fixed; // wire layout of the values
+        bool m_failed = false; // sticky, set by the first read that did not fit
+    };
+
+    namespace io {
+        class stream_writer_t;
+        class stream_reader_t;
+    }
+
+    /**
+     * Memory buffer to serialize values into and out of.
+     *
+     * The bytes are stored in a `std::vector<uint8_t, _allocator>`, so buffers can come from
+     * any standard allocator: `wmemory_t` uses `std::allocator`, `pmr_wmemory_t` takes a
+     * `std::pmr::memory_resource` (e.g. an `arena_t` or `heap_t`), `heap_wmemory_t` and
+     * `concurrent_wmemory_t` use the library heaps.
+     */
+    template<class _allocator = std::allocator<uint8_t> >
+    class basic_wmemory_t {
+    public:
+        using allocator_type = _allocator;
+
+        basic_wmemory_t(const std::nullptr_t &, const _allocator &alloc = _allocator()) : buffer(alloc) {
+            m_size = 0x00, m_lens = 0x00;
+            buffer.clear();
+        }
+
+        /**
+       * Constructs a `wmemory_t` object with the specified size.
+       *
+       * @param size The size to reserve for the internal buffer. Must be greater than zero.
+       * @param alloc The allocator the internal buffer is taken from.
+       *
+       * @throws std::invalid_argument If the size is less than or equal to zero.
+       *
+       * @return A newly constructed `wmemory_t` object with reserved size.
+       */
+        basic_wmemory_t(const uintmax_t &size, const _allocator &alloc = _allocator()) : buffer(alloc) {
+            if (size <= 0x000)
+                throw std::invalid_argument("size must be greater than zero");
+            buffer.resize(size);
+            m_data = buffer.data();
+            m_size = size, m_lens = 0x00;
+        }
+
+        /**
+         * Constructs a `wmemory_t` object with the specified size and growth policy.
+         *
+         * @param size The initial size to reserve for the internal buffer. Must be greater than zero.
+         * @param policy One of `policy_t`, `policy_t::growable` lets the buffer grow on demand
+         *               instead of throwing once `size` is exceeded.
+         * @param alloc The allocator the internal buffer is taken from.
+         *
+         * @throws std::invalid_argument If the size is less than or equal to zero.
+         */
+        basic_wmemory_t(const uintmax_t &size, const int &policy, const _allocator &alloc = _allocator())
+            : basic_wmemory_t(size, alloc) {
+            m_policy = policy;
+        }
+
+        ~basic_wmemory_t() {
+            buffer.clear();
+            m_size = 0, m_lens = 0;
+        }
+
+        /**
+         * Constructs a `wmemory_t` object from the provided vector of bytes.
+         *
+         * @param con A vector of `uint8_t` representing the initial content to be used
+         *            for constructing the internal buffer.
+         *
+         * @return A newly constructed `wmemory_t` object initialized with the contents
+         *         of the provided vector.
+         */
+        basic_wmemory_t(const std::vector<uint8_t> &con, const _allocator &alloc = _allocator()) : buffer(alloc) {
+            buffer.assign(con.begin(), con.end());
+            m_data = buffer.data();
+            m_size = con.size(), m_lens = 0x00;
+        }
+
+        /**
+         * Constructs a `wmemory_t` object with the given data and size.
+         *
+         * @param data A pointer to the initial data to be used for constructing the internal buffer.
+         *             Must not be null.
+         * @param size The size of the data to reserve for the internal buffer. Must be greater than zero.
+         * @param alloc The allocator the internal buffer is taken from.
+         *
+         * @throws std::invalid_argument If the data pointer is null or the size is less than or equal to zero.
+         *
+         * @return A newly constructed `wmemory_t` object initialized with the provided data and size.
+         */
+        basic_wmemory_t(uint8_t *data, const uintmax_t &size, const _allocator &alloc = _allocator()) : buffer(alloc) {
+            if (data != nullptr && size >= 1) {
+                buffer.assign(data, data + size);
+                m_data = buffer.data();
+                m_size = size, m_lens = 0x00;
+            } else throw std::invalid_argument("data is null or size is negative");
+        }
+
+        basic_wmemory_t(const basic_wmemory_t &next)
+            : buffer(std::allocator_traits<_allocator>::select_on_container_copy_construction(next.buffer.get_allocator())) {
+            if (next.m_size != 0x00 && next.m_data) {
+                buffer.assign(next.m_data, next.m_data + next.m_size);
+                m_data = buffer.data();
+                m_size = next.m_size, m_lens = next.m_lens;
+            }
+            m_policy = next.m_policy, m_encoding = next.m_encoding;
+        }
+
+        basic_wmemory_t &operator=(const basic_wmemory_t &next) {
+            if (this != &next) {
+                cleanup();
+                if (next.m_size != 0x00 && next.m_data) {
+                    buffer.assign(next.m_data, next.m_data + next.m_size);
+                    m_data = buffer.data();
+                    m_size = next.m_size, m_lens = next.m_lens;
+                }
+                m_policy = next.m_policy, m_encoding = next.m_encoding;
+            }
+            return *this;
+        }
+
+        /**
+         * Takes the storage of `next` without copying it, `next` is left empty.
+         *
+         * @param next The buffer to move from, it keeps its policy and encoding.
+         */
+        basic_wmemory_t(basic_wmemory_t &&next) noexcept
+            : buffer(std::move(next.buffer)), m_data(next.m_data), m_storage(std::move(next.m_storage)),
+              m_size(next.m_size), m_lens(next.m_lens), m_policy(next.m_policy), m_encoding(next.m_encoding) {
+            next.m_data = nullptr;
+            next.m_size = 0x00, next.m_lens = 0x00;
+        }
+
+        /**
+         * Takes the storage of `next`, `next` is left empty.
+         *
+         * The bytes are copied only if the allocators differ and don't propagate on move
+         * assignment (e.g. two `pmr_wmemory_t` over different resources), as for `std::vector`.
+         */
+        basic_wmemory_t &operator=(basic_wmemory_t &&next) noexcept(
+            std::allocator_traits<_allocator>::propagate_on_container_move_assignment::value ||
+            std::allocator_traits<_allocator>::is_always_equal::value) {
+            if (this != &next) {
+                const bool owned = next.m_data == next.buffer.data();
+                buffer = std::move(next.buffer);
+                m_storage = std::move(next.m_storage);
+                m_data = owned ? buffer.data() : next.m_data;
+                m_size = next.m_size, m_lens = next.m_lens;
+                m_policy = next.m_policy, m_encoding = next.m_encoding;
+                next.buffer.clear();
+                next.m_data = nullptr;
+                next.m_size = 0x00, next.m_lens = 0x00;
+            }
+            return *this;
+        }
+
+        /**
+         * Exchanges the storage, positions, policies and encodings of two buffers without copying.
+         *
+         * As for `std::vector`, the allocators must compare equal unless they propagate on swap.
+         */
+        void swap(basic_wmemory_t &other) noexcept {
+            using std::swap;
+            swap(buffer, other.buffer);
+            swap(m_data, other.m_data);
+            swap(m_storage, other.m_storage);
+            swap(m_size, other.m_size);
+            swap(m_lens, other.m_lens);
+            swap(m_policy, other.m_policy);
+            swap(m_encoding, other.m_encoding);
+        }
+
+        friend void swap(basic_wmemory_t &first, basic_wmemory_t &second) noexcept {
+            first.swap(second);
+        }
+
+        /**
+         * Hands the bytes written so far over to a vector and leaves the buffer empty.
+         *
+         * The vector takes the internal storage as is, nothing is copied: it holds `lens()`
+         * bytes and its capacity keeps the rest of the allocation. Attached memory (`attach`,
+         * `adopt` of a raw allocation) can't become a vector, its bytes are copied once.
+         *
+         * @return The written bytes.
+         */
+        std::vector<uint8_t, _allocator> release() {
+            std::vector<uint8_t, _allocator> bytes(buffer.get_allocator());
+            if (m_data == buffer.data()) {
+                buffer.resize(m_lens);
+                bytes.swap(buffer);
+            } else if (m_data) bytes.assign(m_data, m_data + m_lens);
+            cleanup();
+            return bytes;
+        }
+
+        /**
+         * Takes ownership of `bytes` without copying them, to read them back or write over them.
+         *
+         * The size of the buffer becomes `bytes.size()` and the position goes back to zero,
+         * so `adopt(other.release())` reads what `other` wrote.
+         *
+         * @note The storage only changes hands when the allocators compare equal or propagate on
+         *       move assignment, always the case for `wmemory_t`. A `pmr_wmemory_t` adopting a vector
+         *       from another memory resource copies the bytes into its own resource instead, as
+         *       `std::vector` move assignment does.
+         *
+         * @param bytes The storage to take, it is left empty.
+         */
+        void adopt(std::vector<uint8_t, _allocator> &&bytes) {
+            buffer = std::move(bytes);
+            bytes.clear();
+            m_storage.reset();
+            m_data = buffer.data();
+            m_size = buffer.size(), m_lens = 0x00;
+        }
+
+        /**
+         * Takes ownership of a raw allocation without copying it.
+         *
+         * The buffer reads and writes `data` in place and frees it with its deleter once it is
+         * released, adopts other storage or has to grow (the bytes are then copied once).
+         *
+         * @param data The allocation, e.g. from `new uint8_t[size]` or `std::make_unique_for_overwrite`.
+         * @param size The number of bytes of `data`. Must be greater than zero.
+         *
+         * @throws std::invalid_argument If the data pointer is null or the size is zero.
+         */
+        template<class _deleter>
+        void adopt(std::unique_ptr<uint8_t[], _deleter> data, const uintmax_t &size) {
+            uint8_t *bytes = data.get();
+            attach(bytes, size, std::shared_ptr<void>(std::move(data)));
+        }
+
+        /**
+         * Resizes the internal buffer, keeping the bytes already written.
+         *
+         * @param size The new size of the buffer. The write position is clamped to it.
+         */
+        void resize(const uintmax_t &size) {
+            if (m_storage) {
+                // external storage can't grow, move the bytes into our own buffer first
+                buffer.assign(m_data, m_data + (size < m_size ? size : m_size));
+                m_storage.reset();
+            }
+            buffer.resize(size);
+            m_data = buffer.data();
+            m_size = size;
+            if (m_lens > m_size)
+                m_lens = m_size;
+        }
+
+        /**
+         * Ensures the buffer can hold at least `size` bytes without growing again.
+         *
+         * Use it as a hint before a burst of writes on a `policy_t::growable` buffer,
+         * it never shrinks the buffer.
+         *
+         * @param size The minimum size of the buffer.
+         */
+        void reserve(const uintmax_t &size) {
+            if (size > m_size)
+                resize(size);
+        }
+
+        void reserve(uint8_t *data, const uintmax_t &size) {
+            if (data != nullptr && size >= 1) {
+                buffer.assign(data, data + size);
+                m_storage.reset();
+                m_data = buffer.data();
+                m_size = size, m_lens = 0x00;
+            } else throw std::invalid_argument("data is null or size is negative");
+        }
+
+        /**
+         * Points the buffer at memory it does not own, without copying it.
+         *
+         * Reads and writes go straight to `data`, the buffer falls back to its own
+         * storage (copying the bytes once) only if it has to grow.
+         *
+         * @param data A pointer to the external memory. Must not be null.
+         * @param size The size of the external memory. Must be greater than zero.
+         * @param owner Keeps the external memory alive for as long as the buffer uses it.
+         *
+         * @throws std::invalid_argument If the data pointer is null or the size is zero.
+         */
+        void attach(uint8_t *data, const uintmax_t &size, std::shared_ptr<void> owner) {
+            if (data != nullptr && size >= 1) {
+                buffer.clear();
+                m_storage = std::move(owner);
+                m_data = data;
+                m_size = size, m_lens = 0x00;
+            } else throw std::invalid_argument("data is null or size is negative");
+        }
+
+        /**
+         * Changes the behaviour of the buffer once its size is exceeded.
+         *
+         * @param policy One of `policy_t`.
+         */
+        constexpr void set_policy(const int &policy) noexcept {
+            m_policy = policy;
+        }
+
+        constexpr int policy() const noexcept { return m_policy; }
+
+        /**
+         * Changes the wire layout of the values written and read from now on.
+         *
+         * @param encoding A combination of `encoding_t` flags, e.g. `encoding_t::compact | encoding_t::big`,
+         *                 both sides must agree on it. Without `little` or `big` the host order is used.
+         */
+        constexpr void set_encoding(const int &encoding) noexcept {
+            m_encoding = encoding;
+        }
+
+        constexpr int encoding() const noexcept { return m_encoding; }
+
+        /**
+         * Cleans up the internal buffer and resets its size and length indicators.
+         *
+         * This function clears the internal buffer if it contains any data,
+         * and then sets the length and size indicators to zero.
+         *
+         * @note This function is marked as `noexcept` and guarantees not to throw any exceptions.
+         */
+        void cleanup() noexcept {
+            if (m_data) {
+                buffer.clear();
+                m_storage.reset();
+                m_data = buffer.data();
+                m_lens = 0x00, m_size = 0x00;
+            }
+        }
+
+        /**
+         * Checks if there is enough space in the internal buffer to accommodate additional data.
+         *
+         * @param size The size of the data to be checked against the remaining space in the buffer.
+         *             It should be a positive integer.
+         *
+         * @return `true` if there is enough space in the buffer, `false` otherwise.
+         */
+        constexpr bool is_enough(const uintmax_t &size) const {
+            return m_lens + size <= m_size;
+        }
+
+        /**
+         * Increases the internal length by the specified size.
+         *
+         * @param size The size to add to the internal length. Must be greater than zero.
+         */
+        void skip(const uintmax_t &size) {
+            if (size <= 0x000)
+                return;
+            m_lens += size;
+        }
+
+        /**
+         * Moves the internal length back to the start of the buffer, keeping its content.
+         *
+         * Use it to read back a buffer that was just written, or to reuse it for a new message.
+         */
+        constexpr void rewind() noexcept {
+            m_lens = 0x00;
+        }
+
+        constexpr auto setBytes(const char &value) -> void {
+            insert(value);
+        }
+
+        constexpr auto setShort(const short &value) -> void {
+            insert(value);
+        }
+
+        constexpr auto setInt(const int &value) -> void {
+            insert(value);
+        }
+
+        constexpr auto setLong(const long long &value) -> void {
+            insert(value);
+        }
+
+        constexpr auto setFloat(const float &value) -> void {
+            insert(value);
+        }
+
+        constexpr auto setDouble(const double &value) -> void {
+            insert(value);
+        }
+
+        constexpr auto setUBytes(const uint8_t &value) -> void {
+            insert(value);
+        }
+
+        constexpr auto setUShort(const uint16_t &value) -> void {
+            insert(value);
+        }
+
+        constexpr auto setUInt(const uint32_t &value) -> void {
+            insert(value);
+        }
+
+        constexpr auto setULong(const uint64_t &value) -> void {
+            insert(value);
+        }
+
+        constexpr auto setString(const std::string_view &value) -> void {
+            insert(value);
+        }
+
+        constexpr auto setStringView(const std::string_view &value) -> void {
+            insert(value);
+        }
+
+        constexpr auto setBool(const bool &value) -> void {
+            insert(value);
+        }
+
+    private:
+        /**
+         * Retrieves a value of type `_typename` from the internal buffer.
+         *
+         * The type is dispatched at compile time: `std::string_view` and `std::string`
+         * are read as a length followed by the characters, integers as varints in
+         * `encoding_t::compact`, any other trivially copyable type is copied out of
+         * the buffer as is.
+         *
+         * @return The value of type `_typename` retrieved from the buffer.
+         */
+        template<class _typename>
+        constexpr _typename get() noexcept(std::is_trivially_copyable_v<_typename>) {
+            const stats::tally_t tally(stats::counter_t::buffer_reads, stats::counter_t::buffer_read_bytes, m_lens);
+            if constexpr (string_like<_typename>) {
+                const size_t size = get_length();
+                const _typename value((const char *) m_data + m_lens, size);
+                m_lens += size;
+                return value;
+            } else if constexpr (varint_like<_typename>) {
+                if (m_encoding & encoding_t::compact)
+                    return detail::unzigzag<_typename>(get_varint());
+                return get_fixed<_typename>();
+            } else {
+                static_assert(std::is_trivially_copyable_v<_typename>, "unsupported type");
+                return get_fixed<_typename>();
+            }
+        }
+
+    public:
+        /**
+         * Retrieves a string from the internal buffer.
+         *
+         * This method reads a size value from the buffer, then reads and returns
+         * a string of that size starting from the current buffer position.
+         *
+         * @return A string extracted from the buffer. Returns an empty string if the buffer size is zero.
+         *
+         * @exception noexcept This function is declared noexcept and will not throw exceptions.
+         */
+        const std::string get_string() noexcept(true) {
+            if (m_size != 0x00) {
+                return get<std::string>();
+            }
+            return std::string("");
+        }
+
+        /**
+         * Retrieves a string view from the internal buffer.
+         *
+         * This function extracts a string view from the internal buffer starting at the current position
+         * specified by `m_lens`. The length of the string is determined by reading a `size_t` value from the buffer.
+         * `m_lens` is then incremented by the size of the string and returns the string view.
+         *
+         * @return A `std::string_view` object representing the extracted string. If the internal size `m_size`
+         * is zero, an empty string view is returned.
+         *
+         * @note This function is marked as `noexcept(true)`, which means it is guaranteed not to throw exceptions.
+         */
+        const std::string_view get_string_view() noexcept(true) {
+            if (m_size != 0x00) {
+                return get<std::string_view>();
+            }
+            return std::string_view("");
+        }
+
+        /**
+         * Retrieves the next byte from the buffer.
+         *
+         * This function extracts a single byte from the buffer if the buffer is not empty.
+         * It advances the internal position index after reading the byte.
+         *
+         * @return The next byte from the buffer, or -1 if the buffer is empty.
+         *
+         * @note The function is marked as `noexcept(true)`, indicating it does not throw exceptions.
+         */
+        const char get_bytes() noexcept(true) {
+            if (m_size != 0x00) {
+                return get<char>();
+            }
+            return -1;
+        }
+
+        /**
+         * Retrieves a `short` value from the internal buffer if available.
+         *
+         * If the buffer is not empty, extracts a `short` value from the current position
+         * and updates the position accordingly.
+         *
+         * @return The extracted `short` value, or -1 if the buffer is empty.
+         */
+        const short get_short() noexcept(true) {
+            if (m_size != 0x00) {
+                return get<short>();
+            }
+            return -1;
+        }
+
+        /**
+         * Retrieves an integer from the internal buffer.
+         *
+         * @return The next integer from the buffer if available, otherwise returns -1.
+         *
+         * This method is marked noexcept and guarantees not to throw exceptions.
+         *
+         * The method reads an integer from the current buffer position indicated by `m_lens`,
+         * increments `m_lens` by the size of an integer, and returns the extracted value.
+         * If `m_size` is zero, indicating that no data is available, the method returns -1.
+         */
+        const int get_int() noexcept(true) {
+            if (m_size != 0x00) {
+                return get<int>();
+            }
+            return -1;
+        }
+
+        /**
+         * Retrieves a 64-bit value from the buffer, as written by `setLong`.
+         *
+         * This function reads an `int64_t` from the buffer starting at the current
+         * position (`m_lens`), updates the current position, and returns the value.
+         * The width is fixed, unlike `long` which is 32-bit on some platforms.
+         * If the buffer is empty (i.e., `m_size` is zero), it returns -1.
+         *
+         * @return The value read from the buffer, or -1 if the buffer is empty.
+         */
+        const int64_t get_long() noexcept(true) {
+            if (m_size != 0x00) {
+                return get<int64_t>();
+            }
+            return -1;
+        }
+
+        /**
+         * Retrieves a `long long` value from the buffer if available.
+         *
+         * This method fetches a `long long` value from the current position within the buffer if the buffer size is non-zero.
+         *
+         * @return The retrieved `long long` value from the buffer, or -1 if the buffer size is zero.
+         */
+        const long long get_llong() noexcept(true) {
+            if (m_size != 0x00) {
+                return get<long long>();
+            }
+            return -1;
+        }
+
+        /**
+         * Retrieves a 16-bit unsigned short from the buffer.
+         *
+         * @return The 16-bit unsigned short value extracted from the buffer.
+         *         If the buffer is empty (m_size is 0), returns `-1`.
+         *
+         * @throws None This function is marked noexcept(true).
+         */
+        const uint16_t get_ushort() noexcept(true) {
+            if (m_size != 0x00) {
+                return get<uint16_t>();
+            }
+            return -1;
+        }
+
+        /**
+         * Retrieves a uint32_t value from the internal buffer.
+         *
+         * @return The next uint32_t value from the buffer if available; otherwise, returns -1.
+         *
+         * @throws noexcept This function is guaranteed not to throw any exceptions.
+         */
+        const uint32_t get_uint() noexcept(true) {
+            if (m_size != 0x00) {
+                return get<uint32_t>();
+            }
+            return -1;
+        }
+
+        /**
+         * Retrieves a uint64_t value from the buffer.
+         *
+         * This function extracts and returns a 64-bit unsigned integer from the
+         * buffer starting at the current lens position and increments the lens
+         * by the size of the uint64_t. If the size is zero, it returns -1.
+         *
+         * @return uint64_t The extracted 64-bit unsigned integer from the buffer.
+         * Returns -1 if the current size is zero.
+         */
+        const uint64_t get_uint64() noexcept(true) {
+            if (m_size != 0x00) {
+                return get<uint64_t>();
+            }
+            return -1;
+        }
+
+        /**
+         * Retrieves a boolean value from the internal buffer.
+         *
+         * @return The boolean value extracted from the buffer if the size is non-zero, otherwise false.
+         */
+        const bool get_bool() noexcept(true) {
+            if (m_size != 0x00) {
+                return get<bool>();
+            }
+            return false;
+        }
+
+        /**
+         * Retrieves a floating-point value from the internal buffer.
+         *
+         * This method reads a `float` from the current position in the buffer,
+         * advances the position by the size of a `float`, and returns the read value.
+         *
+         * @return The `float` value from the buffer if the size is non-zero; otherwise, returns `0.0f`.
+         */
+        const float get_float() noexcept(true) {
+            if (m_size != 0x00) {
+                return get<float>();
+            }
+            return 0.0f;
+        }
+
+        /**
+         * Retrieves a double-precision floating-point number from the buffer.
+         *
+         * This method extracts a double value from the internal buffer at the current
+         * buffer position, updates the position, and returns the extracted value.
+         * If the buffer is empty, it returns 0.0.
+         *
+         * @return The double value extracted from the buffer, or 0.0 if the buffer is empty.
+         */
+        const double get_double() noexcept(true) {
+            if (m_size != 0x00) {
+                return get<double>();
+            }
+            return 0.0;
+        }
+
+        using iterator = uint8_t *;
+
+        iterator begin() noexcept {
+            return m_data;
+        }
+
+        iterator end() noexcept {
+            return m_data + m_lens;
+        }
+
+        /**
+         * Validates the internal buffer to ensure it contains valid data.
+         *
+         * This function checks the consistency and integrity of the internal buffer,
+         * ensuring that the buffer size and current position are within valid ranges.
+         *
+         * @return `true` if the internal buffer data is valid, `false` otherwise.
+         */
+        constexpr bool is_valid() const noexcept {
+            // Ensure the buffer is not null, the size is greater than zero,
+            return m_data != nullptr && m_size != 0x00;
+        }
+
+        /**
+         * Returns a bounds-checked view of the bytes written so far, with its own read position.
+         *
+         * The view covers `[0, lens())`, it is empty for a buffer that was filled by
+         * `io::deserialize`, `io::map`, `attach` or `adopt` and not written to: use `read_view`
+         * to check the bytes of such a buffer. The view is invalidated by any write that grows
+         * the buffer.
+         */
+        read_view_t view() const noexcept {
+            return read_view_t(m_data, m_lens, m_encoding);
+        }
+
+        /**
+         * Returns a bounds-checked view of the bytes not read yet, with its own read position.
+         *
+         * The view covers `[lens(), size())`, i.e. the whole content of a buffer filled by
+         * `io::deserialize`, `io::map`, `attach` or `adopt`. Reads through the view don't move
+         * the position of the buffer. The view is invalidated by any write that grows the buffer.
+         */
+        read_view_t read_view() const noexcept {
+            if (m_lens >= m_size)
+                return read_view_t(nullptr, 0x00, m_encoding);
+            return read_view_t(m_data + m_lens, m_size - m_lens, m_encoding);
+        }
+
+        /**
+         * Writes a whole array of primitives: its length, then every element.
+         *
+         * The buffer is checked and grown once for the whole array, then the elements are
+         * copied with a single memcpy (a vectorized byte swap when the encoding asks for the
+         * other byte order), or packed as varints in one pass in `encoding_t::compact`.
+         *
+         * @param values Any contiguous range (`std::span`, `std::vector`, `std::array`...) of a
+         *               supported non-string type.
+         *
+         * @throws std::runtime_error If the buffer size is exceeded and the buffer can't grow.
+         */
+        template<std::ranges::contiguous_range _range>
+            requires array_like<std::ranges::range_value_t<_range> >
+        void set_array(const _range &values) {
+            using _typename = std::ranges::range_value_t<_range>;
+            const _typename *data = std::ranges::data(values);
+            const size_t count = std::ranges::size(values);
+            insert_length(count);
+            if constexpr (varint_like<_typename>) {
+                if (m_encoding & encoding_t::compact) {
+                    // size exactly only when the worst case does not already fit
+                    if (!is_enough(count * detail::encoded_max<_typename>(m_encoding))) {
+                        uintmax_t size = 0x00;
+                        for (size_t i = 0; i < count; ++i)
+                            size += detail::varint_size(detail::zigzag(data[i]));
+                        if (!is_enough(size))
+                            grow(size);
+                    }
+                    uint8_t *out = m_data + m_lens;
+                    for (size_t i = 0; i < count; ++i)
+                        out = detail::write_varint(out, detail::zigzag(data[i]));
+                    m_lens = out - m_data;
+                    return;
+                }
+            }
+            const uintmax_t size = count * sizeof(_typename);
+            if (size == 0x00)
+                return;
+            if (!is_enough(size))
+                grow(size);
+            if (sizeof(_typename) > 1 && detail::swapped(m_encoding))
+                detail::swap_copy<sizeof(_typename)>(m_data + m_lens, reinterpret_cast<const uint8_t *>(data), count);
+            else _STD memcpy(m_data + m_lens, data, size);
+            m_lens += size;
+        }
+
+        /**
+         * Reads an array written by `set_array` into the given range.
+         *
+         * @param out A contiguous range large enough for the stored elements.
+         *
+         * @throws std::length_error If `out` is too small, the position is then left unchanged.
+         * @throws std::out_of_range If the count or the elements run past the end of the buffer,
+         *         the position is then left unchanged.
+         *
+         * @return The number of elements read.
+         */
+        template<std::ranges::contiguous_range _range>
+            requires array_like<std::ranges::range_value_t<_range> >
+        size_t get_array(_range &&out) {
+            const uintmax_t start = m_lens;
+            size_t count;
+            if (!get_count(count))
+                throw std::out_of_range("array runs past the end of the buffer");
+            if (count > std::ranges::size(out)) {
+                m_lens = start;
+                throw std::length_error("array does not fit the output range");
+            }
+            if (!get_elements(std::ranges::data(out), count)) {
+                m_lens = start;
+                throw std::out_of_range("array runs past the end of the buffer");
+            }
+            return count;
+        }
+
+        /**
+         * Reads an array written by `set_array` into a new vector.
+         *
+         * The stored count is checked against the remaining bytes before the vector is sized,
+         * so a corrupt count can't allocate more than the buffer could hold.
+         *
+         * @throws std::out_of_range If the count or the elements run past the end of the buffer,
+         *         the position is then left unchanged.
+         *
+         * @return The elements read.
+         */
+        template<array_like _typename>
+        std::vector<_typename> get_array() {
+            const uintmax_t start = m_lens;
+            size_t count;
+            if (!get_count(count))
+                throw std::out_of_range("array runs past the end of the buffer");
+            // a varint takes at least one byte
+            const uintmax_t element = varint_like<_typename> && (m_encoding & encoding_t::compact) ? 1 : sizeof(_typename);
+            if (count > unread() / element) {
+                m_lens = start;
+                throw std::out_of_range("array runs past the end of the buffer");
+            }
+            std::vector<_typename> values(count);
+            if constexpr (_STD is_same_v<_typename, bool>) {
+                // std::vector<bool> is packed, unpack it byte by byte
+                for (size_t i = 0; i < values.size(); ++i)
+                    values[i] = m_data[m_lens + i] != 0x00;
+                m_lens += values.size();
+            } else if (!get_elements(values.data(), values.size())) {
+                m_lens = start;
+                throw std::out_of_range("array runs past the end of the buffer");
+            }
+            return values;
+        }
+
+        /**
+         * Writes every field listed in `schema_t<_struct>`, in order.
+         *
+         * In fixed-width encodings the size is computed once, its fixed part at compile time,
+         * the buffer is checked and grown once, then the fields are written without further
+         * checks. `encoding_t::compact` falls back to one write per field.
+         *
+         * @param value The struct to write.
+         *
+         * @throws std::runtime_error If the buffer size is exceeded and the buffer can't grow.
+         */
+        template<described _struct>
+        void set_struct(const _struct &value) {
+            if (m_encoding & encoding_t::compact) {
+                put_fields(value);
+                return;
+            }
+            const uintmax_t size = detail::schema_fixed_size<_struct>() + detail::schema_dynamic_size(value);
+            if (!is_enough(size))
+                grow(size);
+            uint8_t *out = m_data + m_lens;
+            detail::encode_fields(out, value, m_encoding);
+            m_lens = out - m_data;
+        }
+
+        /**
+         * Reads a struct written by `set_struct` into `value`.
+         *
+         * @param value The struct to fill, its strings and vectors are resized to the stored sizes.
+         *
+         * @throws std::out_of_range If the stored struct runs past the end of the buffer, e.g. truncated
+         *         or corrupt input. The position is then left unchanged and `value` may be partly filled.
+         */
+        template<described _struct>
+        void get_struct(_struct &value) {
+            if (m_lens > m_size)
+                throw std::out_of_range("struct runs past the end of the buffer");
+            if (m_encoding & encoding_t::compact) {
+                const uintmax_t start = m_lens;
+                try {
+                    take_fields(value);
+                } catch (...) {
+                    m_lens = start;
+                    throw;
+                }
+                return;
+            }
+            const uint8_t *in = m_data + m_lens;
+            detail::decode_fields(in, m_data + m_size, value, m_encoding);
+            m_lens = in - m_data;
+        }
+
+        template<described _struct>
+        _struct get_struct() {
+            _struct value{};
+            get_struct(value);
+            return value;
+        }
+
+    private:
+        /**
+         * Inserts a value into the internal buffer.
+         *
+         * The type is dispatched at compile time on its `support_t` index, a primitive
+         * write is a bounds check plus a memcpy and a string write does not allocate.
+         *
+         * @param value The value to insert into the buffer, one of the `variant` alternatives.
+         *
+         * @throws std::runtime_error If the buffer size is exceeded during insertion.
+         */
+        template<supported _typename>
+        constexpr void insert(const _typename &value) {
+            const stats::tally_t tally(stats::counter_t::buffer_writes, stats::counter_t::buffer_write_bytes, m_lens);
+            if constexpr (string_like<_typename>) {
+                const std::string_view str = value;
+                const size_t lens = str.size();
+                if (m_encoding & encoding_t::compact) {
+                    insert_varint(lens);
+                    if (!is_enough(lens))
+                        grow(lens);
+                } else {
+                    if (!is_enough(sizeof(uint64_t) + lens))
+                        grow(sizeof(uint64_t) + lens);
+                    insert_fixed<uint64_t>(lens);
+                }
+                _STD memcpy(m_data + m_lens, str.data(), lens);
+                m_lens += lens;
+            } else if constexpr (varint_like<_typename>) {
+                if (m_encoding & encoding_t::compact) {
+                    insert_varint(detail::zigzag(value));
+                    return;
+                }
+                insert_fixed(value);
+            } else insert_fixed(value);
+        }
+
+        // a fixed-width value in the byte order of the encoding, a plain memcpy on matching hosts
+        template<class _typename>
+        void insert_fixed(const _typename &value) {
+            if (!is_enough(sizeof(_typename)))
+                grow(sizeof(_typename));
+            const _typename wire = detail::wire_order(value, m_encoding);
+            _STD memcpy(m_data + m_lens, &wire, sizeof(_typename));
+            m_lens += sizeof(_typename);
+        }
+
+        template<class _typename>
+        _typename get_fixed() noexcept {
+            _typename value;
+            _STD memcpy(&value, m_data + m_lens, sizeof(_typename));
+            m_lens += sizeof(_typename);
+            return detail::wire_order(value, m_encoding);
+        }
+
+        // field by field path of set_struct / get_struct, for variable-width encodings
+        template<described _struct>
+        void put_fields(const _struct &value) {
+            [&]<size_t... _index>(std::index_sequence<_index...>) {
+                (put_field(detail::field<const _struct, _index>(value)), ...);
+            }(std::make_index_sequence<detail::field_count<_struct> >());
+        }
+
+        template<class _field>
+        void put_field(const _field &member) {
+            if constexpr (described<_field>)
+                put_fields(member);
+            else if constexpr (varint_like<_field>)
+                insert_varint(detail::zigzag(member));
+            else if constexpr (detail::raw_field<_field>)
+                insert_fixed(member);
+            else if constexpr (std::is_same_v<_field, std::string>)
+                insert(std::string_view(member));
+            else set_array(member);
+        }
+
+        template<described _struct>
+        void take_fields(_struct &value) {
+            [&]<size_t... _index>(std::index_sequence<_index...>) {
+                (take_field(detail::field<_struct, _index>(value)), ...);
+            }(std::make_index_sequence<detail::field_count<_struct> >());
+        }
+
+        // every varint, length and count is checked against the end of the buffer before it is used
+        template<class _field>
+        void take_field(_field &member) {
+            if constexpr (described<_field>)
+                take_fields(member);
+            else if constexpr (varint_like<_field>)
+                member = detail::unzigzag<_field>(take_varint());
+            else if constexpr (detail::raw_field<_field>) {
+                take_check(sizeof(_field));
+                member = get_fixed<_field>();
+            } else if constexpr (std::is_same_v<_field, std::string>) {
+                const uint64_t size = take_varint();
+                take_check(size);
+                member.assign(reinterpret_cast<const char *>(m_data) + m_lens, size);
+                m_lens += size;
+            } else {
+                using _element = typename _field::value_type;
+                const uint64_t count = take_varint();
+                if constexpr (varint_like<_element>) {
+                    take_check(count); // at least one byte per element
+                    member.resize(count);
+                    for (_element &element: member)
+                        element = detail::unzigzag<_element>(take_varint());
+                } else {
+                    if (count > (m_size - m_lens) / sizeof(_element))
+                        throw std::out_of_range("struct runs past the end of the buffer");
+                    member.resize(count);
+                    get_elements(member.data(), count);
+                }
+            }
+        }
+
+        // reads a varint that may be cut short by the end of the buffer
+        uint64_t take_varint() {
+            uint64_t value = 0x00;
+            for (uintmax_t at = m_lens, shift = 0; at < m_size && shift < 64; ++at, shift += 7) {
+                value |= uint64_t(m_data[at] & 0x7f) << shift;
+                if (!(m_data[at] & 0x80)) {
+                    m_lens = at + 1;
+                    return value;
+                }
+            }
+            throw std::out_of_range("struct runs past the end of the buffer");
+        }
+
+        void take_check(const uint64_t &size) const {
+            if (size > m_size - m_lens)
+                throw std::out_of_range("struct runs past the end of the buffer");
+        }
+
+        void insert_varint(const uint64_t &value) {
+            const uintmax_t size = detail::varint_size(value);
+            if (!is_enough(size))
+                grow(size);
+            detail::write_varint(m_data + m_lens, value);
+            m_lens += size;
+        }
+
+        uint64_t get_varint() noexcept {
+            const uint8_t *in = m_data + m_lens;
+            const uint64_t value = detail::read_varint(in);
+            m_lens = in - m_data;
+            return value;
+        }
+
+        // bytes left to read, zero once the position went past the end
+        constexpr uintmax_t unread() const noexcept {
+            return m_lens < m_size ? m_size - m_lens : 0x00;
+        }
+
+        // reads the length prefix of an array, `false` if it runs past the end of the buffer
+        bool get_count(size_t &count) noexcept {
+            if (m_encoding & encoding_t::compact) {
+                const uint8_t *in = m_data + m_lens;
+                uint64_t value;
+                if (m_lens >= m_size || !detail::read_varint(in, m_data + m_size, value))
+                    return false;
+                m_lens = in - m_data;
+                count = static_cast<size_t>(value);
+                return true;
+            }
+            if (unread() < sizeof(uint64_t))
+                return false;
+            count = static_cast<size_t>(get_fixed<uint64_t>());
+            return true;
+        }
+
+        /**
+         * Decodes `count` elements of an array whose length prefix was already read.
+         *
+         * @return `false` if the elements run past the end of the buffer, the position is then left unchanged.
+         */
+        template<array_like _typename>
+        bool get_elements(_typename *out, const size_t &count) noexcept {
+            if constexpr (varint_like<_typename>) {
+                if (m_encoding & encoding_t::compact) {
+                    const uint8_t *in = m_data + m_lens;
+                    if (count > unread())
+                        return false;
+                    if (unread() / 10 >= count) {
+                        // the longest varints fit, no check per byte
+                        for (size_t i = 0; i < count; ++i)
+                            out[i] = detail::unzigzag<_typename>(detail::read_varint(in));
+                    } else {
+                        uint64_t value;
+                        for (size_t i = 0; i < count; ++i) {
+                            if (!detail::read_varint(in, m_data + m_size, value))
+                                return false;
+                            out[i] = detail::unzigzag<_typename>(value);
+                        }
+                    }
+                    m_lens = in - m_data;
+                    return true;
+                }
+            }
+            if (count > unread() / sizeof(_typename))
+                return false;
+            if (count == 0x00)
+                return true;
+            if (sizeof(_typename) > 1 && detail::swapped(m_encoding))
+                detail::swap_copy<sizeof(_typename)>(reinterpret_cast<uint8_t *>(out), m_data + m_lens, count);
+            else _STD memcpy(out, m_data + m_lens, count * sizeof(_typename));
+            m_lens += count * sizeof(_typename);
+            return true;
+        }
+
+        // writes the length prefix of a string or array, a uint64_t or a varint depending on the encoding
+        void insert_length(const size_t &lens) {
+            if (m_encoding & encoding_t::compact) {
+                insert_varint(lens);
+                return;
+            }
+            insert_fixed<uint64_t>(lens);
+        }
+
+        size_t get_length() noexcept {
+            if (m_encoding & encoding_t::compact)
+                return static_cast<size_t>(get_varint());
+            return static_cast<size_t>(get_fixed<uint64_t>());
+        }
+
+        /**
+         * Makes room for `size` more bytes, called only when `is_enough` failed.
+         *
+         * A `policy_t::growable` buffer at least doubles its capacity, so a sequence of
+         * appends costs amortized O(1). A `policy_t::fixed` buffer throws instead.
+         *
+         * @throws std::runtime_error If the buffer is not growable.
+         */
+        void grow(const uintmax_t &size) {
+            if (m_policy != policy_t::growable) {
+                stats::add(stats::counter_t::buffer_overflows);
+                throw std::runtime_error("maximum buffer size exceeded");
+            }
+            uintmax_t capacity = m_size < 0x40 ? 0x40 : m_size;
+            while (capacity < m_lens + size)
+                capacity *= 2;
+            const stats::timer_t timer(stats::histogram_t::buffer_resize);
+            stats::add(stats::counter_t::buffer_resizes);
+            resize(capacity);
+        }
+
+    public:
+        constexpr uint8_t *data() noexcept {
+            return m_data;
+        }
+
+        constexpr uintmax_t size() noexcept { return m_size; }
+        _allocator get_allocator() const noexcept { return buffer.get_allocator(); }
+        constexpr uintmax_t lens() noexcept { return m_lens; }
+
+    private:
+        std::vector<uint8_t, _allocator> buffer; // main data to store value
+        uint8_t *m_data = nullptr; // active storage, buffer.data() or attached memory
+        std::shared_ptr<void> m_storage; // keeps attached memory alive, empty when buffer is used
+    private:
+        uintmax_t m_size = 0x00; // size of memory allocation / reallocation
+        uintmax_t m_lens = 0x00; // tracker of memory position
+        int m_policy = policy_t::fixed; // behaviour once m_size is exceeded
+        int m_encoding = encoding_t::fixed; // wire layout of the values
+
+        friend class io::stream_writer_t;
+        friend class io::stream_reader_t;
+        template<class> friend class basic_buffer_pool_t;
+    };
+
+    using wmemory_t = basic_wmemory_t<>;
+    // buffer whose storage comes from a std::pmr::memory_resource, e.g. `pmr_wmemory_t buffer(0x100, &arena)`
+    using pmr_wmemory_t = basic_wmemory_t<std::pmr::polymorphic_allocator<uint8_t> >;
+
+    /**
+     * Pool of recyclable `basic_wmemory_t` buffers with pre-reserved capacity.
+     *
+     * `acquire()` hands out a buffer through an RAII `handle_t`, which gives it back when it
+     * goes out of scope; the buffer is rewound and keeps its storage, so a pool hit costs
+     * neither an allocation nor a pass over the bytes. The bytes of its last use are still
+     * there, unlike in a freshly constructed buffer. A pool is meant
+     * to be used by one thread (see `local()`), but handles may be released from any thread:
+     * those buffers go through a lock-free return list that the owner drains when it runs out.
+     */
+    template<class _allocator = std::allocator<uint8_t> >
+    class basic_buffer_pool_t {
+    public:
+        using buffer_type = basic_wmemory_t<_allocator>;
+
+    private:
+        struct entry_t {
+            buffer_type buffer;
+            entry_t *next = nullptr;
+        };
+
+        struct state_t {
+            std::thread::id owner; // thread allowed to touch `idle`
+            std::vector<entry_t *> idle; // buffers ready to be handed out
+            std::atomic<entry_t *> remote{nullptr}; // buffers returned by other threads
+            std::atomic<uint64_t> hits{0}, misses{0};
+            uintmax_t capacity = 0x00;
+            int policy = policy_t::growable;
+            size_t limit = 0x00; // idle buffers kept at most, extra ones are freed
+
+            ~state_t() {
+                for (entry_t *entry: idle)
+                    delete entry;
+                for (entry_t *entry = remote.load(std::memory_order_acquire); entry != nullptr;) {
+                    entry_t *next = entry->next;
+                    delete entry;
+                    entry = next;
+                }
+            }
+
+            void give_back(entry_t *entry) {
+                buffer_type &buffer = entry->buffer;
+                if (buffer.m_data != buffer.buffer.data())
+                    buffer.cleanup(); // attached memory isn't ours to keep
+                else buffer.rewind();
+                buffer.set_encoding(encoding_t::fixed);
+                if (std::this_thread::get_id() == owner) {
+                    if (idle.size() < limit)
+                        idle.push_back(entry);
+                    else
+                        delete entry;
+                    return;
+                }
+                entry->next = remote.load(std::memory_order_relaxed);
+                while (!remote.compare_exchange_weak(entry->next, entry, std::memory_order_release,
+                                                     std::memory_order_relaxed)) {
+                }
+            }
+        };
+
+    public:
+        // RAII access to a pooled buffer, returns it to its pool on destruction
+        class handle_t {
+        public:
+            handle_t() noexcept = default;
+
+            handle_t(handle_t &&next) noexcept
+                : m_state(std::move(next.m_state)), m_entry(std::exchange(next.m_entry, nullptr)) {
+            }
+
+            handle_t &operator=(handle_t &&next) noexcept {
+                if (this != &next) {
+                    reset();
+                    m_state = std::move(next.m_state);
+                    m_entry = std::exchange(next.m_entry, nullptr);
+                }
+                return *this;
+            }
+
+            handle_t(const handle_t &) = delete;
+
+            handle_t &operator=(const handle_t &) = delete;
+
+            ~handle_t() {
+                reset();
+            }
+
+            // gives the buffer back to its pool early
+            void reset() noexcept {
+                if (m_entry != nullptr) {
+                    m_state->give_back(m_entry);
+                    m_entry = nullptr;
+                }
+                m_state.reset();
+            }
+
+            buffer_type *get() const noexcept { return &m_entry->buffer; }
+            buffer_type *operator->() const noexcept { return &m_entry->buffer; }
+            buffer_type &operator*() const noexcept { return m_entry->buffer; }
+            explicit operator bool() const noexcept { return m_entry != nullptr; }
+
+        private:
+            friend class basic_buffer_pool_t;
+
+            handle_t(std::shared_ptr<state_t> state, entry_t *entry) noexcept
+                : m_state(std::move(state)), m_entry(entry) {
+            }
+
+            std::shared_ptr<state_t> m_state; // keeps the pool alive while the buffer is out
+            entry_t *m_entry = nullptr;
+        };
+
+        /**
+         * Creates a pool owned by the calling thread.
+         *
+         * @param capacity The size reserved in every buffer handed out. Must be greater than zero.
+         * @param policy The `policy_t` of the buffers handed out.
+         * @param limit The number of idle buffers kept for reuse.
+         * @param alloc The allocator of the buffers storage.
+         *
+         * @throws std::invalid_argument If the capacity is zero.
+         */
+        explicit basic_buffer_pool_t(const uintmax_t &capacity, const int &policy = policy_t::growable,
+                                     const size_t &limit = 0x40, const _allocator &alloc = _allocator())
+            : m_state(std::make_shared<state_t>()), m_alloc(alloc) {
+            if (capacity <= 0x00)
+                throw std::invalid_argument("capacity must be greater than zero");
+            m_state->owner = std::this_thread::get_id();
+            m_state->capacity = capacity, m_state->policy = policy, m_state->limit = limit;
+            m_state->idle.reserve(limit);
+        }
+
+        basic_buffer_pool_t(const basic_buffer_pool_t &) = delete;
+
+        basic_buffer_pool_t &operator=(const basic_buffer_pool_t &) = delete;
+
+        /**
+         * Hands out an empty buffer with at least `capacity` bytes reserved.
+         *
+         * Must be called from the thread that owns the pool.
+         */
+        handle_t acquire() {
+            state_t &state = *m_state;
+            if (state.idle.empty())
+                drain();
+            entry_t *entry;
+            if (!state.idle.empty()) {
+                entry = state.idle.back();
+                state.idle.pop_back();
+                state.hits.fetch_add(1, std::memory_order_relaxed);
+            } else {
+                entry = new entry_t{buffer_type(nullptr, m_alloc)};
+                state.misses.fetch_add(1, std::memory_order_relaxed);
+            }
+            if (entry->buffer.size() < state.capacity)
+                entry->buffer.reserve(state.capacity);
+            entry->buffer.set_policy(state.policy);
+            return handle_t(m_state, entry);
+        }
+
+        // buffers handed out from the idle list
+        uint64_t hits() const noexcept { return m_state->hits.load(std::memory_order_relaxed); }
+
+        // buffers that had to be allocated
+        uint64_t misses() const noexcept { return m_state->misses.load(std::memory_order_relaxed); }
+
+        // buffers waiting in the idle list, not counting unclaimed returns from other threads
+        size_t idle() const noexcept { return m_state->idle.size(); }
+
+        /**
+         * The calling thread's own pool, created on first use with `capacity`.
+         */
+        static basic_buffer_pool_t &local(const uintmax_t &capacity = 0x1000) {
+            thread_local basic_buffer_pool_t pool(capacity);
+            return pool;
+        }
+
+    private:
+        // moves the buffers returned by other threads to the idle list
+        void drain() {
+            state_t &state = *m_state;
+            entry_t *entry = state.remote.exchange(nullptr, std::memory_order_acquire);
+            while (entry != nullptr) {
+                entry_t *next = entry->next;
+                if (state.idle.size() < state.limit)
+                    state.idle.push_back(entry);
+                else
+                    delete entry;
+                entry = next;
+            }
+        }
+
+    private:
+        std::shared_ptr<state_t> m_state; // shared with the handles
+        _allocator m_alloc; // allocator of new buffers
+    };
+
+    using buffer_pool_t = basic_buffer_pool_t<>;
+
+    /**
+     * LZ4-style block codec, self-contained and byte-compatible with the LZ4 block format.
+     *
+     * A block is a run of sequences: a token (literal count, match length), the literals, then
+     * a 16-bit little-endian offset back into the bytes already decoded and the match length
+     * extension. Blocks are independent, so they can be decoded in any order and in parallel.
+     */
+    namespace lz {
+        namespace detail {
+            constexpr int hash_log = 12;
+            constexpr uintmax_t min_match = 4;
+            constexpr uintmax_t last_literals = 5; // the block always ends with at least that many literals
+            constexpr uintmax_t match_margin = 12; // no match starts in the last bytes of the block
+            constexpr uintmax_t max_offset = 0xFFFF;
+
+            inline uint32_t load32(const uint8_t *data) noexcept {
+                uint32_t value;
+                _STD memcpy(&value, data, sizeof(value));
+                return value;
+            }
+
+            inline uint64_t load64(const uint8_t *data) noexcept {
+                uint64_t value;
+                _STD memcpy(&value, data, sizeof(value));
+                return value;
+            }
+
+            inline uint32_t hash(const uint32_t &sequence) noexcept {
+                return (sequence * 2654435761u) >> (32 - hash_log);
+            }
+
+            // writes the 255-byte continuation of a length that didn't fit in its token nibble
+            inline uint8_t *write_length(uint8_t *out, uintmax_t length) noexcept {
+                for (; length >= 0xFF; length -= 0xFF)
+                    *out++ = 0xFF;
+                *out++ = static_cast<uint8_t>(length);
+                return out;
+            }
+
+            // reads a length continuation, `false` if it runs past the input
+            inline bool read_length(const uint8_t *&in, const uint8_t *end, uintmax_t &length) noexcept {
+                uint8_t byte;
+                do {
+                    if (in >= end)
+                        return false;
+                    byte = *in++;
+                    length += byte;
+                } while (byte == 0xFF);
+                return true;
+            }
+
+            // number of equal bytes at `a` and `b`, not looking at or past `limit`
+            inline uintmax_t common(const uint8_t *a, const uint8_t *b, const uint8_t *limit) noexcept {
+                const uint8_t *start = a;
+                while (a + sizeof(uint64_t) <= limit) {
+                    const uint64_t diff = load64(a) ^ load64(b);
+                    if (diff != 0x00) {
+                        if constexpr (std::endian::native == std::endian::little)
+                            return a - start + (std::countr_zero(diff) >> 3);
+                        else return a - start + (std::countl_zero(diff) >> 3);
+                    }
+                    a += sizeof(uint64_t), b += sizeof(uint64_t);
+                }
+                while (a < limit && *a == *b)
+                    ++a, ++b;
+                return a - start;
+            }
+
+            inline uint8_t *write_sequence(uint8_t *out, const uint8_t *literals, const uintmax_t &count) noexcept {
+                uint8_t *token = out++;
+                if (count >= 0x0F) {
+                    *token = 0xF0;
+                    out = write_length(out, count - 0x0F);
+                } else *token = static_cast<uint8_t>(count << 4);
+                if (count != 0x00)
+                    _STD memcpy(out, literals, count);
+                return out + count;
+            }
+        }
+
+        /**
+         * Largest compressed size of `size` bytes, the capacity `compress` needs.
+         */
+        constexpr uintmax_t bound(const uintmax_t &size) noexcept {
+            return size + size / 0xFF + 0x10;
+        }
+
+        /**
+         * Compresses one block.
+         *
+         * @param in The bytes to compress.
+         * @param size The number of bytes to compress, up to 2 GB.
+         * @param out Receives the compressed block, must hold `bound(size)` bytes.
+         *
+         * @return The compressed size, which can exceed `size` for incompressible data.
+         */
+        inline uintmax_t compress(const uint8_t *in, const uintmax_t &size, uint8_t *out) noexcept {
+            using namespace detail;
+            const uint8_t *anchor = in, *const end = in + size;
+            uint8_t *op = out;
+            if (size > match_margin) {
+                uint32_t table[1 << hash_log] = {}; // position of the last sequence with a given hash
+                const uint8_t *const limit = end - match_margin, *const match_limit = end - last_literals;
+                const uint8_t *ip = in + 1;
+                while (ip < limit) {
+                    const uint32_t sequence = load32(ip);
+                    uint32_t &slot = table[hash(sequence)];
+                    const uint8_t *ref = in + slot;
+                    slot = static_cast<uint32_t>(ip - in);
+                    if (uintmax_t(ip - ref) > max_offset || load32(ref) != sequence) {
+                        // skip faster through data that doesn't match
+                        ip += 1 + ((ip - anchor) >> 6);
+                        continue;
+                    }
+                    while (ip > anchor && ref > in && ip[-1] == ref[-1])
+                        --ip, --ref;
+                    const uintmax_t length = min_match + common(ip + min_match, ref + min_match, match_limit);
+
+                    // sequence: literals since the last match, then the match
+                    uint8_t *token = op;
+                    op = write_sequence(op, anchor, ip - anchor);
+                    const uint16_t offset = static_cast<uint16_t>(ip - ref);
+                    *op++ = static_cast<uint8_t>(offset);
+                    *op++ = static_cast<uint8_t>(offset >> 8);
+                    if (length - min_match >= 0x0F) {
+                        *token |= 0x0F;
+                        op = write_length(op, length - min_match - 0x0F);
+                    } else *token |= static_cast<uint8_t>(length - min_match);
+
+                    ip += length, anchor = ip;
+                    if (ip < limit)
+                        table[hash(load32(ip - 2))] = static_cast<uint32_t>(ip - 2 - in);
+                }
+            }
+            return write_sequence(op, anchor, end - anchor) - out;
+        }
+
+        /**
+         * Decompresses one block, checking every length and offset against both buffers.
+         *
+         * @param in The compressed block.
+         * @param size The size of the compressed block.
+         * @param out Receives the decompressed bytes.
+         * @param capacity The exact decompressed size of the block.
+         *
+         * @return `false` if the block is corrupted or doesn't decompress to exactly `capacity` bytes.
+         */
+        inline bool decompress(const uint8_t *in, const uintmax_t &size, uint8_t *out, const uintmax_t &capacity) noexcept {
+            using namespace detail;
+            const uint8_t *ip = in, *const iend = in + size;
+            uint8_t *op = out, *const oend = out + capacity;
+            while (ip < iend) {
+                const uint8_t token = *ip++;
+                uintmax_t literals = token >> 4;
+                if (literals != 0x0F && iend - ip >= 0x10 && oend - op >= 0x10) {
+                    // short literals, copied with one fixed-size move
+                    _STD memcpy(op, ip, 0x10);
+                } else {
+                    if (literals == 0x0F && !read_length(ip, iend, literals))
+                        return false;
+                    if (literals > uintmax_t(iend - ip) || literals > uintmax_t(oend - op))
+                        return false;
+                    if (literals != 0x00)
+                        _STD memcpy(op, ip, literals);
+                }
+                op += literals, ip += literals;
+                if (ip == iend)
+                    return op == oend; // the last sequence has no match
+
+                if (iend - ip < 2)
+                    return false;
+                const uintmax_t offset = ip[0] | uintmax_t(ip[1]) << 8;
+                ip += 2;
+                uintmax_t length = token & 0x0F;
+                if (length == 0x0F && !read_length(ip, iend, length))
+                    return false;
+                length += min_match;
+                if (offset == 0x00 || offset > uintmax_t(op - out) || length > uintmax_t(oend - op))
+                    return false;
+                const uint8_t *ref = op - offset;
+                uint8_t *const stop = op + length;
+                if (offset >= sizeof(uint64_t) && uintmax_t(oend - stop) >= sizeof(uint64_t)) {
+                    // 8 bytes at a time, a chunk never overlaps the bytes it is copied from
+                    for (; op < stop; op += sizeof(uint64_t), ref += sizeof(uint64_t))
+                        _STD memcpy(op, ref, sizeof(uint64_t));
+                } else {
+                    for (; op < stop; ++op, ++ref)
+                        *op = *ref;
+                }
+                op = stop;
+            }
+            return false;
+        }
+    }
+
+    namespace io {
+        /**
+         * Deserializes data from a binary file and stores it into the specified `wmemory_t` buffer.
+         *
+         * The file is read straight into the buffer storage, without an intermediate copy.
+         *
+         * @param buffer A pointer to the `wmemory_t` object where the deserialized data will be stored.
+         * @param filename The name of the binary file to read the data from.
+         *
+         * @throws std::runtime_error If the file cannot be opened.
+         */
+        template<class _allocator>
+        void deserialize(basic_wmemory_t<_allocator> *buffer, const char *filename) {
+            std::ifstream file(filename, std::ios::binary);
+            if (file.is_open()) {
+                file.seekg(0x0, std::ios::end);
+                std::streamsize size = file.tellg();
+                file.seekg(0x0, std::ios::beg);
+                if (size <= 0x0)
+                    throw std::invalid_argument("data is null or size is negative");
+                buffer->cleanup();
+                buffer->resize(size);
+                {
+                    const stats::timer_t timer(stats::histogram_t::io_read);
+                    file.read(reinterpret_cast<char *>(buffer->data()), size);
+                }
+                stats::add(stats::counter_t::io_reads);
+                stats::add(stats::counter_t::io_read_bytes, file.gcount());
+                if (file.gcount() != size)
+                    stats::add(stats::counter_t::io_errors);
+                file.close();
+            } else throw std::runtime_error("failed to open file");
+        }
+
+        // class to define the access pattern hinted to the kernel for a mapped file
+        class advice_t {
+        public:
+            static constexpr int normal = 0x0;
+            static constexpr int sequential = 0x1; // read ahead aggressively, drop pages behind
+            static constexpr int random = 0x2; // don't read ahead
+            static constexpr int willneed = 0x4; // start paging in the whole file now
+        };
+
+        // class to define how a vectored io::serialize reaches the file
+        class output_t {
+        public:
+            static constexpr int buffered = 0x0; // writev through the page cache, the default behaviour
+            static constexpr int direct = 0x1; // O_DIRECT in aligned blocks for large dumps, buffered where unsupported
+        };
+
+        /**
+         * Read-only view of a whole file mapped into memory.
+         *
+         * Pages are loaded lazily by the kernel on first access. On platforms without
+         * `mmap` the file is read into memory instead.
+         */
+        class mapped_file_t {
+        public:
+            /**
+             * Maps the given file.
+             *
+             * @param filename The name of the file to map.
+             *
+             * @throws std::runtime_error If the file cannot be opened, is empty or can't be mapped.
+             */
+            explicit mapped_file_t(const char *filename) {
+#ifdef __SERIALIZER_POSIX__
+                const int fd = ::open(filename, O_RDONLY);
+                if (fd < 0)
+                    throw std::runtime_error("failed to open file");
+                struct stat st {};
+                if (::fstat(fd, &st) != 0 || st.st_size <= 0) {
+                    ::close(fd);
+                    throw std::runtime_error("failed to map an empty file");
+                }
+                m_size = static_cast<uintmax_t>(st.st_size);
+                // private and writable, so writing into the buffer copies the page instead of
+                // touching the file or faulting
+                void *data = ::mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+                ::close(fd);
+                if (data == MAP_FAILED)
+                    throw std::runtime_error("failed to map file");
+                m_data = static_cast<uint8_t *>(data);
+#else
+                std::ifstream file(filename, std::ios::binary);
+                if (!file.is_open())
+                    throw std::runtime_error("failed to open file");
+                file.seekg(0x0, std::ios::end);
+                const std::streamsize size = file.tellg();
+                file.seekg(0x0, std::ios::beg);
+                if (size <= 0x0)
+                    throw std::runtime_error("failed to map an empty file");
+                m_fallback.resize(size);
+                file.read(reinterpret_cast<char *>(m_fallback.data()), size);
+                m_data = m_fallback.data(), m_size = static_cast<uintmax_t>(size);
+#endif
+            }
+
+            ~mapped_file_t() {
+#ifdef __SERIALIZER_POSIX__
+                if (m_data)
+                    ::munmap(m_data, m_size);
+#endif
+                m_data = nullptr, m_size = 0;
+            }
+
+            mapped_file_t(const mapped_file_t &) = delete;
+
+            mapped_file_t &operator=(const mapped_file_t &) = delete;
+
+            /**
+             * Hints the kernel about the upcoming access pattern, a no-op without `madvise`.
+             *
+             * @param advice A combination of `advice_t` flags.
+             */
+            void advise(const int &advice) const noexcept {
+#ifdef __SERIALIZER_POSIX__
+                if (advice & advice_t::sequential)
+                    ::madvise(m_data, m_size, MADV_SEQUENTIAL);
+                if (advice & advice_t::random)
+                    ::madvise(m_data, m_size, MADV_RANDOM);
+                if (advice & advice_t::willneed)
+                    ::madvise(m_data, m_size, MADV_WILLNEED);
+#endif
+            }
+
+            constexpr uint8_t *data() const noexcept { return m_data; }
+            constexpr uintmax_t size() const noexcept { return m_size; }
+
+        private:
+            uint8_t *m_data = nullptr; // start of the mapping
+            uintmax_t m_size = 0x00; // size of the mapped file
+#ifndef __SERIALIZER_POSIX__
+            std::vector<uint8_t> m_fallback; // file content when mmap is not available
+#endif
+        };
+
+        /**
+         * Maps a binary file and attaches it to the specified `wmemory_t` buffer without copying.
+         *
+         * `get_X` calls then read straight from the mapping, which stays alive for as long
+         * as the buffer uses it. Writing into the buffer never modifies the file.
+         *
+         * @param buffer A pointer to the `wmemory_t` object the file is attached to.
+         * @param filename The name of the binary file to map.
+         * @param advice A combination of `advice_t` flags describing how the buffer will be read.
+         *
+         * @throws std::runtime_error If the file cannot be opened, is empty or can't be mapped.
+         */
+        template<class _allocator>
+        void map(basic_wmemory_t<_allocator> *buffer, const char *filename, const int &advice = advice_t::normal) {
+            std::shared_ptr<mapped_file_t> file = std::make_shared<mapped_file_t>(filename);
+            file->advise(advice);
+            uint8_t *data = file->data();
+            const uintmax_t size = file->size();
+            buffer->attach(data, size, std::move(file));
+        }
+
+        namespace detail {
+            inline int open_write(const char *filename) {
+#if _MSC_VER
+                return ::_open(filename, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, 0644);
+#else
+                return ::open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+            }
+
+            inline int open_read(const char *filename) {
+#if _MSC_VER
+                return ::_open(filename, _O_RDONLY | _O_BINARY);
+#else
+                return ::open(filename, O_RDONLY);
+#endif
+            }
+
+            inline bool close(const int &fd) {
+#if _MSC_VER
+                return ::_close(fd) == 0;
+#else
+                return ::close(fd) == 0;
+#endif
+            }
+
+            // flushes the file content, and the metadata needed to read it back, to the device
+            inline bool sync_data(const int &fd) {
+#if _MSC_VER
+                return ::_commit(fd) == 0;
+#elif defined(__APPLE__)
+                return ::fcntl(fd, F_FULLFSYNC) == 0 || ::fsync(fd) == 0;
+#else
+                while (::fdatasync(fd) != 0)
+                    if (errno != EINTR)
+                        return false;
+                return true;
+#endif
+            }
+
+            // makes the entries just renamed in `directory` durable, a no-op where directories can't be synced
+            inline bool sync_directory(const std::filesystem::path &directory) {
+#ifdef __SERIALIZER_POSIX__
+                const int fd = ::open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY);
+                if (fd < 0)
+                    return false;
+                const bool synced = ::fsync(fd) == 0;
+                return ::close(fd) == 0 && synced;
+#else
+                (void) directory;
+                return true;
+#endif
+            }
+
+            // writes all `size` bytes, retrying on partial writes and EINTR
+            inline void write_all(const int &fd, const uint8_t *data, uintmax_t size) {
+                while (size > 0x00) {
+                    const stats::timer_t timer(stats::histogram_t::io_write);
+                    stats::add(stats::counter_t::io_writes);
+#if _MSC_VER
+                    const int count = ::_write(fd, data, static_cast<unsigned>(size < 0x40000000 ? size : 0x40000000));
+#else
+                    const ssize_t count = ::write(fd, data, size);
+#endif
+                    if (count < 0) {
+                        if (errno == EINTR)
+                            continue;
+                        stats::add(stats::counter_t::io_errors);
+                        throw std::runtime_error("failed to write file");
+                    }
+                    stats::add(stats::counter_t::io_write_bytes, count);
+                    data += count, size -= count;
+                }
+            }
+
+#ifdef __SERIALIZER_POSIX__
+            // writes every iovec, advancing through them on partial writes and retrying on EINTR
+            inline void writev_all(const int &fd, iovec *vectors, size_t count) {
+                while (count > 0x00) {
+                    const stats::timer_t timer(stats::histogram_t::io_write);
+                    stats::add(stats::counter_t::io_writes);
+                    const ssize_t written = ::writev(fd, vectors, static_cast<int>(count));
+                    if (written < 0) {
+                        if (errno == EINTR)
+                            continue;
+                        stats::add(stats::counter_t::io_errors);
+                        throw std::runtime_error("failed to write file");
+                    }
+                    stats::add(stats::counter_t::io_write_bytes, written);
+                    uintmax_t left = written;
+                    while (count > 0x00 && left >= vectors->iov_len)
+                        left -= vectors->iov_len, ++vectors, --count;
+                    if (count > 0x00) {
+                        vectors->iov_base = static_cast<uint8_t *>(vectors->iov_base) + left;
+                        vectors->iov_len -= left;
+                    }
+                }
+            }
+#endif
+
+            /**
+             * Writes every part in order with as few `writev` calls as possible.
+             *
+             * Large parts are handed to the kernel as they are. Parts under 2 KB are gathered in a
+             * staging block first, copying them is cheaper than one iovec each.
+             */
+            inline void write_parts(const int &fd, const std::span<const std::span<const uint8_t> > &parts) {
+#ifdef __SERIALIZER_POSIX__
+                constexpr size_t batch = 0x400; // IOV_MAX on Linux and macOS
+                constexpr uintmax_t small = 0x800, capacity = 0x40000;
+                iovec vectors[batch];
+                std::unique_ptr<uint8_t[]> staging;
+                size_t count = 0x00;
+                uintmax_t fill = 0x00, sealed = 0x00; // staged bytes, and those already in an iovec
+                const auto seal = [&] {
+                    if (fill > sealed)
+                        vectors[count++] = {staging.get() + sealed, fill - sealed}, sealed = fill;
+                };
+                const auto flush = [&] {
+                    seal();
+                    writev_all(fd, vectors, count);
+                    count = 0x00, fill = 0x00, sealed = 0x00;
+                };
+                for (const std::span<const uint8_t> &part: parts) {
+                    if (part.empty())
+                        continue;
+                    if (part.size() < small) {
+                        if (!staging)
+                            staging = std::make_unique_for_overwrite<uint8_t[]>(capacity);
+                        if (fill + part.size() > capacity)
+                            flush();
+                        _STD memcpy(staging.get() + fill, part.data(), part.size());
+                        fill += part.size();
+                        continue;
+                    }
+                    // room for the staged bytes, this part, and a later seal
+                    if (count + 3 > batch)
+                        flush();
+                    seal();
+                    vectors[count++] = {const_cast<uint8_t *>(part.data()), part.size()};
+                }
+                flush();
+#else
+                for (const std::span<const uint8_t> &part: parts)
+                    write_all(fd, part.data(), part.size());
+#endif
+            }
+
+            /**
+             * Writes the parts into `filename` with O_DIRECT, bypassing the page cache.
+             *
+             * Block-aligned runs of a part go straight to the file, the rest is gathered in an
+             * aligned staging buffer. The last block is padded, then the file is truncated to
+             * its real size.
+             *
+             * @return `false` if the file can't be opened with O_DIRECT, nothing is written then.
+             */
+            inline bool write_direct(const char *filename, const std::span<const std::span<const uint8_t> > &parts) {
+#if defined(O_DIRECT)
+                constexpr uintmax_t block = 0x1000, capacity = 0x100000;
+                const int fd = ::open(filename, O_WRONLY | O_CREAT | O_TRUNC | O_DIRECT, 0644);
+                if (fd < 0)
+                    return false;
+                const std::unique_ptr<uint8_t, void (*)(void *)> staging(
+                    static_cast<uint8_t *>(std::aligned_alloc(block, capacity)), std::free);
+                try {
+                    if (!staging)
+                        throw std::bad_alloc();
+                    uintmax_t fill = 0x00, total = 0x00;
+                    for (const std::span<const uint8_t> &part: parts) {
+                        const uint8_t *data = part.data();
+                        uintmax_t size = part.size();
+                        while (size > 0x00) {
+                            if (fill == 0x00 && reinterpret_cast<uintptr_t>(data) % block == 0x00 && size >= block) {
+                                const uintmax_t aligned = size & ~(block - 1);
+                                write_all(fd, data, aligned);
+                                data += aligned, size -= aligned, total += aligned;
+                                continue;
+                            }
+                            const uintmax_t count = std::min(size, capacity - fill);
+                            _STD memcpy(staging.get() + fill, data, count);
+                            data += count, size -= count, fill += count;
+                            if (fill == capacity) {
+                                write_all(fd, staging.get(), fill);
+                                total += fill, fill = 0x00;
+                            }
+                        }
+                    }
+                    if (fill != 0x00) {
+                        const uintmax_t padded = (fill + block - 1) & ~(block - 1);
+                        _STD memset(staging.get() + fill, 0x00, padded - fill);
+                        write_all(fd, staging.get(), padded);
+                        total += fill;
+                    }
+                    if (::ftruncate(fd, static_cast<off_t>(total)) != 0)
+                        throw std::runtime_error("failed to write file");
+                } catch (...) {
+                    close(fd);
+                    throw;
+                }
+                if (!close(fd))
+                    throw std::runtime_error("failed to close file");
+                return true;
+#else
+                (void) filename, (void) parts;
+                return false;
+#endif
+            }
+
+            // smallest staging buffer of the stream classes, it must hold the longest value: a 64-bit varint
+            constexpr uintmax_t stream_chunk = 10;
+
+            inline void check_chunk(const uintmax_t &chunk) {
+                if (chunk < stream_chunk)
+                    throw std::invalid_argument("chunk is smaller than the longest value");
+            }
+
+            // reads up to `size` bytes, returns 0 at the end of the file
+            inline uintmax_t read_some(const int &fd, uint8_t *data, const uintmax_t &size) {
+                while (true) {
+                    const stats::timer_t timer(stats::histogram_t::io_read);
+                    stats::add(stats::counter_t::io_reads);
+#if _MSC_VER
+                    const int count = ::_read(fd, data, static_cast<unsigned>(size < 0x40000000 ? size : 0x40000000));
+#else
+                    const ssize_t count = ::read(fd, data, size);
+#endif
+                    if (count >= 0) {
+                        stats::add(stats::counter_t::io_read_bytes, count);
+                        return static_cast<uintmax_t>(count);
+                    }
+                    if (errno != EINTR) {
+                        stats::add(stats::counter_t::io_errors);
+                        throw std::runtime_error("failed to read file");
+                    }
+                }
+            }
+        }
+
+        /**
+         * Serializes the bytes written so far into the buffer to a binary file.
+         *
+         * The file is created or truncated in place and is not synced, a crash can leave it
+         * torn; use `snapshot_t` when the file must survive one.
+         *
+         * @param buffer A pointer to the `wmemory_t` object to write.
+         * @param filename The name of the binary file to write.
+         *
+         * @throws std::runtime_error If the file cannot be opened, written or closed.
+         */
+        template<class _allocator>
+        void serialize(basic_wmemory_t<_allocator> *buffer, const char *filename) {
+            const int fd = detail::open_write(filename);
+            if (fd < 0)
+                throw std::runtime_error("failed to open file");
+            try {
+                detail::write_all(fd, buffer->data(), buffer->lens());
+            } catch (...) {
+                detail::close(fd);
+                throw;
+            }
+            if (!detail::close(fd))
+                throw std::runtime_error("failed to close file");
+        }
+
+        /**
+         * Crash-safe writer that replaces a file atomically.
+         *
+         * Writes go to a temporary file next to the target. `commit` syncs it, renames it over
+         * the target and syncs the directory, so after a crash the target holds either the
+         * previous or the new snapshot, never a torn one. A snapshot dropped without `commit`
+         * is discarded. Several snapshots can share one round of syncs through `io::commit`.
+         */
+        class snapshot_t {
+        public:
+            /**
+             * Creates the temporary file for a new snapshot of `filename`.
+             *
+             * The snapshot gets the permissions of the file it replaces, or 0666 minus the umask
+             * for a new file.
+             *
+             * @param filename The file to replace on commit.
+             * @param writeback Start writing dirty pages back every `writeback` bytes so the final
+             *                  sync has less to wait for, 0 leaves it all to the commit.
+             *
+             * @throws std::runtime_error If the temporary file cannot be created.
+             */
+            explicit snapshot_t(const char *filename, const uintmax_t &writeback = 0x00)
+                : m_target(filename), m_writeback(writeback) {
+#ifdef __SERIALIZER_POSIX__
+                // not mkstemp: its 0600 would have to be replaced, O_CREAT with 0666 applies the umask
+                static std::atomic<uint64_t> sequence{0};
+                for (int attempt = 0; attempt < 0x40 && m_fd < 0; ++attempt) {
+                    const uint64_t unique = uint64_t(std::chrono::steady_clock::now().time_since_epoch().count())
+                                            ^ (uint64_t(::getpid()) << 40)
+                                            ^ sequence.fetch_add(0x9E3779B97F4A7C15, std::memory_order_relaxed);
+                    char suffix[24] = ".tmp-";
+                    const char *end = std::to_chars(suffix + 5, std::end(suffix), unique, 16).ptr;
+                    m_temporary = m_target;
+                    m_temporary += std::string_view(suffix, end);
+                    m_fd = ::open(m_temporary.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, 0666);
+                    if (m_fd < 0 && errno != EEXIST)
+                        break;
+                }
+                // a replaced file keeps its permissions, a 0600 secret stays private
+                struct stat target{};
+                if (m_fd >= 0 && ::stat(m_target.c_str(), &target) == 0
+                    && ::fchmod(m_fd, target.st_mode & 07777) != 0)
+                    abort();
+#else
+                m_temporary = m_target;
+                m_temporary += ".tmp";
+                m_fd = detail::open_write(m_temporary.string().c_str());
+#endif
+                if (m_fd < 0)
+                    throw std::runtime_error("failed to open file");
+            }
+
+            ~snapshot_t() {
+                abort();
+            }
+
+            snapshot_t(const snapshot_t &) = delete;
+            snapshot_t &operator=(const snapshot_t &) = delete;
+
+            /**
+             * Appends bytes to the snapshot.
+             *
+             * @throws std::runtime_error If the snapshot is over or the bytes cannot be written.
+             */
+            void write(const std::span<const uint8_t> &bytes) {
+                if (m_fd < 0)
+                    throw std::runtime_error("snapshot already committed or aborted");
+                detail::write_all(m_fd, bytes.data(), bytes.size());
+                m_written += bytes.size();
+                if (m_writeback != 0x00 && m_written - m_started >= m_writeback) {
+                    start_writeback();
+                    m_started = m_written;
+                }
+            }
+
+            // appends the bytes written so far into `buffer`
+            template<class _allocator>
+            void write(basic_wmemory_t<_allocator> *buffer) {
+                write(std::span<const uint8_t>(buffer->data(), buffer->lens()));
+            }
+
+            /**
+             * Makes the snapshot durable and puts it in place of the target.
+             *
+             * @throws std::runtime_error If a sync, the rename or the directory sync fails,
+             *                            the target is then left as it was before, unless
+             *                            only the directory sync failed.
+             */
+            void commit() {
+                snapshot_t *self = this;
+                commit_all(std::span<snapshot_t *const>(&self, 1));
+            }
+
+            // discards the snapshot, the target is left untouched
+            void abort() noexcept {
+                if (m_fd < 0)
+                    return;
+                detail::close(m_fd);
+                m_fd = -1;
+                std::error_code code;
+                std::filesystem::remove(m_temporary, code);
+            }
+
+            constexpr uintmax_t written() const noexcept { return m_written; }
+            const std::filesystem::path &target() const noexcept { return m_target; }
+
+            /**
+             * Commits several snapshots with one round of syncs.
+             *
+             * Writeback is started for every file before waiting on any of them, each file is
+             * synced once, renamed, and each directory involved is synced once.
+             */
+            static void commit_all(const std::span<snapshot_t *const> &snapshots) {
+                for (snapshot_t *snapshot: snapshots)
+                    if (snapshot->m_fd < 0)
+                        throw std::runtime_error("snapshot already committed or aborted");
+                for (snapshot_t *snapshot: snapshots)
+                    snapshot->start_writeback();
+                for (snapshot_t *snapshot: snapshots) {
+                    if (!detail::sync_data(snapshot->m_fd))
+                        throw std::runtime_error("failed to sync file");
+                }
+                std::vector<std::filesystem::path> directories;
+                for (snapshot_t *snapshot: snapshots) {
+                    const bool closed = detail::close(snapshot->m_fd);
+                    snapshot->m_fd = -1;
+                    std::error_code code;
+                    if (closed)
+                        std::filesystem::rename(snapshot->m_temporary, snapshot->m_target, code);
+                    if (!closed || code) {
+                        std::filesystem::remove(snapshot->m_temporary, code);
+                        throw std::runtime_error("failed to replace file");
+                    }
+                    std::filesystem::path directory = snapshot->m_target.parent_path();
+                    if (std::find(directories.begin(), directories.end(), directory) == directories.end())
+                        directories.push_back(std::move(directory));
+                }
+                for (const std::filesystem::path &directory: directories)
+                    if (!detail::sync_directory(directory))
+                        throw std::runtime_error("failed to sync directory");
+            }
+
+        private:
+            // asks the kernel to start writing the file back without waiting for it
+            void start_writeback() noexcept {
+#if defined(__linux__)
+                ::sync_file_range(m_fd, 0, 0, SYNC_FILE_RANGE_WRITE);
+#endif
+            }
+
+        private:
+            std::filesystem::path m_target; // file replaced on commit
+            std::filesystem::path m_temporary; // file written until then, in the same directory
+            uintmax_t m_writeback = 0x00; // bytes between two writeback starts, 0 for none
+            uintmax_t m_written = 0x00; // bytes written so far
+            uintmax_t m_started = 0x00; // m_written at the last writeback start
+            int m_fd = -1; // temporary file, -1 once committed or aborted
+        };
+
+        /**
+         * Commits several snapshots with one round of syncs, see `snapshot_t::commit_all`.
+         *
+         * @param snapshots The snapshots to commit, e.g. `{&users, &orders}`.
+         *
+         * @throws std::runtime_error If a sync or a rename fails, the snapshots not renamed yet stay uncommitted.
+         */
+        inline void commit(const std::initializer_list<snapshot_t *> &snapshots) {
+            snapshot_t::commit_all(std::span<snapshot_t *const>(snapshots.begin(), snapshots.size()));
+        }
+
+        inline void commit(const std::span<snapshot_t *const> &snapshots) {
+            snapshot_t::commit_all(snapshots);
+        }
+
+        /**
+         * Writes several byte ranges into one file, in order, without concatenating them first.
+         *
+         * The ranges are handed to the kernel with `writev`, bypassing stdio buffering, only
+         * ranges under 2 KB are gathered before.
+         *
+         * @param parts The byte ranges to write, e.g. a header followed by payloads.
+         * @param filename The name of the file to create or truncate.
+         * @param output One of `output_t`, `output_t::direct` skips the page cache for large dumps.
+         *
+         * @throws std::runtime_error If the file cannot be opened, written or closed.
+         */
+        inline void serialize(const std::span<const std::span<const uint8_t> > &parts, const char *filename,
+                              const int &output = output_t::buffered) {
+            if (output == output_t::direct && detail::write_direct(filename, parts))
+                return;
+            const int fd = detail::open_write(filename);
+            if (fd < 0)
+                throw std::runtime_error("failed to open file");
+            try {
+                detail::write_parts(fd, parts);
+            } catch (...) {
+                detail::close(fd);
+                throw;
+            }
+            if (!detail::close(fd))
+                throw std::runtime_error("failed to close file");
+        }
+
+        inline void serialize(const std::initializer_list<std::span<const uint8_t> > &parts, const char *filename,
+                              const int &output = output_t::buffered) {
+            serialize(std::span<const std::span<const uint8_t> >(parts.begin(), parts.size()), filename, output);
+        }
+
+        /**
+         * Writes the bytes written so far into each buffer, in order, as one file.
+         *
+         * @param buffers The buffers to write, e.g. `{&header, &payload}`.
+         * @param filename The name of the file to create or truncate.
+         * @param output One of `output_t`.
+         *
+         * @throws std::runtime_error If the file cannot be opened or written.
+         */
+        template<class _allocator>
+        void serialize(const std::initializer_list<basic_wmemory_t<_allocator> *> &buffers, const char *filename,
+                       const int &output = output_t::buffered) {
+            std::vector<std::span<const uint8_t> > parts;
+            parts.reserve(buffers.size());
+            for (basic_wmemory_t<_allocator> *buffer: buffers)
+                parts.emplace_back(buffer->data(), buffer->lens());
+            serialize(std::span<const std::span<const uint8_t> >(parts), filename, output);
+        }
+
+        /**
+         * Serializer that writes to a file descriptor in chunks, with the same `setX` API as `wmemory_t`.
+         *
+         * Values are staged in a fixed-size `wmemory_t` that is flushed whenever the next value
+         * doesn't fit, so memory stays constant regardless of the payload size. The bytes written
+         * are the same as `io::serialize` of a `wmemory_t` filled with the same calls.
+         */
+        class stream_writer_t {
+        public:
+            /**
+             * Creates (or truncates) the given file and streams into it.
+             *
+             * @param filename The name of the file to write.
+             * @param chunk The size of the staging buffer. Must be at least 10 bytes.
+             *
+             * @throws std::invalid_argument If the chunk is smaller than 10 bytes.
+             * @throws std::runtime_error If the file cannot be opened.
+             */
+            stream_writer_t(const char *filename, const uintmax_t &chunk = 0x10000) : m_staging(chunk) {
+                detail::check_chunk(chunk);
+                m_fd = detail::open_write(filename);
+                if (m_fd < 0)
+                    throw std::runtime_error("failed to open file");
+                m_owned = true;
+            }
+
+            /**
+             * Streams into a file descriptor owned by the caller, it is not closed by the writer.
+             *
+             * @param fd An open, writable file descriptor.
+             * @param chunk The size of the staging buffer. Must be at least 10 bytes.
+             *
+             * @throws std::invalid_argument If the chunk is smaller than 10 bytes.
+             */
+            stream_writer_t(const int &fd, const uintmax_t &chunk = 0x10000) : m_staging(chunk) {
+                detail::check_chunk(chunk);
+                m_fd = fd;
+            }
+
+            ~stream_writer_t() {
+                try {
+                    flush();
+                } catch (...) {
+                    // destructors must not throw, call flush() first to see write errors
+                }
+                if (m_owned)
+                    detail::close(m_fd);
+            }
+
+            stream_writer_t(const stream_writer_t &) = delete;
+
+            stream_writer_t &operator=(const stream_writer_t &) = delete;
+
+            /**
+             * Writes the staged bytes to the file descriptor.
+             *
+             * @throws std::runtime_error If the write fails.
+             */
+            void flush() {
+                if (m_staging.lens() != 0x00) {
+                    detail::write_all(m_fd, m_staging.data(), m_staging.lens());
+                    m_written += m_staging.lens();
+                    m_staging.rewind();
+                }
+            }
+
+            constexpr auto setBytes(const char &value) -> void { put(value); }
+            constexpr auto setShort(const short &value) -> void { put(value); }
+            constexpr auto setInt(const int &value) -> void { put(value); }
+            constexpr auto setLong(const long long &value) -> void { put(value); }
+            constexpr auto setFloat(const float &value) -> void { put(value); }
+            constexpr auto setDouble(const double &value) -> void { put(value); }
+            constexpr auto setUBytes(const uint8_t &value) -> void { put(value); }
+            constexpr auto setUShort(const uint16_t &value) -> void { put(value); }
+            constexpr auto setUInt(const uint32_t &value) -> void { put(value); }
+            constexpr auto setULong(const uint64_t &value) -> void { put(value); }
+            constexpr auto setString(const std::string_view &value) -> void { put(value); }
+            constexpr auto setStringView(const std::string_view &value) -> void { put(value); }
+            constexpr auto setBool(const bool &value) -> void { put(value); }
+
+            // total number of bytes written so far, staged bytes included
+            constexpr uintmax_t lens() noexcept { return m_written + m_staging.lens(); }
+
+            /**
+             * Changes the wire layout of the values written from now on, see `wmemory_t::set_encoding`.
+             */
+            constexpr void set_encoding(const int &encoding) noexcept {
+                m_staging.set_encoding(encoding);
+            }
+
+        private:
+            template<supported _typename>
+            constexpr void put(const _typename &value) {
+                if constexpr (string_like<_typename>) {
+                    const std::string_view str = value;
+                    const size_t lens = str.size();
+                    constexpr uintmax_t prefix = 10; // the longest length prefix, a 64-bit varint
+                    if (!m_staging.is_enough(prefix + lens)) {
+                        flush();
+                        if (!m_staging.is_enough(prefix + lens)) {
+                            // bigger than the staging buffer, bypass it
+                            m_staging.insert_length(lens);
+                            flush();
+                            detail::write_all(m_fd, reinterpret_cast<const uint8_t *>(str.data()), lens);
+                            m_written += lens;
+                            return;
+                        }
+                    }
+                    m_staging.insert(str);
+                } else {
+                    if (!m_staging.is_enough(utils::detail::encoded_max<_typename>(m_staging.encoding())))
+                        flush();
+                    m_staging.insert(value);
+                }
+            }
+
+        private:
+            wmemory_t m_staging; // fixed-size staging buffer
+            int m_fd = -1; // destination file descriptor
+            bool m_owned = false; // whether m_fd is closed by the writer
+            uintmax_t m_written = 0x00; // bytes already flushed
+        };
+
+        /**
+         * Deserializer that reads from a file descriptor in chunks, with the same `get_X` API as `wmemory_t`.
+         *
+         * The staging buffer is refilled on demand, so memory stays constant regardless of the
+         * payload size.
+         */
+        class stream_reader_t {
+        public:
+            /**
+             * Opens the given file for streaming.
+             *
+             * @param filename The name of the file to read.
+             * @param chunk The size of the staging buffer. Must be at least 10 bytes.
+             *
+             * @throws std::invalid_argument If the chunk is smaller than 10 bytes.
+             * @throws std::runtime_error If the file cannot be opened.
+             */
+            stream_reader_t(const char *filename, const uintmax_t &chunk = 0x10000) : m_staging(chunk) {
+                detail::check_chunk(chunk);
+                m_fd = detail::open_read(filename);
+                if (m_fd < 0)
+                    throw std::runtime_error("failed to open file");
+                m_owned = true;
+            }
+
+            /**
+             * Streams from a file descriptor owned by the caller, it is not closed by the reader.
+             *
+             * @param fd An open, readable file descriptor.
+             * @param chunk The size of the staging buffer. Must be at least 10 bytes.
+             *
+             * @throws std::invalid_argument If the chunk is smaller than 10 bytes.
+             */
+            stream_reader_t(const int &fd, const uintmax_t &chunk = 0x10000) : m_staging(chunk) {
+                detail::check_chunk(chunk);
+                m_fd = fd;
+            }
+
+            ~stream_reader_t() {
+                if (m_owned)
+                    detail::close(m_fd);
+            }
+
+            stream_reader_t(const stream_reader_t &) = delete;
+
+            stream_reader_t &operator=(const stream_reader_t &) = delete;
+
+            /**
+             * Checks whether every byte of the stream has been consumed.
+             *
+             * @throws std::runtime_error If the read fails.
+             */
+            bool eof() {
+                return !fill(0x1);
+            }
+
+            /**
+             * Retrieves a string from the stream, strings bigger than the staging buffer are
+             * read straight from the file descriptor.
+             *
+             * @throws std::runtime_error If the stream ends early or the read fails.
+             */
+            const std::string get_string() {
+                const size_t size = take_length();
+                if (fill(size)) {
+                    const std::string value((const char *) m_staging.data() + m_staging.lens(), size);
+                    m_staging.skip(size);
+                    return value;
+                }
+                std::string value(size, '\0');
+                const uintmax_t staged = m_fill - m_staging.lens();
+                _STD memcpy(value.data(), m_staging.data() + m_staging.lens(), staged);
+                m_staging.rewind(), m_fill = 0x00;
+                for (uintmax_t lens = staged; lens < size;) {
+                    const uintmax_t count = detail::read_some(m_fd, reinterpret_cast<uint8_t *>(value.data()) + lens,
+                                                              size - lens);
+                    if (count == 0x00)
+                        throw std::runtime_error("unexpected end of file");
+                    lens += count;
+                }
+                return value;
+            }
+
+            /**
+             * Retrieves a string view into the staging buffer, valid until the next read.
+             *
+             * @throws std::runtime_error If the string is bigger than the staging buffer,
+             *         the stream ends early or the read fails.
+             */
+            const std::string_view get_string_view() {
+                const size_t size = take_length();
+                if (size > m_staging.size())
+                    throw std::runtime_error("string exceeds the staging buffer, use get_string");
+                if (!fill(size))
+                    throw std::runtime_error("unexpected end of file");
+                const std::string_view value((const char *) m_staging.data() + m_staging.lens(), size);
+                m_staging.skip(size);
+                return value;
+            }
+
+            /**
+             * Changes the wire layout of the values read from now on, see `wmemory_t::set_encoding`.
+             */
+            constexpr void set_encoding(const int &encoding) noexcept {
+                m_staging.set_encoding(encoding);
+            }
+
+            const char get_bytes() { return take<char>(); }
+            const short get_short() { return take<short>(); }
+            const int get_int() { return take<int>(); }
+            const int64_t get_long() { return take<int64_t>(); }
+            const long long get_llong() { return take<long long>(); }
+            const uint16_t get_ushort() { return take<uint16_t>(); }
+            const uint32_t get_uint() { return take<uint32_t>(); }
+            const uint64_t get_uint64() { return take<uint64_t>(); }
+            const bool get_bool() { return take<bool>(); }
+            const float get_float() { return take<float>(); }
+            const double get_double() { return take<double>(); }
+
+        private:
+            /**
+             * Makes sure at least `size` unread bytes are staged, refilling from the file descriptor.
+             *
+             * @return `false` if the stream ended before `size` bytes were available, or if
+             *         `size` is bigger than the staging buffer.
+             */
+            bool fill(const uintmax_t &size) {
+                uintmax_t available = m_fill - m_staging.lens();
+                if (available >= size)
+                    return true;
+                if (size > m_staging.size())
+                    return false;
+                // move the unread tail to the front, then top the staging buffer up
+                _STD memmove(m_staging.data(), m_staging.data() + m_staging.lens(), available);
+                m_staging.rewind(), m_fill = available;
+                while (m_fill < size) {
+                    const uintmax_t count = detail::read_some(m_fd, m_staging.data() + m_fill,
+                                                              m_staging.size() - m_fill);
+                    if (count == 0x00)
+                        return false;
+                    m_fill += count;
+                }
+                return true;
+            }
+
+            /**
+             * Makes sure the next value, at most `size` bytes, is staged in full.
+             *
+             * A varint may be shorter than its worst case, near the end of the stream it is
+             * enough that its last byte is staged.
+             *
+             * @throws std::runtime_error If the stream ends early or the read fails.
+             */
+            void fill_value(const uintmax_t &size, const bool &varint) {
+                if (fill(size))
+                    return;
+                if (varint)
+                    for (uintmax_t at = m_staging.lens(); at < m_fill; ++at)
+                        if (!(m_staging.data()[at] & 0x80))
+                            return;
+                throw std::runtime_error("unexpected end of file");
+            }
+
+            template<class _typename>
+            _typename take() {
+                const bool varint = varint_like<_typename> && (m_staging.encoding() & encoding_t::compact);
+                fill_value(utils::detail::encoded_max<_typename>(m_staging.encoding()), varint);
+                return m_staging.template get<_typename>();
+            }
+
+            size_t take_length() {
+                const bool varint = m_staging.encoding() & encoding_t::compact;
+                fill_value(varint ? detail::stream_chunk : sizeof(uint64_t), varint);
+                return m_staging.get_length();
+            }
+
+        private:
+            wmemory_t m_staging; // fixed-size staging buffer, lens() is the read position
+            uintmax_t m_fill = 0x00; // bytes of m_staging holding data read from m_fd
+            int m_fd = -1; // source file descriptor
+            bool m_owned = false; // whether m_fd is closed by the reader
+        };
+
+        namespace detail {
+            constexpr uint32_t archive_magic = 0x5241534D; // "MSAR" in little-endian order
+            constexpr uint32_t archive_version = 0x1;
+            constexpr uintmax_t archive_header = 0x08; // magic, version
+            constexpr uintmax_t archive_footer = 0x18; // index offset, record count, magic, version
+
+            // reads a little-endian value from an unaligned address
+            template<class _typename>
+            inline _typename load_little(const uint8_t *data) noexcept {
+                _typename value;
+                _STD memcpy(&value, data, sizeof(_typename));
+                return utils::detail::wire_order(value, encoding_t::little);
+            }
+        }
+
+        /**
+         * Writes an archive of records that can be read back one at a time with `archive_reader_t`.
+         *
+         * Layout, little-endian: an 8-byte header (magic, version), every record as a 64-bit
+         * length followed by its bytes, then an index with the offset of every record and a
+         * 24-byte footer (index offset, record count, magic, version). The index and footer are
+         * written by `close`, an archive without them is rejected by the reader.
+         */
+        class archive_writer_t {
+        public:
+            /**
+             * Creates (or truncates) the given file and writes the archive header.
+             *
+             * @param filename The name of the file to write.
+             * @param chunk The size of the staging buffer, records that don't fit bypass it.
+             *
+             * @throws std::runtime_error If the file cannot be opened.
+             */
+            explicit archive_writer_t(const char *filename, const uintmax_t &chunk = 0x10000)
+                : m_staging(std::max<uintmax_t>(chunk, detail::archive_footer)) {
+                m_fd = detail::open_write(filename);
+                if (m_fd < 0)
+                    throw std::runtime_error("failed to open file");
+                m_staging.set_encoding(encoding_t::little);
+                m_staging.setUInt(detail::archive_magic);
+                m_staging.setUInt(detail::archive_version);
+            }
+
+            ~archive_writer_t() {
+                try {
+                    close();
+                } catch (...) {
+                    // destructors must not throw, call close() first to see write errors
+                }
+            }
+
+            archive_writer_t(const archive_writer_t &) = delete;
+
+            archive_writer_t &operator=(const archive_writer_t &) = delete;
+
+            /**
+             * Appends one record, its index is the number of records appended before it.
+             *
+             * @throws std::runtime_error If the archive is closed or the write fails.
+             */
+            void append(const std::span<const uint8_t> &record) {
+                if (m_fd < 0)
+                    throw std::runtime_error("archive already closed");
+                m_index.push_back(lens());
+                if (!m_staging.is_enough(sizeof(uint64_t) + record.size())) {
+                    flush();
+                    if (!m_staging.is_enough(sizeof(uint64_t) + record.size())) {
+                        // bigger than the staging buffer, bypass it
+                        m_staging.setULong(record.size());
+                        flush();
+                        detail::write_all(m_fd, record.data(), record.size());
+                        m_written += record.size();
+                        return;
+                    }
+                }
+                m_staging.set_array(record);
+            }
+
+            // appends the bytes written so far into `buffer` as one record
+            template<class _allocator>
+            void append(basic_wmemory_t<_allocator> *buffer) {
+                append(std::span<const uint8_t>(buffer->data(), buffer->lens()));
+            }
+
+            /**
+             * Writes the index and the footer, then closes the file. Called by the destructor.
+             *
+             * @throws std::runtime_error If a write or closing the file fails.
+             */
+            void close() {
+                if (m_fd < 0)
+                    return;
+                const int fd = m_fd;
+                try {
+                    const uint64_t offset = lens();
+                    for (const uint64_t &record: m_index) {
+                        if (!m_staging.is_enough(sizeof(uint64_t)))
+                            flush();
+                        m_staging.setULong(record);
+                    }
+                    if (!m_staging.is_enough(detail::archive_footer))
+                        flush();
+                    m_staging.setULong(offset);
+                    m_staging.setULong(m_index.size());
+                    m_staging.setUInt(detail::archive_magic);
+                    m_staging.setUInt(detail::archive_version);
+                    flush();
+                } catch (...) {
+                    m_fd = -1;
+                    detail::close(fd);
+                    throw;
+                }
+                m_fd = -1;
+                if (!detail::close(fd))
+                    throw std::runtime_error("failed to close file");
+            }
+
+            // number of records appended so far
+            constexpr size_t size() const noexcept { return m_index.size(); }
+
+            // bytes written so far, staged bytes included
+            constexpr uintmax_t lens() noexcept { return m_written + m_staging.lens(); }
+
+        private:
+            void flush() {
+                if (m_staging.lens() != 0x00) {
+                    detail::write_all(m_fd, m_staging.data(), m_staging.lens());
+                    m_written += m_staging.lens();
+                    m_staging.rewind();
+                }
+            }
+
+        private:
+            wmemory_t m_staging; // fixed-size staging buffer
+            std::vector<uint64_t> m_index; // offset of every record
+            int m_fd = -1; // destination file descriptor, -1 once closed
+            uintmax_t m_written = 0x00; // bytes already flushed
+        };
+
+        /**
+         * Random-access reader of an archive written by `archive_writer_t`.
+         *
+         * The file is mapped, opening it only reads the footer, and looking up a record is
+         * one index read: only the pages of the records actually accessed are loaded.
+         */
+        class archive_reader_t {
+        public:
+            /**
+             * Opens an archive and checks its header and footer.
+             *
+             * @param filename The name of the archive to read.
+             *
+             * @throws std::runtime_error If the file cannot be opened or is not a complete archive.
+             */
+            explicit archive_reader_t(const char *filename) : m_file(std::make_shared<mapped_file_t>(filename)) {
+                m_file->advise(advice_t::random);
+                const uint8_t *data = m_file->data();
+                const uintmax_t size = m_file->size();
+                if (size < detail::archive_header + detail::archive_footer
+                    || detail::load_little<uint32_t>(data) != detail::archive_magic)
+                    throw std::runtime_error("not an archive");
+                const uint8_t *footer = data + size - detail::archive_footer;
+                if (detail::load_little<uint32_t>(footer + 0x10) != detail::archive_magic)
+                    throw std::runtime_error("archive is truncated");
+                if (detail::load_little<uint32_t>(data + 0x04) != detail::archive_version
+                    || detail::load_little<uint32_t>(footer + 0x14) != detail::archive_version)
+                    throw std::runtime_error("unsupported archive version");
+                const uint64_t offset = detail::load_little<uint64_t>(footer);
+                m_count = detail::load_little<uint64_t>(footer + 0x08);
+                const uintmax_t end = size - detail::archive_footer;
+                if (offset < detail::archive_header || offset > end || m_count != (end - offset) / sizeof(uint64_t)
+                    || (end - offset) % sizeof(uint64_t) != 0x00)
+                    throw std::runtime_error("archive index is corrupted");
+                m_index = data + offset;
+            }
+
+            // number of records in the archive
+            constexpr size_t size() const noexcept { return m_count; }
+
+            /**
+             * Bytes of the record at `index`, valid for as long as the reader lives.
+             *
+             * @throws std::out_of_range If `index` is not below `size()`.
+             * @throws std::runtime_error If the record overlaps the index.
+             */
+            std::span<const uint8_t> record(const size_t &index) const {
+                if (index >= m_count)
+                    throw std::out_of_range("record index out of range");
+                const uint8_t *data = m_file->data();
+                const uintmax_t end = m_index - data;
+                const uint64_t offset = detail::load_little<uint64_t>(m_index + index * sizeof(uint64_t));
+                if (offset < detail::archive_header || offset > end - sizeof(uint64_t))
+                    throw std::runtime_error("archive index is corrupted");
+                const uint64_t size = detail::load_little<uint64_t>(data + offset);
+                if (size > end - offset - sizeof(uint64_t))
+                    throw std::runtime_error("archive record is corrupted");
+                return {data + offset + sizeof(uint64_t), size};
+            }
+
+            /**
+             * Bounds-checked view over the record at `index`, see `record`.
+             *
+             * @param encoding The `encoding_t` flags the record was written with.
+             */
+            read_view_t view(const size_t &index, const int &encoding = encoding_t::fixed) const {
+                const std::span<const uint8_t> bytes = record(index);
+                return read_view_t(bytes.data(), bytes.size(), encoding);
+            }
+
+            /**
+             * Attaches the record at `index` to `buffer` without copying, the mapping stays alive
+             * for as long as the buffer uses it. Writing into the buffer never modifies the file.
+             * An empty record leaves the buffer cleaned up.
+             *
+             * @throws std::out_of_range If `index` is not below `size()`.
+             * @throws std::runtime_error If the record is corrupted.
+             */
+            template<class _allocator>
+            void read(const size_t &index, basic_wmemory_t<_allocator> *buffer) const {
+                const std::span<const uint8_t> bytes = record(index);
+                if (bytes.empty())
+                    return buffer->cleanup();
+                buffer->attach(const_cast<uint8_t *>(bytes.data()), bytes.size(), m_file);
+            }
+
+        private:
+            std::shared_ptr<mapped_file_t> m_file; // the whole archive, shared with attached buffers
+            const uint8_t *m_index = nullptr; // start of the offset index in the mapping
+            uint64_t m_count = 0x00; // number of records
+        };
+
+        namespace detail {
+            constexpr uint32_t compressed_magic = 0x5A4C534D; // "MSLZ" in little-endian order
+            constexpr uint32_t compressed_version = 0x1;
+            constexpr uintmax_t compressed_header = 0x20; // magic, version, block size, raw size, block count
+            constexpr uint32_t stored_block = 0x80000000; // flags a block kept raw because it didn't shrink
+
+            // runs `task(i)` for every `i` below `count` on up to `threads` threads, 0 for one per core
+            template<class _function>
+            void parallel_for(const size_t &count, size_t threads, _function &&task) {
+                if (threads == 0x00)
+                    threads = std::max(1u, std::thread::hardware_concurrency());
+                threads = std::min(threads, count);
+                if (threads <= 1) {
+                    for (size_t i = 0; i < count; ++i)
+                        task(i);
+                    return;
+                }
+                std::atomic<size_t> next{0};
+                const auto worker = [&] {
+                    for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;)
+                        task(i);
+                };
+                std::vector<std::jthread> pool;
+                pool.reserve(threads - 1);
+                for (size_t i = 1; i < threads; ++i)
+                    pool.emplace_back(worker);
+                worker();
+            }
+        }
+
+        /**
+         * Serializes the bytes written so far into the buffer to a compressed binary file.
+         *
+         * The bytes are cut into blocks compressed independently with `lz::compress`, so they can
+         * be decompressed in parallel and read back one at a time with `compressed_reader_t`.
+         * Blocks that don't shrink are stored raw.
+         *
+         * Layout, little-endian: a 32-byte header (magic, version, block size, raw size, block
+         * count), the compressed size of every block as 32 bits (the top bit flags a raw block),
+         * then the blocks.
+         *
+         * @param buffer A pointer to the `wmemory_t` object to write.
+         * @param filename The name of the file to create or truncate.
+         * @param block The size of a block before compression, up to 2 GB. Smaller blocks make
+         *              random reads cheaper, larger ones compress slightly better.
+         * @param threads The number of threads compressing blocks, 0 for one per core.
+         *
+         * @throws std::invalid_argument If the block size is out of range.
+         * @throws std::runtime_error If the file cannot be opened, written or closed.
+         */
+        template<class _allocator>
+        void serialize_compressed(basic_wmemory_t<_allocator> *buffer, const char *filename,
+                                  const uintmax_t &block = 0x10000, const size_t &threads = 0) {
+            if (block == 0x00 || block >= detail::stored_block)
+                throw std::invalid_argument("block size must be between 1 byte and 2 GB");
+            const uint8_t *data = buffer->data();
+            const uintmax_t size = buffer->lens();
+            const size_t count = (size + block - 1) / block;
+            const uintmax_t slot = lz::bound(block);
+            const std::unique_ptr<uint8_t[]> staging = std::make_unique_for_overwrite<uint8_t[]>(count * slot);
+
+            std::vector<uint32_t> sizes(count);
+            std::vector<std::span<const uint8_t> > parts(count + 1);
+            detail::parallel_for(count, threads, [&](const size_t &i) {
+                const uint8_t *in = data + i * block;
+                const uintmax_t length = std::min(block, size - i * block);
+                uint8_t *out = staging.get() + i * slot;
+                const uintmax_t packed = lz::compress(in, length, out);
+                if (packed < length)
+                    parts[i + 1] = {out, packed}, sizes[i] = static_cast<uint32_t>(packed);
+                else parts[i + 1] = {in, length}, sizes[i] = static_cast<uint32_t>(length) | detail::stored_block;
+            });
+
+            wmemory_t header(detail::compressed_header + count * sizeof(uint32_t));
+            header.set_encoding(encoding_t::little);
+            header.setUInt(detail::compressed_magic);
+            header.setUInt(detail::compressed_version);
+            header.setULong(block);
+            header.setULong(size);
+            header.setULong(count);
+            for (const uint32_t &packed: sizes)
+                header.setUInt(packed);
+            parts[0] = {header.data(), header.lens()};
+
+            const int fd = detail::open_write(filename);
+            if (fd < 0)
+                throw std::runtime_error("failed to open file");
+            try {
+                detail::write_parts(fd, parts);
+            } catch (...) {
+                detail::close(fd);
+                throw;
+            }
+            if (!detail::close(fd))
+                throw std::runtime_error("failed to close file");
+        }
+
+        /**
+         * Random-access reader of a file written by `serialize_compressed`.
+         *
+         * The file is mapped, opening it only reads the block table. Any byte range can be read
+         * back by decompressing just the blocks it overlaps, and a whole file is decompressed
+         * with its blocks spread over threads.
+         */
+        class compressed_reader_t {
+        public:
+            /**
+             * Opens a compressed file and checks its header and block table.
+             *
+             * @param filename The name of the file to read.
+             *
+             * @throws std::runtime_error If the file cannot be opened or is not a complete compressed file.
+             */
+            explicit compressed_reader_t(const char *filename) : m_file(std::make_shared<mapped_file_t>(filename)) {
+                const uint8_t *data = m_file->data();
+                const uintmax_t size = m_file->size();
+                if (size < detail::compressed_header || detail::load_little<uint32_t>(data) != detail::compressed_magic)
+                    throw std::runtime_error("not a compressed file");
+                if (detail::load_little<uint32_t>(data + 0x04) != detail::compressed_version)
+                    throw std::runtime_error("unsupported compressed file version");
+                m_block = detail::load_little<uint64_t>(data + 0x08);
+                m_size = detail::load_little<uint64_t>(data + 0x10);
+                const uint64_t count = detail::load_little<uint64_t>(data + 0x18);
+                if (m_block == 0x00 || m_block >= detail::stored_block || count != m_size / m_block + (m_size % m_block != 0)
+                    || count > (size - detail::compressed_header) / sizeof(uint32_t))
+                    throw std::runtime_error("compressed file header is corrupted");
+
+                // where every block starts, and where the last one ends
+                m_offsets.resize(count + 1);
+                m_offsets[0] = detail::compressed_header + count * sizeof(uint32_t);
+                for (uint64_t i = 0; i < count; ++i)
+                    m_offsets[i + 1] = m_offsets[i] + (table(i) & ~detail::stored_block);
+                if (m_offsets[count] > size)
+                    throw std::runtime_error("compressed file is truncated");
+            }
+
+            // size of the data once decompressed
+            constexpr uintmax_t size() const noexcept { return m_size; }
+
+            // number of blocks
+            size_t blocks() const noexcept { return m_offsets.size() - 1; }
+
+            // size of a block before compression, the last one may be shorter
+            constexpr uintmax_t block_size() const noexcept { return m_block; }
+
+            /**
+             * Decompresses the block at `index` into `out`.
+             *
+             * @param out Receives the block, must hold `block_size()` bytes.
+             *
+             * @return The decompressed size of the block.
+             *
+             * @throws std::out_of_range If `index` is not below `blocks()`.
+             * @throws std::runtime_error If the block is corrupted.
+             */
+            uintmax_t read_block(const size_t &index, uint8_t *out) const {
+                if (index >= blocks())
+                    throw std::out_of_range("block index out of range");
+                if (!decode(index, out))
+                    throw std::runtime_error("compressed block is corrupted");
+                return length(index);
+            }
+
+            /**
+             * Reads `out.size()` decompressed bytes starting at `offset`, decompressing only the
+             * blocks they overlap.
+             *
+             * @throws std::out_of_range If the range ends past `size()`.
+             * @throws std::runtime_error If a block is corrupted.
+             */
+            void read(const uintmax_t &offset, const std::span<uint8_t> &out) const {
+                if (offset > m_size || out.size() > m_size - offset)
+                    throw std::out_of_range("read past the end of the compressed file");
+                std::unique_ptr<uint8_t[]> scratch; // for the blocks only partly read
+                uintmax_t position = offset;
+                uint8_t *target = out.data();
+                for (const uintmax_t end = offset + out.size(); position < end;) {
+                    const size_t index = position / m_block;
+                    const uintmax_t skip = position - index * m_block;
+                    const uintmax_t count = std::min(length(index) - skip, end - position);
+                    if (count == length(index)) {
+                        read_block(index, target);
+                    } else {
+                        if (!scratch)
+                            scratch = std::make_unique_for_overwrite<uint8_t[]>(m_block);
+                        read_block(index, scratch.get());
+                        _STD memcpy(target, scratch.get() + skip, count);
+                    }
+                    position += count, target += count;
+                }
+            }
+
+            /**
+             * Decompresses the whole file into `buffer`, replacing its content.
+             *
+             * @param threads The number of threads decompressing blocks, 0 for one per core.
+             *
+             * @throws std::runtime_error If a block is corrupted.
+             */
+            template<class _allocator>
+            void read(basic_wmemory_t<_allocator> *buffer, const size_t &threads = 0) const {
+                buffer->cleanup();
+                if (m_size == 0x00)
+                    return;
+                buffer->resize(m_size);
+                uint8_t *out = buffer->data();
+                std::atomic<bool> corrupted{false};
+                detail::parallel_for(blocks(), threads, [&](const size_t &i) {
+                    if (!decode(i, out + i * m_block))
+                        corrupted.store(true, std::memory_order_relaxed);
+                });
+                if (corrupted.load(std::memory_order_relaxed))
+                    throw std::runtime_error("compressed block is corrupted");
+            }
+
+        private:
+            uint32_t table(const size_t &index) const noexcept {
+                return detail::load_little<uint32_t>(m_file->data() + detail::compressed_header + index * sizeof(uint32_t));
+            }
+
+            uintmax_t length(const size_t &index) const noexcept {
+                return std::min(m_block, m_size - index * m_block);
+            }
+
+            bool decode(const size_t &index, uint8_t *out) const noexcept {
+                const uint8_t *in = m_file->data() + m_offsets[index];
+                const uintmax_t packed = m_offsets[index + 1] - m_offsets[index];
+                if (table(index) & detail::stored_block) {
+                    if (packed != length(index))
+                        return false;
+                    _STD memcpy(out, in, packed);
+                    return true;
+                }
+                return lz::decompress(in, packed, out, length(index));
+            }
+
+        private:
+            std::shared_ptr<mapped_file_t> m_file; // the whole compressed file
+            std::vector<uint64_t> m_offsets; // file offset of every block, then the end of the last one
+            uintmax_t m_block = 0x00; // size of a block before compression
+            uintmax_t m_size = 0x00; // size of the data once decompressed
+        };
+
+        /**
+         * Deserializes a file written by `serialize_compressed` into the specified `wmemory_t` buffer.
+         *
+         * @param buffer A pointer to the `wmemory_t` object where the data will be stored.
+         * @param filename The name of the compressed file to read.
+         * @param threads The number of threads decompressing blocks, 0 for one per core.
+         *
+         * @throws std::runtime_error If the file cannot be opened or is corrupted.
+         */
+        template<class _allocator>
+        void deserialize_compressed(basic_wmemory_t<_allocator> *buffer, const char *filename, const size_t &threads = 0) {
+            compressed_reader_t(filename).read(buffer, threads);
+        }
+
+        // class to define which mechanism async_t uses to run file operations
+        class backend_t {
+        public:
+            static constexpr int uring = 0x0; // io_uring where the kernel allows it, threads otherwise
+            static constexpr int threads = 0x1; // blocking calls on a small thread pool
+        };
+
+        /**
+         * Runs whole-file writes and reads off the calling thread.
+         *
+         * With io_uring every file goes through open, write or read, and close as kernel
+         * requests, completed by a single reaper thread, so thousands of files can be in
+         * flight with one thread. Without io_uring (other platforms, older kernels, seccomp)
+         * the same operations run as blocking calls on a small thread pool.
+         *
+         * Callbacks run on the I/O thread and should return quickly. A buffer must stay alive,
+         * and must not be touched, until its operation completes. `deserialize` resizes the
+         * buffer from the I/O thread, with the buffer's allocator.
+         */
+        class async_t {
+        public:
+            using callback_t = std::function<void(std::exception_ptr)>;
+
+            /**
+             * Starts the backend.
+             *
+             * @param backend One of `backend_t`.
+             * @param threads The number of pool threads when io_uring is not used.
+             */
+            explicit async_t(const int &backend = backend_t::uring, const size_t &threads = 0x4) {
+#ifdef __SERIALIZER_URING__
+                if (backend == backend_t::uring && setup()) {
+                    m_backend = backend_t::uring;
+                    m_workers.emplace_back([this] { reap(); });
+                    return;
+                }
+#else
+                (void) backend;
+#endif
+                m_backend = backend_t::threads;
+                for (size_t i = 0; i < (threads == 0x00 ? 1 : threads); ++i)
+                    m_workers.emplace_back([this] { work(); });
+            }
+
+            // waits for the operations in flight, then stops the I/O threads
+            ~async_t() {
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_stop = true;
+                }
+                m_ready.notify_all();
+#ifdef __SERIALIZER_URING__
+                if (m_backend == backend_t::uring) {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_idle.wait(lock, [this] { return m_inflight == 0x00 && m_backlog.empty(); });
+                    // wake the reaper up so it notices m_stop
+                    if (io_uring_sqe *sqe = next_sqe()) {
+                        sqe->opcode = IORING_OP_NOP;
+                        sqe->user_data = 0x00;
+                        enter(1, 0, 0);
+                    }
+                }
+#endif
+                for (std::thread &worker: m_workers)
+                    worker.join();
+#ifdef __SERIALIZER_URING__
+                if (m_ring_fd >= 0) {
+                    ::munmap(m_sqes, m_sqes_size);
+                    if (m_cq_ring != m_sq_ring)
+                        ::munmap(m_cq_ring, m_cq_size);
+                    ::munmap(m_sq_ring, m_sq_size);
+                    ::close(m_ring_fd);
+                }
+#endif
+            }
+
+            async_t(const async_t &) = delete;
+            async_t &operator=(const async_t &) = delete;
+
+            constexpr int backend() const noexcept { return m_backend; }
+
+            /**
+             * Writes the bytes written so far into `buffer` to `filename`, created or truncated.
+             *
+             * @param done Called with a null `std::exception_ptr` on success, or the error.
+             */
+            template<class _allocator>
+            void serialize(basic_wmemory_t<_allocator> *buffer, const char *filename, callback_t done) {
+                operation_t *operation = new operation_t();
+                operation->filename = filename, operation->done = std::move(done);
+                operation->write = true;
+                operation->data = buffer->data();
+                operation->size = buffer->lens();
+                start(operation);
+            }
+
+            /**
+             * Reads the whole of `filename` into `buffer`, which is resized to the file size.
+             *
+             * @param done Called with a null `std::exception_ptr` on success, or the error.
+             */
+            template<class _allocator>
+            void deserialize(basic_wmemory_t<_allocator> *buffer, const char *filename, callback_t done) {
+                operation_t *operation = new operation_t();
+                operation->filename = filename, operation->done = std::move(done);
+                operation->resize = [buffer](const uintmax_t &size) {
+                    buffer->cleanup();
+                    buffer->resize(size);
+                    return buffer->data();
+                };
+                start(operation);
+            }
+
+        private:
+            struct operation_t {
+                std::string filename;
+                callback_t done;
+                std::function<uint8_t *(const uintmax_t &)> resize; // reads only, sizes the buffer
+                bool write = false;
+                uint8_t *data = nullptr;
+                uintmax_t size = 0x00, transferred = 0x00;
+                int fd = -1;
+                int stage = 0x00; // stage of the request in flight, see reaped()
+                std::exception_ptr error;
+            };
+
+            void start(operation_t *operation) {
+#ifdef __SERIALIZER_URING__
+                if (m_backend == backend_t::uring) {
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        // at most one request per file in flight, so completions can never overflow
+                        if (m_inflight == m_sq_entries) {
+                            m_backlog.push_back(operation);
+                            return;
+                        }
+                        if (submit(operation, stage_open)) {
+                            ++m_inflight;
+                            return;
+                        }
+                    }
+                    finish(operation);
+                    return;
+                }
+#endif
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_backlog.push_back(operation);
+                }
+                m_ready.notify_one();
+            }
+
+            static void finish(operation_t *operation) noexcept {
+                if (operation->done)
+                    operation->done(operation->error);
+                delete operation;
+            }
+
+            // the whole operation as blocking calls, on a pool thread
+            static void run(operation_t *operation) noexcept {
+                int fd = -1;
+                try {
+                    if (operation->write) {
+                        if ((fd = detail::open_write(operation->filename.c_str())) < 0)
+                            throw std::runtime_error("failed to open file");
+                        detail::write_all(fd, operation->data, operation->size);
+                    } else {
+                        std::error_code code;
+                        const uintmax_t size = std::filesystem::file_size(operation->filename, code);
+                        if (code || (fd = detail::open_read(operation->filename.c_str())) < 0)
+                            throw std::runtime_error("failed to open file");
+                        if (size == 0x00)
+                            throw std::invalid_argument("data is null or size is negative");
+                        uint8_t *data = operation->resize(size);
+                        for (uintmax_t done = 0x00; done < size;) {
+                            const uintmax_t count = detail::read_some(fd, data + done, size - done);
+                            if (count == 0x00)
+                                throw std::runtime_error("unexpected end of file");
+                            done += count;
+                        }
+                    }
+                } catch (...) {
+                    operation->error = std::current_exception();
+                }
+                if (fd >= 0)
+                    detail::close(fd);
+                finish(operation);
+            }
+
+            void work() {
+                while (true) {
+                    operation_t *operation;
+                    {
+                        std::unique_lock<std::mutex> lock(m_mutex);
+                        m_ready.wait(lock, [this] { return m_stop || !m_backlog.empty(); });
+                        if (m_backlog.empty())
+                            return;
+                        operation = m_backlog.front();
+                        m_backlog.pop_front();
+                    }
+                    run(operation);
+                }
+            }
+
+#ifdef __SERIALIZER_URING__
+            static constexpr int stage_open = 0x0, stage_transfer = 0x1, stage_close = 0x2;
+            static constexpr uintmax_t max_request = 0x40000000; // the length of a request is 32-bit
+
+            int enter(const unsigned &submit, const unsigned &wait, const unsigned &flags) noexcept {
+                while (true) {
+                    const long result = ::syscall(__NR_io_uring_enter, m_ring_fd, submit, wait, flags, nullptr, 0);
+                    if (result >= 0 || errno != EINTR)
+                        return static_cast<int>(result);
+                }
+            }
+
+            // maps the rings and checks the kernel knows every request used here
+            bool setup() noexcept {
+                io_uring_params params{};
+                m_ring_fd = static_cast<int>(::syscall(__NR_io_uring_setup, 0x100, &params));
+                if (m_ring_fd < 0)
+                    return false;
+                const size_t probe_size = sizeof(io_uring_probe) + 0x100 * sizeof(io_uring_probe_op);
+                const std::unique_ptr<void, void (*)(void *)> memory(std::calloc(1, probe_size), std::free);
+                io_uring_probe *probe = static_cast<io_uring_probe *>(memory.get());
+                bool supported = probe && ::syscall(__NR_io_uring_register, m_ring_fd, IORING_REGISTER_PROBE,
+                                                    probe, 0x100) >= 0;
+                for (const int opcode: {IORING_OP_OPENAT, IORING_OP_READ, IORING_OP_WRITE, IORING_OP_CLOSE})
+                    supported = supported && opcode < probe->ops_len
+                                && (probe->ops[opcode].flags & IO_URING_OP_SUPPORTED);
+                if (supported) {
+                    m_sq_entries = params.sq_entries;
+                    m_sq_size = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+                    m_cq_size = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+                    if (params.features & IORING_FEAT_SINGLE_MMAP)
+                        m_sq_size = m_cq_size = std::max(m_sq_size, m_cq_size);
+                    m_sq_ring = ::mmap(nullptr, m_sq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                       m_ring_fd, IORING_OFF_SQ_RING);
+                    m_cq_ring = params.features & IORING_FEAT_SINGLE_MMAP
+                                    ? m_sq_ring
+                                    : ::mmap(nullptr, m_cq_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                                             m_ring_fd, IORING_OFF_CQ_RING);
+                    m_sqes_size = params.sq_entries * sizeof(io_uring_sqe);
+                    m_sqes = static_cast<io_uring_sqe *>(::mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE,
+                                                                MAP_SHARED | MAP_POPULATE, m_ring_fd, IORING_OFF_SQES));
+                    supported = m_sq_ring != MAP_FAILED && m_cq_ring != MAP_FAILED && m_sqes != MAP_FAILED;
+                }
+                if (!supported) {
+                    if (m_sq_ring && m_sq_ring != MAP_FAILED)
+                        ::munmap(m_sq_ring, m_sq_size);
+                    if (m_cq_ring && m_cq_ring != MAP_FAILED && m_cq_ring != m_sq_ring)
+                        ::munmap(m_cq_ring, m_cq_size);
+                    if (m_sqes && m_sqes != MAP_FAILED)
+                        ::munmap(m_sqes, m_sqes_size);
+                    ::close(m_ring_fd);
+                    m_ring_fd = -1;
+                    return false;
+                }
+                uint8_t *sq = static_cast<uint8_t *>(m_sq_ring), *cq = static_cast<uint8_t *>(m_cq_ring);
+                m_sq_tail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+                m_sq_mask = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+                m_sq_array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+                m_cq_head = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+                m_cq_tail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+                m_cq_mask = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+                m_cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+                return true;
+            }
+
+            // next free submission entry, called with m_mutex held; the kernel consumes each one in enter()
+            io_uring_sqe *next_sqe() noexcept {
+                const unsigned tail = *m_sq_tail, index = tail & m_sq_mask;
+                io_uring_sqe *sqe = m_sqes + index;
+                _STD memset(sqe, 0x00, sizeof(io_uring_sqe));
+                m_sq_array[index] = index;
+                std::atomic_ref<unsigned>(*m_sq_tail).store(tail + 1, std::memory_order_release);
+                return sqe;
+            }
+
+            // queues the next request of `operation`, called with m_mutex held, false if it is over on error
+            bool submit(operation_t *operation, const int &stage) noexcept {
+                operation->stage = stage;
+                io_uring_sqe *sqe = next_sqe();
+                sqe->user_data = reinterpret_cast<uintptr_t>(operation);
+                if (stage == stage_open) {
+                    sqe->opcode = IORING_OP_OPENAT;
+                    sqe->fd = AT_FDCWD;
+                    sqe->addr = reinterpret_cast<uintptr_t>(operation->filename.c_str());
+                    sqe->open_flags = operation->write ? O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC : O_RDONLY | O_CLOEXEC;
+                    sqe->len = 0644;
+                } else if (stage == stage_transfer) {
+                    sqe->opcode = operation->write ? IORING_OP_WRITE : IORING_OP_READ;
+                    sqe->fd = operation->fd;
+                    sqe->addr = reinterpret_cast<uintptr_t>(operation->data + operation->transferred);
+                    sqe->len = static_cast<unsigned>(std::min(operation->size - operation->transferred, max_request));
+                    sqe->off = operation->transferred;
+                } else {
+                    sqe->opcode = IORING_OP_CLOSE;
+                    sqe->fd = operation->fd;
+                }
+                if (enter(1, 0, 0) == 1)
+                    return true;
+                // take the entry back so a later enter() does not submit it, the file is given up
+                std::atomic_ref<unsigned>(*m_sq_tail).store(*m_sq_tail - 1, std::memory_order_release);
+                if (operation->fd >= 0)
+                    ::close(operation->fd);
+                if (!operation->error)
+                    operation->error = std::make_exception_ptr(std::runtime_error("failed to submit request"));
+                return false;
+            }
+
+            // moves `operation` on after the completion of its request, returns true once it is over
+            bool reaped(operation_t *operation, const int &result) noexcept {
+                if (operation->stage == stage_open) {
+                    if (result < 0) {
+                        operation->error = std::make_exception_ptr(std::runtime_error("failed to open file"));
+                        return true;
+                    }
+                    operation->fd = result;
+                    if (!operation->write) {
+                        try {
+                            struct stat status{};
+                            if (::fstat(operation->fd, &status) != 0)
+                                throw std::runtime_error("failed to open file");
+                            if (status.st_size <= 0)
+                                throw std::invalid_argument("data is null or size is negative");
+                            operation->size = static_cast<uintmax_t>(status.st_size);
+                            operation->data = operation->resize(operation->size);
+                        } catch (...) {
+                            operation->error = std::current_exception();
+                            return !queue(operation, stage_close);
+                        }
+                    }
+                    return !queue(operation, operation->size != 0x00 ? stage_transfer : stage_close);
+                }
+                if (operation->stage == stage_transfer) {
+                    stats::add(operation->write ? stats::counter_t::io_writes : stats::counter_t::io_reads);
+                    if (result <= 0) {
+                        stats::add(stats::counter_t::io_errors);
+                        operation->error = std::make_exception_ptr(std::runtime_error(
+                            result == 0 ? "unexpected end of file" : operation->write ? "failed to write file"
+                                                                                    : "failed to read file"));
+                        return !queue(operation, stage_close);
+                    }
+                    stats::add(operation->write ? stats::counter_t::io_write_bytes : stats::counter_t::io_read_bytes, result);
+                    operation->transferred += result;
+                    return !queue(operation, operation->transferred < operation->size ? stage_transfer : stage_close);
+                }
+                if (result < 0 && !operation->error)
+                    operation->error = std::make_exception_ptr(std::runtime_error("failed to close file"));
+                return true;
+            }
+
+            bool queue(operation_t *operation, const int &stage) noexcept {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                return submit(operation, stage);
+            }
+
+            void reap() {
+                std::vector<operation_t *> finished;
+                std::vector<std::pair<operation_t *, int> > completed;
+                while (true) {
+                    unsigned head = *m_cq_head;
+                    const unsigned tail = std::atomic_ref<unsigned>(*m_cq_tail).load(std::memory_order_acquire);
+                    if (head == tail) {
+                        {
+                            std::lock_guard<std::mutex> lock(m_mutex);
+                            if (m_stop && m_inflight == 0x00)
+                                return;
+                        }
+                        enter(0, 1, IORING_ENTER_GETEVENTS);
+                        continue;
+                    }
+                    for (; head != tail; ++head) {
+                        const io_uring_cqe &cqe = m_cqes[head & m_cq_mask];
+                        if (cqe.user_data != 0x00)
+                            completed.emplace_back(reinterpret_cast<operation_t *>(cqe.user_data), cqe.res);
+                    }
+                    std::atomic_ref<unsigned>(*m_cq_head).store(head, std::memory_order_release);
+                    {
+                        // operations reach this thread through the kernel, pair with the submitter's unlock
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                    }
+                    for (const auto &[operation, result]: completed)
+                        if (reaped(operation, result))
+                            finished.push_back(operation);
+                    completed.clear();
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        // every finished file frees a slot for a waiting one
+                        for (size_t i = 0; i < finished.size(); ++i) {
+                            if (m_backlog.empty()) {
+                                --m_inflight;
+                                continue;
+                            }
+                            operation_t *operation = m_backlog.front();
+                            m_backlog.pop_front();
+                            if (!submit(operation, stage_open))
+                                finished.push_back(operation);
+                        }
+                    }
+                    for (operation_t *operation: finished)
+                        finish(operation);
+                    if (!finished.empty()) {
+                        finished.clear();
+                        m_idle.notify_all();
+                    }
+                }
+            }
+#endif
+
+        private:
+            int m_backend = backend_t::threads; // backend actually in use
+            std::mutex m_mutex; // guards the submission ring, m_backlog, m_inflight and m_stop
+            std::condition_variable m_ready; // pool threads wait for work
+            std::condition_variable m_idle; // signalled whenever files complete
+            std::deque<operation_t *> m_backlog; // operations waiting for a pool thread or a ring slot
+            std::vector<std::thread> m_workers; // the reaper, or the pool threads
+            bool m_stop = false;
+#ifdef __SERIALIZER_URING__
+            int m_ring_fd = -1;
+            unsigned m_sq_entries = 0x00; // also the bound on files in flight
+            unsigned m_inflight = 0x00; // files with a request in the kernel
+            void *m_sq_ring = nullptr, *m_cq_ring = nullptr;
+            size_t m_sq_size = 0x00, m_cq_size = 0x00, m_sqes_size = 0x00;
+            io_uring_sqe *m_sqes = nullptr;
+            io_uring_cqe *m_cqes = nullptr;
+            unsigned *m_sq_tail = nullptr, *m_sq_array = nullptr, *m_cq_head = nullptr, *m_cq_tail = nullptr;
+            unsigned m_sq_mask = 0x00, m_cq_mask = 0x00;
+#endif
+        };
+
+        // engine behind serialize_async / deserialize_async, started on first use
+        inline async_t &default_async() {
+            static async_t engine;
+            return engine;
+        }
+
+        /**
+         * Writes the buffer to `filename` without blocking the caller.
+         *
+         * @param buffer The buffer to write, it must stay alive and unchanged until completion.
+         * @param filename The name of the file to create or truncate.
+         *
+         * @return A future that becomes ready once the file is closed, it holds the error if any.
+         */
+        template<class _allocator>
+        std::future<void> serialize_async(basic_wmemory_t<_allocator> *buffer, const char *filename) {
+            std::shared_ptr<std::promise<void> > promise = std::make_shared<std::promise<void> >();
+            std::future<void> future = promise->get_future();
+            default_async().serialize(buffer, filename, [promise](std::exception_ptr error) {
+                error ? promise->set_exception(error) : promise->set_value();
+            });
+            return future;
+        }
+
+        template<class _allocator>
+        void serialize_async(basic_wmemory_t<_allocator> *buffer, const char *filename, async_t::callback_t done) {
+            default_async().serialize(buffer, filename, std::move(done));
+        }
+
+        /**
+         * Reads `filename` into the buffer without blocking the caller.
+         *
+         * @param buffer The buffer to fill, resized to the file size; it must stay alive until completion.
+         * @param filename The name of the file to read.
+         *
+         * @return A future that becomes ready once the file is read, it holds the error if any.
+         */
+        template<class _allocator>
+        std::future<void> deserialize_async(basic_wmemory_t<_allocator> *buffer, const char *filename) {
+            std::shared_ptr<std::promise<void> > promise = std::make_shared<std::promise<void> >();
+            std::future<void> future = promise->get_future();
+            default_async().deserialize(buffer, filename, [promise](std::exception_ptr error) {
+                error ? promise->set_exception(error) : promise->set_value();
+            });
+            return future;
+        }
+
+        template<class _allocator>
+        void deserialize_async(basic_wmemory_t<_allocator> *buffer, const char *filename, async_t::callback_t done) {
+            default_async().deserialize(buffer, filename, std::move(done));
+        }
+    }
+    namespace detail {
+        inline void format_helper(std::stringstream &ss, const std::string &format) {
+            ss << format; // Base case: no more placeholders
+        }
+
+        template<typename T, typename... Args>
+        void format_helper(std::stringstream &ss, const std::string &format, T value, Args... args) {
+            size_t pos = format.find("{}");
+            if (pos == std::string::npos) {
+                throw std::invalid_argument("Too many arguments provided to format string.");
+            }
+            ss << format.substr(0, pos) << value;
+            format_helper(ss, format.substr(pos + 2), args...);
+        }
+
+        // types format_to converts without going through a stream
+        template<class _typename>
+        concept formattable = std::is_arithmetic_v<_typename> || std::is_convertible_v<const _typename &, std::string_view>;
+
+        // the most characters format_value can write for `value`
+        template<class _typename>
+        constexpr uintmax_t format_bound(const _typename &value) noexcept {
+            if constexpr (std::is_same_v<_typename, char> || std::is_same_v<_typename, bool>)
+                return 1;
+            else if constexpr (std::is_integral_v<_typename>)
+                return std::numeric_limits<_typename>::digits10 + 2; // every digit and the sign
+            else if constexpr (std::is_floating_point_v<_typename>)
+                return std::numeric_limits<_typename>::max_digits10 + 12; // sign, point and exponent
+            else return std::string_view(value).size();
+        }
+
+        // writes `value` at `out`, returns the end of it or null if it doesn't fit before `end`
+        template<class _typename>
+        inline char *format_value(char *out, const char *end, const _typename &value) noexcept {
+            if constexpr (std::is_same_v<_typename, char> || std::is_same_v<_typename, bool>) {
+                if (out == end)
+                    return nullptr;
+                *out = std::is_same_v<_typename, bool> ? char('0' + value) : char(value);
+                return out + 1;
+            } else if constexpr (std::is_arithmetic_v<_typename>) {
+                const std::to_chars_result result = std::to_chars(out, const_cast<char *>(end), value);
+                return result.ec == std::errc() ? result.ptr : nullptr;
+            } else {
+                const std::string_view str = value;
+                if (str.size() > uintmax_t(end - out))
+                    return nullptr;
+                _STD memcpy(out, str.data(), str.size());
+                return out + str.size();
+            }
+        }
+
+        // writes the pattern with every placeholder replaced, returns null if it doesn't fit
+        template<class _format, class... _args>
+        inline char *format_into(char *out, const char *end, const _format &fmt, const _args &... args) noexcept {
+            const std::string_view pattern = fmt.pattern();
+            size_t start = 0, index = 0;
+            const auto literal = [&](const size_t &stop) {
+                if (out == nullptr || stop - start > uintmax_t(end - out))
+                    return out = nullptr, void();
+                _STD memcpy(out, pattern.data() + start, stop - start);
+                out += stop - start;
+            };
+            ((literal(fmt.offsets()[index]),
+              out = out ? format_value(out, end, args) : nullptr,
+              start = fmt.offsets()[index++] + 2), ...);
+            literal(pattern.size());
+            return out;
+        }
+    }
+
+    template<typename... Args>
+    std::string format(const std::string &fmt, Args... args) {
+        std::stringstream ss;
+        detail::format_helper(ss, fmt, args...);
+        return ss.str();
+    }
+
+    /**
+     * Format pattern checked and parsed at compile time, built implicitly from a string literal.
+     *
+     * The literal must hold exactly one `{}` per argument, anything else is a compile error.
+     * Only the placeholder offsets are kept, formatting never searches the pattern.
+     */
+    template<class... _args>
+    class basic_format_string_t {
+    public:
+        template<size_t _size>
+        consteval basic_format_string_t(const char (&pattern)[_size]) : m_pattern(pattern, _size - 1) {
+            size_t found = 0;
+            for (size_t i = 0; i + 1 < m_pattern.size(); ++i) {
+                if (m_pattern[i] != '{' || m_pattern[i + 1] != '}')
+                    continue;
+                if (found == sizeof...(_args))
+                    throw std::invalid_argument("more placeholders than arguments in format string");
+                m_offsets[found++] = i++;
+            }
+            if (found != sizeof...(_args))
+                throw std::invalid_argument("more arguments than placeholders in format string");
+        }
+
+        constexpr std::string_view pattern() const noexcept { return m_pattern; }
+
+        // offset of every `{}` in the pattern
+        constexpr const std::array<size_t, sizeof...(_args)> &offsets() const noexcept { return m_offsets; }
+
+        // characters of the pattern written as they are
+        constexpr size_t literals() const noexcept { return m_pattern.size() - 2 * sizeof...(_args); }
+
+    private:
+        std::string_view m_pattern;
+        std::array<size_t, sizeof...(_args)> m_offsets{};
+    };
+
+    template<class... _args>
+    using format_string_t = basic_format_string_t<std::type_identity_t<_args>...>;
+
+    /**
+     * Formats the arguments into a caller buffer, without allocating.
+     *
+     * Integers and floating-point values are converted with `std::to_chars`, floating-point
+     * values in their shortest round-trip form. `char` is written as a character, other
+     * integers (`uint8_t` included) as numbers and `bool` as `0` or `1`.
+     *
+     * @param out The buffer to write into, no terminating null is added.
+     * @param fmt A string literal with one `{}` per argument, checked at compile time.
+     * @param args Arithmetic values or anything convertible to `std::string_view`.
+     *
+     * @return The number of characters written.
+     *
+     * @throws std::length_error If the result doesn't fit in `out`.
+     */
+    template<detail::formattable... _args>
+    size_t format_to(const std::span<char> &out, format_string_t<_args...> fmt, const _args &... args) {
+        const char *end = detail::format_into(out.data(), out.data() + out.size(), fmt, args...);
+        if (end == nullptr)
+            throw std::length_error("formatted text exceeds the output buffer");
+        return end - out.data();
+    }
+
+    /**
+     * Appends the formatted text to the buffer as raw characters, without a length prefix.
+     *
+     * A `policy_t::growable` buffer grows at most once per call, see the other overload for the
+     * formatting rules.
+     *
+     * @throws std::runtime_error If the buffer size is exceeded and the buffer can't grow.
+     */
+    template<class _allocator, detail::formattable... _args>
+    void format_to(basic_wmemory_t<_allocator> *buffer, format_string_t<_args...> fmt, const _args &... args) {
+        const uintmax_t bound = fmt.literals() + (detail::format_bound(args) + ... + 0);
+        if (!buffer->is_enough(bound) && buffer->policy() == policy_t::growable)
+            buffer->reserve(std::max(buffer->size() * 2, buffer->lens() + bound));
+        char *start = reinterpret_cast<char *>(buffer->data() + buffer->lens());
+        const char *end = detail::format_into(start, reinterpret_cast<char *>(buffer->data() + buffer->size()), fmt, args...);
+        if (end == nullptr)
+            throw std::runtime_error("maximum buffer size exceeded");
+        buffer->skip(end - start);
+    }
+
+    namespace detail {
+        // integers group_digit accepts, at most 64 bits wide
+        template<class _typename>
+        concept groupable = std::integral<_typename> && !std::same_as<_typename, bool> && sizeof(_typename) <= 8;
+
+        // "00" to "99", two digits per lookup
+        constexpr std::array<char, 200> digit_pairs = [] {
+            std::array<char, 200> pairs{};
+            for (int i = 0; i < 100; ++i)
+                pairs[2 * i] = char('0' + i / 10), pairs[2 * i + 1] = char('0' + i % 10);
+            return pairs;
+        }();
+
+        // the most characters a grouped `_typename` can take
+        template<class _typename>
+        constexpr size_t grouped_max() noexcept {
+            constexpr size_t digits = std::numeric_limits<std::make_unsigned_t<_typename> >::digits10 + 1;
+            return digits + (digits - 1) / 3 + std::is_signed_v<_typename>;
+        }
+
+        // magnitude of `number`, defined for the minimum signed value too
+        template<class _typename>
+        constexpr uint64_t magnitude(const _typename &number) noexcept {
+            if constexpr (std::is_signed_v<_typename>)
+                return number < 0 ? uint64_t(0) - uint64_t(number) : uint64_t(number);
+            else return number;
+        }
+
+        // number of decimal digits, without branches: log10 estimated from the bit width, then corrected
+        inline size_t count_digits(const uint64_t &value) noexcept {
+            constexpr std::array<uint64_t, 20> powers = [] {
+                std::array<uint64_t, 20> table{};
+                table[0] = 1;
+                for (size_t i = 1; i < table.size(); ++i)
+                    table[i] = table[i - 1] * 10;
+                return table;
+            }();
+            const uint64_t odd = value | 1; // same digit count, and log2 defined for 0
+            const size_t estimate = size_t(std::bit_width(odd)) * 1233 >> 12;
+            return estimate + 1 - (odd < powers[estimate]);
+        }
+
+        template<class _typename>
+        inline size_t grouped_size(const _typename &number) noexcept {
+            const size_t digits = count_digits(magnitude(number));
+            if constexpr (std::is_signed_v<_typename>)
+                return digits + (digits - 1) / 3 + (number < 0);
+            else return digits + (digits - 1) / 3;
+        }
+
+        // writes the grouped `number` backwards so that it ends at `end`
+        template<class _typename>
+        inline void write_grouped(char *end, const _typename &number, const char &separator) noexcept {
+            uint64_t value = magnitude(number);
+            char *out = end;
+            for (; value >= 1000; value /= 1000) {
+                const uint64_t group = value % 1000;
+                out -= 4;
+                out[0] = separator;
+                out[1] = char('0' + group / 100);
+                _STD memcpy(out + 2, &digit_pairs[(group % 100) * 2], 2);
+            }
+            if (value >= 100) {
+                out -= 3;
+                out[0] = char('0' + value / 100);
+                _STD memcpy(out + 1, &digit_pairs[(value % 100) * 2], 2);
+            } else if (value >= 10) {
+                out -= 2;
+                _STD memcpy(out, &digit_pairs[value * 2], 2);
+            } else *--out = char('0' + value);
+            if constexpr (std::is_signed_v<_typename>)
+                if (number < 0)
+                    *--out = '-';
+        }
+    }
+
+    /**
+     * Writes `number` with a separator between every group of three digits, e.g. `-1,234,567`.
+     *
+     * @param out The buffer to write into, no terminating null is added.
+     * @param number Any integer up to 64 bits, its minimum value included.
+     * @param separator The character between two groups.
+     *
+     * @return The number of characters written.
+     *
+     * @throws std::length_error If the result doesn't fit in `out`.
+     */
+    template<detail::groupable _typename>
+    size_t group_digit(const std::span<char> &out, const _typename &number, const char &separator = ',') {
+        const size_t size = detail::grouped_size(number);
+        if (size > out.size())
+            throw std::length_error("grouped number exceeds the output buffer");
+        detail::write_grouped(out.data() + size, number, separator);
+        return size;
+    }
+
+    template<detail::groupable IntegerType>
+    std::string group_digit(IntegerType number, char separator = ',') {
+        char buffer[detail::grouped_max<IntegerType>()];
+        return std::string(buffer, group_digit(buffer, number, separator));
+    }
+
+    /**
+     * Writes every number of a range grouped like `group_digit`, each one followed by `delimiter`,
+     * into one contiguous output.
+     *
+     * @param out The buffer to write into, `numbers.size()` times the longest grouped number
+     *            plus its delimiter always fits.
+     * @param numbers Any contiguous range of integers.
+     *
+     * @return The number of characters written.
+     *
+     * @throws std::length_error If the result doesn't fit in `out`.
+     */
+    template<std::ranges::contiguous_range _range>
+        requires detail::groupable<std::ranges::range_value_t<_range> >
+    size_t group_digits(const std::span<char> &out, const _range &numbers, const char &separator = ',',
+                        const char &delimiter = '\n') {
+        char *position = out.data(), *const end = out.data() + out.size();
+        for (const auto &number: numbers) {
+            const size_t size = detail::grouped_size(number);
+            if (size >= uintmax_t(end - position))
+                throw std::length_error("grouped numbers exceed the output buffer");
+            detail::write_grouped(position + size, number, separator);
+            position[size] = delimiter;
+            position += size + 1;
+        }
+        return position - out.data();
+    }
+
+    template<std::ranges::contiguous_range _range>
+        requires detail::groupable<std::ranges::range_value_t<_range> >
+    std::string group_digits(const _range &numbers, const char &separator = ',', const char &delimiter = '\n') {
+        using _typename = std::ranges::range_value_t<_range>;
+        std::string text(std::ranges::size(numbers) * (detail::grouped_max<_typename>() + 1), '\0');
+        text.resize(group_digits(text, numbers, separator, delimiter));
+        return text;
+    }
+
+#ifdef __SERIALIZER_HEAP_SIZE__
+    constexpr size_t HEAP_SIZE = __SERIALIZER_HEAP_SIZE__; // size of the default heap, set before including
+#else
+    constexpr size_t HEAP_SIZE = 1024 * 1024; // 1 MB
+#endif
+    constexpr size_t ALIGNMENT = 8;
+
+    // Align utility
+    inline size_t align(size_t size) {
+        return (size + (ALIGNMENT - 1)) & ~(ALIGNMENT - 1);
+    }
+
+    // Block header structure
+    struct BlockHeader {
+        size_t size;
+        bool is_free;
+        BlockHeader *next; // next block in address order
+        BlockHeader *prev; // previous block in address order, the boundary tag used to coalesce
+        BlockHeader *next_free; // links of the segregated free list the block is in, if free
+        BlockHeader *prev_free;
+    };
+
+    // Static memory pool of the default heap
+    alignas(ALIGNMENT) inline uint8_t heap[HEAP_SIZE];
+    inline BlockHeader *free_list = reinterpret_cast<BlockHeader *>(heap);
+
+    /**
+     * Two-level segregated fit mapping of the free blocks (TLSF).
+     *
+     * The first level splits sizes by power of two, the second level splits each power of
+     * two in `SL_COUNT` linear ranges. Two bitmaps record which lists are non-empty, so
+     * finding a free block that fits is a couple of bit scans instead of a walk of the heap.
+     */
+    namespace tlsf {
+        constexpr size_t SL_LOG2 = 4;
+        constexpr size_t SL_COUNT = size_t(1) << SL_LOG2;
+        constexpr size_t FL_SHIFT = SL_LOG2 + 3; // log2(ALIGNMENT), sizes below 128 share the first list
+        constexpr size_t SMALL_BLOCK = size_t(1) << FL_SHIFT;
+        constexpr size_t FL_COUNT = sizeof(size_t) * 8 - FL_SHIFT + 1;
+
+        // list a free block of `size` bytes belongs to
+        inline void mapping_insert(const size_t &size, size_t &fl, size_t &sl) {
+            if (size < SMALL_BLOCK) {
+                fl = 0x00;
+                sl = size / (SMALL_BLOCK / SL_COUNT);
+            } else {
+                const size_t msb = std::bit_width(size) - 1;
+                sl = (size >> (msb - SL_LOG2)) ^ SL_COUNT;
+                fl = msb - (FL_SHIFT - 1);
+            }
+        }
+
+        // first list whose blocks are all at least `size` bytes
+        inline void mapping_search(size_t size, size_t &fl, size_t &sl) {
+            if (size >= SMALL_BLOCK)
+                size += (size_t(1) << (std::bit_width(size) - 1 - SL_LOG2)) - 1;
+            mapping_insert(size, fl, sl);
         }
+    }
+
+    namespace detail {
+        // memory_resource handing out whole pages straight from mmap
+        class mmap_resource_t : public std::pmr::memory_resource {
+        protected:
+            void *do_allocate(size_t bytes, size_t alignment) override {
+#ifdef __SERIALIZER_POSIX__
+                (void) alignment; // page aligned
+                void *data = ::mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (data == MAP_FAILED)
+                    throw std::bad_alloc();
+                return data;
+#else
+                return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+#endif
+            }
+
+            void do_deallocate(void *ptr, size_t bytes, size_t alignment) override {
+#ifdef __SERIALIZER_POSIX__
+                (void) alignment;
+                ::munmap(ptr, bytes);
+#else
+                std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+#endif
+            }
 
+            bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+                return this == &other;
+            }
+        };
+    }
+
+    // memory_resource backed by anonymous mmap, to give heaps and arenas their own pages
+    inline std::pmr::memory_resource *mmap_resource() noexcept {
+        static detail::mmap_resource_t instance;
+        return &instance;
+    }
+
+    /**
+     * General purpose heap over a caller-chosen region: segregated fit allocation and
+     * constant time coalescing, see `alloc_` / `free_` which use the default instance.
+     *
+     * The region comes from static storage, or from a parent `std::pmr::memory_resource`
+     * (`mmap_resource()`, another heap, an arena...). The heap is itself a memory resource.
+     * An instance is not thread-safe, see `concurrent` for that.
+     */
+    class heap_t : public std::pmr::memory_resource {
+    public:
         /**
-         * Retrieves a long value from the buffer.
+         * Creates a heap over memory owned by the caller, e.g. a static array.
          *
-         * This function reads a long value from the buffer starting at the current
-         * position (`m_lens`), updates the current position, and returns the value.
-         * If the buffer is empty (i.e., `m_size` is zero), it returns -1.
+         * @param memory The region to allocate from, aligned to `ALIGNMENT`.
+         * @param size The size of the region. Must be larger than a `BlockHeader`.
          *
-         * @return The long value read from the buffer, or -1 if the buffer is empty.
+         * @throws std::invalid_argument If the region is null or too small.
          */
-        const long get_long() noexcept(true) {
-            if (m_size != 0x00) {
-                const long value = *(long *) &buffer.data()[m_lens];
-                m_lens += sizeof(long);
-                return value;
+        heap_t(void *memory, const size_t &size) {
+            if (memory == nullptr)
+                throw std::invalid_argument("memory is null or size is too small");
+            checked_size(size);
+            m_memory = static_cast<uint8_t *>(memory);
+            m_size = size & ~(ALIGNMENT - 1);
+            initialize();
+        }
+
+        /**
+         * Creates a heap of the given size, its region is allocated from `upstream`.
+         *
+         * @param size The size of the heap. Must be larger than a `BlockHeader`.
+         * @param upstream The parent allocator the region is taken from and given back to.
+         *
+         * @throws std::invalid_argument If the size is too small.
+         */
+        explicit heap_t(const size_t &size, std::pmr::memory_resource *upstream = mmap_resource())
+            : heap_t(upstream->allocate(checked_size(size), ALIGNMENT), size) {
+            m_upstream = upstream;
+            m_reserved = size;
+        }
+
+        ~heap_t() override {
+            if (m_upstream != nullptr)
+                m_upstream->deallocate(m_memory, m_reserved, ALIGNMENT);
+        }
+
+        heap_t(const heap_t &) = delete;
+
+        heap_t &operator=(const heap_t &) = delete;
+
+        /**
+         * Marks the whole region as one free block, invalidating every allocation.
+         *
+         * Only the first block header is written, the rest of the region is left untouched
+         * so a large mapped heap doesn't fault its pages in up front.
+         */
+        void initialize() noexcept {
+            m_fl_bitmap = 0x00;
+            std::fill(std::begin(m_sl_bitmap), std::end(m_sl_bitmap), 0x00);
+#ifdef __SERIALIZER_STATS__
+            m_used = m_peak = m_free_blocks = 0x00;
+#endif
+            for (auto &lists: m_blocks)
+                std::fill(std::begin(lists), std::end(lists), nullptr);
+
+            BlockHeader *first = blocks();
+            first->size = m_size - sizeof(BlockHeader);
+            first->is_free = true;
+            first->next = nullptr;
+            first->prev = nullptr;
+            insert(first);
+        }
+
+        /**
+         * Allocates a block of memory of the specified size.
+         *
+         * A free block that fits is found in constant time through the segregated free lists,
+         * whatever the number of blocks in the heap.
+         *
+         * @param size The size of the memory block to allocate. Must be greater than zero.
+         *
+         * @return A pointer to the allocated memory block. Returns `nullptr` if the size is zero or if no suitable free block is found.
+         */
+        void *alloc(size_t size) noexcept {
+            if (size == 0 || size > m_size) {
+                return nullptr;
             }
-            return -1;
+
+            size = align(size);
+
+            BlockHeader *current = find(size);
+            if (current == nullptr) {
+                return nullptr;
+            }
+            remove(current);
+
+            // Split the block if it's larger than needed
+            if (current->size >= size + sizeof(BlockHeader) + ALIGNMENT) {
+                BlockHeader *new_block = reinterpret_cast<BlockHeader *>(
+                    reinterpret_cast<uint8_t *>(current) + sizeof(BlockHeader) + size);
+                new_block->size = current->size - size - sizeof(BlockHeader);
+                new_block->is_free = true;
+                new_block->next = current->next;
+                new_block->prev = current;
+                if (new_block->next != nullptr)
+                    new_block->next->prev = new_block;
+                insert(new_block);
+
+                current->size = size;
+                current->next = new_block;
+            }
+
+            current->is_free = false;
+#ifdef __SERIALIZER_STATS__
+            m_used += current->size;
+            m_peak = std::max(m_peak, m_used);
+#endif
+            return reinterpret_cast<void *>(reinterpret_cast<uint8_t *>(current) + sizeof(BlockHeader));
+        }
+
+        /**
+         * Frees the memory block pointed to by `ptr` and marks it as free,
+         * allowing it to be reused in future memory allocations.
+         *
+         * The block is merged with its free physical neighbours, found through the `next` / `prev`
+         * boundary tags, before going back to the segregated free lists. It takes constant time.
+         *
+         * @param ptr Pointer to the memory block to be freed. If `ptr` is `nullptr`, the function does nothing.
+         */
+        void free(void *ptr) noexcept {
+            if (ptr == nullptr) {
+                return;
+            }
+
+            BlockHeader *block = reinterpret_cast<BlockHeader *>(
+                reinterpret_cast<uint8_t *>(ptr) - sizeof(BlockHeader));
+            block->is_free = true;
+#ifdef __SERIALIZER_STATS__
+            m_used -= block->size;
+#endif
+
+            // Coalesce with the free neighbours
+            BlockHeader *next = block->next;
+            if (next != nullptr && next->is_free) {
+                remove(next);
+                block->size += next->size + sizeof(BlockHeader);
+                block->next = next->next;
+                if (block->next != nullptr)
+                    block->next->prev = block;
+            }
+            BlockHeader *previous = block->prev;
+            if (previous != nullptr && previous->is_free) {
+                remove(previous);
+                previous->size += block->size + sizeof(BlockHeader);
+                previous->next = block->next;
+                if (previous->next != nullptr)
+                    previous->next->prev = previous;
+                block = previous;
+            }
+            insert(block);
+        }
+
+        // first block of the heap in address order
+        BlockHeader *blocks() const noexcept { return reinterpret_cast<BlockHeader *>(m_memory); }
+
+        constexpr uint8_t *data() const noexcept { return m_memory; }
+        constexpr size_t size() const noexcept { return m_size; }
+
+        // size of the largest free block, the most a single allocation can get right now
+        size_t largest_free() const noexcept {
+            if (m_fl_bitmap == 0x00)
+                return 0x00;
+            const size_t fl = std::bit_width(m_fl_bitmap) - 1;
+            size_t largest = 0x00;
+            for (BlockHeader *block = m_blocks[fl][std::bit_width(m_sl_bitmap[fl]) - 1]; block != nullptr;
+                 block = block->next_free)
+                largest = std::max(largest, block->size);
+            return largest;
+        }
+
+#ifdef __SERIALIZER_STATS__
+        // bytes handed out and not freed yet, block headers excluded
+        constexpr size_t used() const noexcept { return m_used; }
+
+        // highest `used()` since the heap was initialized
+        constexpr size_t peak() const noexcept { return m_peak; }
+
+        constexpr size_t free_blocks() const noexcept { return m_free_blocks; }
+#endif
+
+    protected:
+        void *do_allocate(size_t bytes, size_t alignment) override {
+            if (alignment > ALIGNMENT)
+                throw std::bad_alloc();
+            void *ptr = alloc(bytes);
+            if (ptr == nullptr)
+                throw std::bad_alloc();
+            return ptr;
+        }
+
+        void do_deallocate(void *ptr, size_t, size_t) override {
+            free(ptr);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+            return this == &other;
+        }
+
+    private:
+        // checked before the region is taken from the upstream, so a rejected size leaks nothing
+        static const size_t &checked_size(const size_t &size) {
+            if (size <= sizeof(BlockHeader) + ALIGNMENT)
+                throw std::invalid_argument("size is too small");
+            return size;
+        }
+
+        void insert(BlockHeader *block) noexcept {
+            size_t fl, sl;
+            tlsf::mapping_insert(block->size, fl, sl);
+            block->prev_free = nullptr;
+            block->next_free = m_blocks[fl][sl];
+            if (block->next_free != nullptr)
+                block->next_free->prev_free = block;
+            m_blocks[fl][sl] = block;
+            m_fl_bitmap |= uint64_t(1) << fl;
+            m_sl_bitmap[fl] |= uint32_t(1) << sl;
+#ifdef __SERIALIZER_STATS__
+            ++m_free_blocks;
+#endif
+        }
+
+        void remove(BlockHeader *block) noexcept {
+            size_t fl, sl;
+            tlsf::mapping_insert(block->size, fl, sl);
+            if (block->prev_free != nullptr)
+                block->prev_free->next_free = block->next_free;
+            else
+                m_blocks[fl][sl] = block->next_free;
+            if (block->next_free != nullptr)
+                block->next_free->prev_free = block->prev_free;
+            if (m_blocks[fl][sl] == nullptr) {
+                m_sl_bitmap[fl] &= ~(uint32_t(1) << sl);
+                if (m_sl_bitmap[fl] == 0x00)
+                    m_fl_bitmap &= ~(uint64_t(1) << fl);
+            }
+#ifdef __SERIALIZER_STATS__
+            --m_free_blocks;
+#endif
+        }
+
+        /**
+         * Finds a free block of at least `size` bytes.
+         *
+         * The rounded-up search takes constant time. When it fails, the only blocks that may
+         * still fit are in the list `size` itself maps to, which is walked as a last resort.
+         */
+        BlockHeader *find(const size_t &size) const noexcept {
+            size_t fl, sl;
+            tlsf::mapping_search(size, fl, sl);
+            if (fl < tlsf::FL_COUNT) {
+                const uint32_t sl_map = m_sl_bitmap[fl] & (~uint32_t(0) << sl);
+                const uint64_t fl_map = fl + 1 < tlsf::FL_COUNT ? m_fl_bitmap & (~uint64_t(0) << (fl + 1)) : 0x00;
+                if (sl_map != 0x00)
+                    return m_blocks[fl][std::countr_zero(sl_map)];
+                if (fl_map != 0x00) {
+                    fl = std::countr_zero(fl_map);
+                    return m_blocks[fl][std::countr_zero(m_sl_bitmap[fl])];
+                }
+            }
+            tlsf::mapping_insert(size, fl, sl);
+            for (BlockHeader *block = m_blocks[fl][sl]; block != nullptr; block = block->next_free)
+                if (block->size >= size)
+                    return block;
+            return nullptr;
         }
 
+    private:
+        uint8_t *m_memory = nullptr; // region the blocks live in
+        size_t m_size = 0x00; // size of the region
+        std::pmr::memory_resource *m_upstream = nullptr; // owner of the region, nullptr if it is the caller
+        size_t m_reserved = 0x00; // size requested from m_upstream, m_size rounded it down
+        uint64_t m_fl_bitmap = 0x00; // non-empty first level lists
+        uint32_t m_sl_bitmap[tlsf::FL_COUNT] = {}; // non-empty second level lists
+        BlockHeader *m_blocks[tlsf::FL_COUNT][tlsf::SL_COUNT] = {}; // heads of the segregated free lists
+#ifdef __SERIALIZER_STATS__
+        size_t m_used = 0x00; // bytes allocated
+        size_t m_peak = 0x00; // high-water mark of m_used
+        size_t m_free_blocks = 0x00; // blocks in the free lists
+#endif
+    };
+
+    // the heap behind alloc_ / free_, over the static `heap` pool
+    inline heap_t &default_heap() {
+        static heap_t instance(heap, HEAP_SIZE);
+        return instance;
+    }
+
+    // Initialize the free list of the default heap
+    inline void initialize() {
+        default_heap().initialize();
+    }
+
+    /**
+     * Allocates a block of memory of the specified size from the default heap.
+     *
+     * @param size The size of the memory block to allocate. Must be greater than zero.
+     *
+     * @return A pointer to the allocated memory block. Returns `nullptr` if the size is zero or if no suitable free block is found.
+     */
+    inline void *alloc_(size_t size) {
+        return default_heap().alloc(size);
+    }
+
+    /**
+     * Frees a block returned by `alloc_`, allowing it to be reused in future memory allocations.
+     *
+     * @param ptr Pointer to the memory block to be freed. If `ptr` is `nullptr`, the function does nothing.
+     */
+    inline void free_(void *ptr) {
+        default_heap().free(ptr);
+    }
+
+    /**
+     * Bump allocator over chained chunks, everything is freed at once with `reset()`.
+     *
+     * Allocating is a pointer increment; individual blocks are never freed, so it suits
+     * per-request or per-message scratch memory. The first chunk may be caller storage
+     * (e.g. a static or stack array), further chunks come from a parent memory resource
+     * (`mmap_resource()`, a `heap_t`, the default new/delete...) and are kept across resets.
+     * The arena is itself a memory resource. An instance is not thread-safe.
+     */
+    class arena_t : public std::pmr::memory_resource {
+    public:
         /**
-         * Retrieves a `long long` value from the buffer if available.
+         * Creates an arena growing by chunks of `chunk_size` bytes taken from `upstream`.
          *
-         * This method fetches a `long long` value from the current position within the buffer if the buffer size is non-zero.
-         *
-         * @return The retrieved `long long` value from the buffer, or -1 if the buffer size is zero.
+         * @param chunk_size The size of each chunk. Larger requests get a chunk of their own.
+         * @param upstream The parent allocator chunks are taken from.
          */
-        const long long get_llong() noexcept(true) {
-            if (m_size != 0x00) {
-                const long long value = *(long long *) &buffer.data()[m_lens];
-                m_lens += sizeof(long long);
-                return value;
-            }
-            return -1;
+        explicit arena_t(const size_t &chunk_size = 0x10000,
+                         std::pmr::memory_resource *upstream = std::pmr::get_default_resource())
+            : m_chunk_size(chunk_size), m_upstream(upstream) {
         }
 
         /**
-         * Retrieves a 16-bit unsigned short from the buffer.
+         * Creates an arena starting with caller storage, growing from `upstream` once it is full.
          *
-         * @return The 16-bit unsigned short value extracted from the buffer.
-         *         If the buffer is empty (m_size is 0), returns `-1`.
+         * @param buffer The initial storage, owned by the caller, aligned to `ALIGNMENT`.
+         * @param size The size of the initial storage.
+         * @param upstream The parent allocator for further chunks; the default null resource
+         *                 keeps the arena fixed-size, `alloc` then returns `nullptr` when full.
          *
-         * @throws None This function is marked noexcept(true).
+         * @throws std::invalid_argument If the buffer is null or too small.
          */
-        const uint16_t get_ushort() noexcept(true) {
-            if (m_size != 0x00) {
-                const uint16_t value = *(uint16_t *) &buffer.data()[m_lens];
-                m_lens += sizeof(uint16_t);
-                return value;
-            }
-            return -1;
+        arena_t(void *buffer, const size_t &size,
+                std::pmr::memory_resource *upstream = std::pmr::null_memory_resource())
+            : m_chunk_size(size), m_upstream(upstream) {
+            if (buffer == nullptr || size <= sizeof(chunk_t))
+                throw std::invalid_argument("buffer is null or size is too small");
+            chunk_t *chunk = static_cast<chunk_t *>(buffer);
+            chunk->next = nullptr, chunk->size = size, chunk->owned = false;
+            m_first = m_current = chunk;
+            m_cursor = reinterpret_cast<uint8_t *>(chunk + 1);
+            m_end = reinterpret_cast<uint8_t *>(chunk) + size;
         }
 
-        /**
-         * Retrieves a uint32_t value from the internal buffer.
-         *
-         * @return The next uint32_t value from the buffer if available; otherwise, returns -1.
-         *
-         * @throws noexcept This function is guaranteed not to throw any exceptions.
-         */
-        const uint32_t get_uint() noexcept(true) {
-            if (m_size != 0x00) {
-                const uint32_t value = *(uint32_t *) &buffer.data()[m_lens];
-                m_lens += sizeof(uint32_t);
-                return value;
-            }
-            return -1;
+        ~arena_t() override {
+            release();
         }
 
-        /**
-         * Retrieves a uint64_t value from the buffer.
-         *
-         * This function extracts and returns a 64-bit unsigned integer from the
-         * buffer starting at the current lens position and increments the lens
-         * by the size of the uint64_t. If the size is zero, it returns -1.
-         *
-         * @return uint64_t The extracted 64-bit unsigned integer from the buffer.
-         * Returns -1 if the current size is zero.
-         */
-        const uint64_t get_uint64() noexcept(true) {
-            if (m_size != 0x00) {
-                const uint64_t value = *(uint64_t *) &buffer.data()[m_lens];
-                m_lens += sizeof(uint64_t);
-                return value;
-            }
-            return -1;
-        }
+        arena_t(const arena_t &) = delete;
+
+        arena_t &operator=(const arena_t &) = delete;
 
         /**
-         * Retrieves a boolean value from the internal buffer.
+         * Allocates `size` bytes aligned to `alignment`.
          *
-         * @return The boolean value extracted from the buffer if the size is non-zero, otherwise false.
+         * @return A pointer to the block, or `nullptr` if the arena is full and can't grow.
          */
-        const bool get_bool() noexcept(true) {
-            if (m_size != 0x00) {
-                const bool value = *(bool *) &buffer.data()[m_lens];
-                m_lens += sizeof(bool);
-                return value;
+        void *alloc(const size_t &size, const size_t &alignment = ALIGNMENT) noexcept {
+            uint8_t *ptr = align_up(m_cursor, alignment);
+            if (m_current == nullptr || ptr > m_end || size > size_t(m_end - ptr)) {
+                if (!next_chunk(size, alignment))
+                    return nullptr;
+                ptr = align_up(m_cursor, alignment);
             }
-            return false;
+            m_cursor = ptr + size;
+            m_used += size;
+            return ptr;
         }
 
         /**
-         * Retrieves a floating-point value from the internal buffer.
-         *
-         * This method reads a `float` from the current position in the buffer,
-         * advances the position by the size of a `float`, and returns the read value.
-         *
-         * @return The `float` value from the buffer if the size is non-zero; otherwise, returns `0.0f`.
+         * Frees every allocation at once. The chunks are kept and reused by later allocations.
          */
-        const float get_float() noexcept(true) {
-            if (m_size != 0x00) {
-                const float value = *(float *) &buffer.data()[m_lens];
-                m_lens += sizeof(float);
-                return value;
+        void reset() noexcept {
+            m_current = m_first;
+            if (m_current != nullptr) {
+                m_cursor = reinterpret_cast<uint8_t *>(m_current + 1);
+                m_end = reinterpret_cast<uint8_t *>(m_current) + m_current->size;
             }
-            return 0.0f;
+            m_used = 0x00;
         }
 
         /**
-         * Retrieves a double-precision floating-point number from the buffer.
-         *
-         * This method extracts a double value from the internal buffer at the current
-         * buffer position, updates the position, and returns the extracted value.
-         * If the buffer is empty, it returns 0.0.
-         *
-         * @return The double value extracted from the buffer, or 0.0 if the buffer is empty.
+         * Frees every allocation and gives the chunks back to the parent allocator.
          */
-        const double get_double() noexcept(true) {
-            if (m_size != 0x00) {
-                const double value = *(double *) &buffer.data()[m_lens];
-                m_lens += sizeof(double);
-                return value;
+        void release() noexcept {
+            chunk_t *chunk = m_first;
+            m_first = m_current = nullptr;
+            m_cursor = m_end = nullptr;
+            while (chunk != nullptr) {
+                chunk_t *next = chunk->next;
+                if (chunk->owned)
+                    m_upstream->deallocate(chunk, chunk->size, alignof(chunk_t));
+                else {
+                    // caller storage stays the first chunk
+                    chunk->next = nullptr;
+                    m_first = m_current = chunk;
+                    m_cursor = reinterpret_cast<uint8_t *>(chunk + 1);
+                    m_end = reinterpret_cast<uint8_t *>(chunk) + chunk->size;
+                }
+                chunk = next;
             }
-            return 0.0;
+            m_used = 0x00;
         }
 
-        using iterator = uint8_t *;
+        // bytes handed out since the last reset
+        constexpr size_t used() const noexcept { return m_used; }
 
-        iterator begin() noexcept {
-            return buffer.data();
+        // bytes held in chunks, used or not
+        size_t capacity() const noexcept {
+            size_t total = 0x00;
+            for (chunk_t *chunk = m_first; chunk != nullptr; chunk = chunk->next)
+                total += chunk->size - sizeof(chunk_t);
+            return total;
         }
 
-        iterator end() noexcept {
-            return buffer.data() + m_lens;
+    protected:
+        void *do_allocate(size_t bytes, size_t alignment) override {
+            void *ptr = alloc(bytes, alignment);
+            if (ptr == nullptr)
+                throw std::bad_alloc();
+            return ptr;
         }
 
-        /**
-         * Validates the internal buffer to ensure it contains valid data.
-         *
-         * This function checks the consistency and integrity of the internal buffer,
-         * ensuring that the buffer size and current position are within valid ranges.
-         *
-         * @return `true` if the internal buffer data is valid, `false` otherwise.
-         */
-        constexpr bool is_valid() const noexcept {
-            // Ensure the buffer is not null, the size is greater than zero,
-            return buffer.data() != nullptr && m_size != 0x00;
+        void do_deallocate(void *, size_t, size_t) override {
+            // freed in bulk by reset()
         }
 
-    private:
-        /**
-         * Inserts a value into the internal buffer, managing different possible types.
-         *
-         * @param value The value to insert into the buffer. It must be a variant that
-         *              can hold supported types including `std::string`, `std::string_view`,
-         *              and other primitive types as defined in the variant type.
-         *
-         * @throws std::invalid_argument If the variant holds an invalid type.
-         * @throws std::runtime_error If the buffer size is exceeded during insertion.
-         */
-        template<class _typename>
-        constexpr void insert(const _typename &value) {
-            const variant &var = value;
-            if (var.index() == std::variant_npos)
-                throw std::invalid_argument("invalid variant access");
-            else if (var.index() == support_t::variant_str) {
-                const std::string str = std::get<std::string>(var);
-                if (m_lens + str.size() > m_size)
-                    throw std::runtime_error("maximum buffer size exceeded");
-                const size_t lens = str.size();
-                _STD memcpy(buffer.data() + m_lens, &lens, sizeof(size_t));
-                m_lens += sizeof(size_t);
-                _STD memcpy(buffer.data() + m_lens, str.c_str(), lens);
-                m_lens += lens;
-            } else if (var.index() == support_t::variant_strview) {
-                const std::string_view str = std::get<std::string_view>(var);
-                if (m_lens + str.size() > m_size)
-                    throw std::runtime_error("maximum buffer size exceeded");
-                const size_t lens = str.size();
-                _STD memcpy(buffer.data() + m_lens, &lens, sizeof(size_t));
-                m_lens += sizeof(size_t);
-                _STD memcpy(buffer.data() + m_lens, str.data(), lens);
-                m_lens += lens;
-            } else {
-                if (m_lens + sizeof(_typename) > m_size)
-                    throw std::runtime_error("maxium buffer size exceeded");
-                const _typename object = std::get<_typename>(var);
-                std::memcpy(buffer.data() + m_lens, &object, sizeof(_typename));
-                m_lens += sizeof(_typename);
-            }
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+            return this == &other;
         }
 
-    public:
-        constexpr uint8_t *data() noexcept {
-            return buffer.data();
+    private:
+        // header at the start of every chunk
+        struct chunk_t {
+            chunk_t *next;
+            size_t size; // chunk size, header included
+            bool owned; // taken from m_upstream
+        };
+
+        static uint8_t *align_up(uint8_t *ptr, const size_t &alignment) noexcept {
+            const uintptr_t value = reinterpret_cast<uintptr_t>(ptr);
+            return reinterpret_cast<uint8_t *>((value + alignment - 1) & ~(uintptr_t(alignment) - 1));
         }
 
-        constexpr uintmax_t size() noexcept { return m_size; }
-        constexpr uintmax_t lens() noexcept { return m_lens; }
+        // moves to the next kept chunk that fits, or chains a new one
+        bool next_chunk(const size_t &size, const size_t &alignment) noexcept {
+            if (size > std::numeric_limits<size_t>::max() - sizeof(chunk_t) - alignment)
+                return false;
+            const size_t needed = sizeof(chunk_t) + size + alignment;
+            chunk_t *chunk = m_current != nullptr ? m_current->next : m_first;
+            chunk_t *last = m_current;
+            while (chunk != nullptr && chunk->size < needed) {
+                last = chunk;
+                chunk = chunk->next;
+            }
+            if (chunk == nullptr) {
+                const size_t lens = needed > m_chunk_size ? needed : m_chunk_size;
+                try {
+                    chunk = static_cast<chunk_t *>(m_upstream->allocate(lens, alignof(chunk_t)));
+                } catch (...) {
+                    return false;
+                }
+                chunk->size = lens, chunk->owned = true;
+                // append after the last chunk so the order of reuse stays stable
+                while (last != nullptr && last->next != nullptr)
+                    last = last->next;
+                chunk->next = nullptr;
+                if (last != nullptr)
+                    last->next = chunk;
+                else
+                    m_first = chunk;
+            }
+            m_current = chunk;
+            m_cursor = reinterpret_cast<uint8_t *>(chunk + 1);
+            m_end = reinterpret_cast<uint8_t *>(chunk) + chunk->size;
+            return true;
+        }
 
     private:
-        std::vector<uint8_t> buffer; // main data to store value
-    private:
-        uintmax_t m_size = 0x00; // size of memory allocation / reallocation
-        uintmax_t m_lens = 0x00; // tracker of memory position
+        size_t m_chunk_size = 0x00; // size of the chunks taken from m_upstream
+        std::pmr::memory_resource *m_upstream = nullptr; // parent allocator
+        chunk_t *m_first = nullptr; // first chunk, chained through chunk_t::next
+        chunk_t *m_current = nullptr; // chunk being bumped
+        uint8_t *m_cursor = nullptr; // next free byte of m_current
+        uint8_t *m_end = nullptr; // end of m_current
+        size_t m_used = 0x00; // bytes handed out since the last reset
     };
 
-    namespace io {
-        void serialize(wmemory_t *buffer, const char *filename) {
-            FILE *file = fopen(filename, "wb");
-            fwrite(buffer->data(), 1, buffer->lens(), file);
-            fflush(file);
-            fclose(file);
+    /**
+     * Thread-safe allocator built on top of the `alloc_` / `free_` heap.
+     *
+     * Small requests are served from size-class segregated free lists: each thread keeps
+     * a cache per size class, refilled from and drained to a central pool sharded by size
+     * class, and the central pool carves slabs out of the heap. The heap itself is only
+     * touched under `heap_mutex`, for new slabs and for requests above `MAX_CLASS_SIZE`.
+     *
+     * Don't mix: a pointer from `concurrent::alloc_` must be released with `concurrent::free_`,
+     * and `alloc_` / `free_` must not be called directly while other threads use this allocator.
+     */
+    namespace concurrent {
+        constexpr size_t CLASS_COUNT = 8; // 16, 32, ... 2048 bytes
+        constexpr size_t MIN_CLASS_SIZE = 16;
+        constexpr size_t MAX_CLASS_SIZE = MIN_CLASS_SIZE << (CLASS_COUNT - 1);
+        constexpr size_t CACHE_LIMIT = 64; // objects a thread cache keeps per class
+        constexpr size_t BATCH = 32; // objects moved between a thread cache and the central pool
+        constexpr size_t SLAB_OBJECTS = 64; // objects carved from the heap at once
+        constexpr uint64_t LARGE = ~uint64_t(0); // prefix of blocks served directly by the heap
+
+        // guards every access to the alloc_ / free_ heap
+        inline std::mutex heap_mutex;
+
+        namespace detail {
+            // free object, the link lives in the object itself, after its prefix
+            struct node_t {
+                node_t *next;
+            };
+
+            // every object starts with its size class and its slot in the slab, so free_ knows where it goes back
+            constexpr size_t PREFIX = ALIGNMENT;
+
+            inline size_t class_of(const size_t &size) {
+                size_t index = 0x00;
+                while ((MIN_CLASS_SIZE << index) < size)
+                    ++index;
+                return index;
+            }
+
+            constexpr size_t object_size(const size_t &index) {
+                return PREFIX + (MIN_CLASS_SIZE << index);
+            }
+
+            // header of SLAB_OBJECTS objects carved from the heap at once, followed by the objects
+            struct slab_t {
+                slab_t *prev = nullptr, *next = nullptr; // neighbours in the list of slabs with free objects
+                node_t *free = nullptr; // objects of this slab in the central pool
+                size_t available = 0x00; // length of `free`
+            };
+
+            constexpr size_t SLAB_HEADER = (sizeof(slab_t) + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+
+            inline slab_t *slab_of(node_t *object) {
+                const uint8_t *block = reinterpret_cast<uint8_t *>(object) - PREFIX;
+                uint64_t prefix;
+                _STD memcpy(&prefix, block, sizeof(uint64_t));
+                const size_t index = prefix & 0xFF, slot = prefix >> 8;
+                return reinterpret_cast<slab_t *>(const_cast<uint8_t *>(block) - slot * object_size(index) - SLAB_HEADER);
+            }
+
+            // one shard of the central pool per size class, slabs with free objects are linked
+            // and a slab is given back to the heap once all its objects are free again
+            struct central_t {
+                std::mutex mutex;
+                slab_t *partial = nullptr;
+
+                void link(slab_t *slab) {
+                    slab->prev = nullptr, slab->next = partial;
+                    if (partial)
+                        partial->prev = slab;
+                    partial = slab;
+                }
+
+                void unlink(slab_t *slab) {
+                    (slab->prev ? slab->prev->next : partial) = slab->next;
+                    if (slab->next)
+                        slab->next->prev = slab->prev;
+                }
+            };
+
+            inline central_t central[CLASS_COUNT];
+
+            // carves a new slab of class `index`, null if the heap is exhausted
+            inline slab_t *carve(const size_t &index) {
+                uint8_t *memory;
+                {
+                    std::lock_guard<std::mutex> heap_lock(heap_mutex);
+                    memory = static_cast<uint8_t *>(utils::alloc_(SLAB_HEADER + object_size(index) * SLAB_OBJECTS));
+                }
+                if (memory == nullptr)
+                    return nullptr;
+                slab_t *slab = new(memory) slab_t;
+                for (size_t slot = SLAB_OBJECTS; slot-- > 0;) {
+                    uint8_t *block = memory + SLAB_HEADER + slot * object_size(index);
+                    const uint64_t prefix = (uint64_t(slot) << 8) | index;
+                    _STD memcpy(block, &prefix, sizeof(uint64_t));
+                    node_t *object = reinterpret_cast<node_t *>(block + PREFIX);
+                    object->next = slab->free;
+                    slab->free = object;
+                }
+                slab->available = SLAB_OBJECTS;
+                return slab;
+            }
+
+            // pops up to `count` objects from the central pool, carving a new slab if it's empty
+            inline size_t take(const size_t &index, node_t *&head, const size_t &count) {
+                central_t &shard = central[index];
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                if (shard.partial == nullptr) {
+                    slab_t *slab = carve(index);
+                    if (slab == nullptr)
+                        return 0x00;
+                    shard.link(slab);
+                }
+                size_t taken = 0x00;
+                while (taken < count && shard.partial != nullptr) {
+                    slab_t *slab = shard.partial;
+                    node_t *object = slab->free;
+                    slab->free = object->next;
+                    if (--slab->available == 0x00)
+                        shard.unlink(slab);
+                    object->next = head;
+                    head = object;
+                    ++taken;
+                }
+                return taken;
+            }
+
+            // pushes up to `count` objects from the front of `head` back to their slabs
+            inline void give(const size_t &index, node_t *&head, const size_t &count) {
+                central_t &shard = central[index];
+                std::lock_guard<std::mutex> lock(shard.mutex);
+                for (size_t given = 0; given < count && head != nullptr; ++given) {
+                    node_t *object = head;
+                    head = object->next;
+                    slab_t *slab = slab_of(object);
+                    object->next = slab->free;
+                    slab->free = object;
+                    if (++slab->available == 1)
+                        shard.link(slab);
+                    else if (slab->available == SLAB_OBJECTS) {
+                        shard.unlink(slab);
+                        std::lock_guard<std::mutex> heap_lock(heap_mutex);
+                        utils::free_(slab);
+                    }
+                }
+            }
+
+            // per-thread cache, drained back to the central pool when the thread exits
+            struct cache_t {
+                node_t *head[CLASS_COUNT] = {};
+                size_t count[CLASS_COUNT] = {};
+
+                ~cache_t() {
+                    for (size_t index = 0; index < CLASS_COUNT; ++index)
+                        drain(index, count[index]);
+                }
+
+                void drain(const size_t &index, size_t count_) {
+                    if (count_ == 0x00 || head[index] == nullptr)
+                        return;
+                    count[index] -= count_;
+                    give(index, head[index], count_);
+                }
+            };
+
+            inline cache_t &cache() {
+                thread_local cache_t local;
+                return local;
+            }
         }
 
         /**
-         * Deserializes data from a binary file and stores it into the specified `wmemory_t` buffer.
+         * Allocates a block of memory of the specified size, safe to call from any thread.
          *
-         * @param buffer A pointer to the `wmemory_t` object where the deserialized data will be stored.
-         * @param filename The name of the binary file to read the data from.
+         * Small blocks come from slabs of their size class, a slab goes back to the heap
+         * once every block carved from it is freed and no thread cache holds one.
          *
-         * @throws std::runtime_error If the file cannot be opened.
+         * @param size The size of the memory block to allocate. Must be greater than zero.
+         *
+         * @return A pointer to the allocated memory block. Returns `nullptr` if the size is zero or
+         *         if the heap is exhausted.
          */
-        void deserialize(wmemory_t *buffer, const char *filename) {
-            std::ifstream file(filename, std::ios::binary);
-            if (file.is_open()) {
-                file.seekg(0x0, std::ios::end);
-                std::streamsize size = file.tellg();
-                file.seekg(0x0, std::ios::beg);
-                uint8_t *data = (uint8_t *) _STD malloc(size);
-                file.read(reinterpret_cast<char *>(data), size);
-                file.close();
-                buffer->reserve(data, size);
-                std::free(data);
-            } else throw std::runtime_error("failed to open file");
-        }
-    }
-    namespace detail {
-        inline void format_helper(std::stringstream &ss, const std::string &format) {
-            ss << format; // Base case: no more placeholders
+        inline void *alloc_(size_t size) {
+            if (size == 0)
+                return nullptr;
+            if (size > MAX_CLASS_SIZE) {
+                uint8_t *block;
+                {
+                    std::lock_guard<std::mutex> lock(heap_mutex);
+                    block = static_cast<uint8_t *>(utils::alloc_(detail::PREFIX + size));
+                }
+                if (block == nullptr)
+                    return nullptr;
+                _STD memcpy(block, &LARGE, sizeof(uint64_t));
+                return block + detail::PREFIX;
+            }
+            const size_t index = detail::class_of(size);
+            detail::cache_t &cache = detail::cache();
+            if (cache.head[index] == nullptr) {
+                cache.count[index] += detail::take(index, cache.head[index], BATCH);
+                if (cache.head[index] == nullptr)
+                    return nullptr;
+            }
+            detail::node_t *object = cache.head[index];
+            cache.head[index] = object->next;
+            --cache.count[index];
+            return object;
         }
 
-        template<typename T, typename... Args>
-        void format_helper(std::stringstream &ss, const std::string &format, T value, Args... args) {
-            size_t pos = format.find("{}");
-            if (pos == std::string::npos) {
-                throw std::invalid_argument("Too many arguments provided to format string.");
+        /**
+         * Frees a block returned by `concurrent::alloc_`, safe to call from any thread,
+         * including one other than the allocating thread.
+         *
+         * @param ptr Pointer to the memory block to be freed. If `ptr` is `nullptr`, the function does nothing.
+         */
+        inline void free_(void *ptr) {
+            if (ptr == nullptr)
+                return;
+            uint8_t *block = static_cast<uint8_t *>(ptr) - detail::PREFIX;
+            uint64_t prefix;
+            _STD memcpy(&prefix, block, sizeof(uint64_t));
+            if (prefix == LARGE) {
+                std::lock_guard<std::mutex> lock(heap_mutex);
+                utils::free_(block);
+                return;
             }
-            ss << format.substr(0, pos) << value;
-            format_helper(ss, format.substr(pos + 2), args...);
+            const size_t index = static_cast<size_t>(prefix & 0xFF);
+            detail::cache_t &cache = detail::cache();
+            detail::node_t *object = static_cast<detail::node_t *>(ptr);
+            object->next = cache.head[index];
+            cache.head[index] = object;
+            if (++cache.count[index] > CACHE_LIMIT)
+                cache.drain(index, BATCH);
         }
     }
 
-    template<typename... Args>
-    std::string format(const std::string &fmt, Args... args) {
-        std::stringstream ss;
-        detail::format_helper(ss, fmt, args...);
-        return ss.str();
-    }
+    namespace stats {
+        inline std::string snapshot() {
+            std::string text;
+#ifdef __SERIALIZER_STATS__
+            char line[0x100];
+            const auto append = [&]<class... _args>(format_string_t<_args...> fmt, const _args &... args) {
+                text.append(line, format_to(std::span<char>(line), fmt, args...));
+            };
 
-    template<typename IntegerType>
-    std::string group_digit(IntegerType number, char separator = ',') {
-        // Buffer to hold the resulting string
-        char buffer[50];
-        // Buffer to hold the temporary number
-        char temp[50];
+            for (size_t i = 0; i < counter_t::count; ++i) {
+                append("# TYPE {} counter\n", counter_t::names[i]);
+                append("{} {}\n", counter_t::names[i], value(i));
+            }
+            for (size_t i = 0; i < histogram_t::count; ++i) {
+                const detail::buckets_t &source = detail::histograms()[i];
+                append("# TYPE {} histogram\n", histogram_t::names[i]);
+                uint64_t total = 0x00;
+                for (size_t bucket = 0; bucket + 1 < histogram_t::buckets; ++bucket) {
+                    total += source.counts[bucket].load(std::memory_order_relaxed);
+                    append("{}_bucket{le=\"{}\"} {}\n", histogram_t::names[i], (uint64_t(1) << bucket) - 1, total);
+                }
+                total += source.counts[histogram_t::buckets - 1].load(std::memory_order_relaxed);
+                append("{}_bucket{le=\"+Inf\"} {}\n", histogram_t::names[i], total);
+                append("{}_sum {}\n", histogram_t::names[i], source.sum.load(std::memory_order_relaxed));
+                append("{}_count {}\n", histogram_t::names[i], total);
+            }
 
-        // Handle potential negative number
-        bool is_negative = (number < 0);
-        if (is_negative) {
-            number = -number;
+            std::lock_guard<std::mutex> lock(concurrent::heap_mutex);
+            const heap_t &heap = default_heap();
+            const std::pair<const char *, uint64_t> gauges[] = {
+                {"serializer_heap_used_bytes", heap.used()},
+                {"serializer_heap_peak_bytes", heap.peak()},
+                {"serializer_heap_free_blocks", heap.free_blocks()},
+                {"serializer_heap_largest_free_bytes", heap.largest_free()},
+                {"serializer_heap_size_bytes", heap.size()},
+            };
+            for (const auto &[name, gauge]: gauges) {
+                append("# TYPE {} gauge\n", name);
+                append("{} {}\n", name, gauge);
+            }
+#endif
+            return text;
         }
+    }
 
-        int idx = 0;
-        int len = 0;
+    /**
+     * Standard allocator over the default heap (`alloc_` / `free_`), single-threaded.
+     * Bytes added by growing a container are left uninitialized.
+     *
+     * @throws std::bad_alloc From `allocate` when the heap is exhausted.
+     */
+    template<class _typename>
+    struct heap_allocator {
+        using value_type = _typename;
 
-        // Convert number to string in reverse
-        do {
-            temp[len++] = '0' + number % 10;
-            number /= 10;
-        } while (number > 0);
+        heap_allocator() noexcept = default;
 
-        // Now insert separators while copying temp to buffer in proper order
-        int group_count = 0;
-        for (int i = 0; i < len; ++i) {
-            if (group_count == 3) {
-                buffer[idx++] = separator;
-                group_count = 0;
-            }
-            buffer[idx++] = temp[len - 1 - i];
-            ++group_count;
+        template<class _other>
+        heap_allocator(const heap_allocator<_other> &) noexcept {
         }
 
-        // Add minus sign if the number was negative
-        if (is_negative) {
-            buffer[idx++] = '-';
+        _typename *allocate(const size_t &count) {
+            void *ptr = alloc_(count * sizeof(_typename));
+            if (ptr == nullptr)
+                throw std::bad_alloc();
+            return static_cast<_typename *>(ptr);
         }
 
-        // Reverse the buffer to get the final string
-        for (int i = 0; i < idx / 2; ++i) {
-            std::swap(buffer[i], buffer[idx - 1 - i]);
+        void deallocate(_typename *ptr, const size_t &) noexcept {
+            free_(ptr);
         }
 
-        // Null-terminate the string
-        buffer[idx] = '\0';
-
-        return std::string(buffer);
-    }
-
-    constexpr size_t HEAP_SIZE = 1024 * 1024; // 1 MB
-    constexpr size_t ALIGNMENT = 8;
+        // default-initializes instead of value-initializing, so growing a byte buffer doesn't
+        // zero it one element at a time
+        template<class _other, class... _args>
+        void construct(_other *ptr, _args &&... args) {
+            ::new(static_cast<void *>(ptr)) _other(std::forward<_args>(args)...);
+        }
 
-    // Align utility
-    inline size_t align(size_t size) {
-        return (size + (ALIGNMENT - 1)) & ~(ALIGNMENT - 1);
-    }
+        template<class _other>
+        void construct(_other *ptr) {
+            ::new(static_cast<void *>(ptr)) _other;
+        }
 
-    // Block header structure
-    struct BlockHeader {
-        size_t size;
-        bool is_free;
-        BlockHeader *next;
+        template<class _other>
+        bool operator==(const heap_allocator<_other> &) const noexcept { return true; }
     };
 
-    // Static memory pool
-    alignas(ALIGNMENT) uint8_t heap[HEAP_SIZE];
-    BlockHeader *free_list = reinterpret_cast<BlockHeader *>(heap);
-
-    // Initialize the free list
-    void initialize() {
-        // Securely initialize heap memory to avoid undefined behavior
-        std::memset(heap, 0, HEAP_SIZE);
-
-        free_list->size = HEAP_SIZE - sizeof(BlockHeader);
-        free_list->is_free = true;
-        free_list->next = nullptr;
-    }
-
     /**
-     * Allocates a block of memory of the specified size.
-     *
-     * @param size The size of the memory block to allocate. Must be greater than zero.
+     * Standard allocator over `concurrent::alloc_` / `concurrent::free_`: per-thread caches,
+     * safe to use from any thread. Bytes added by growing a container are left uninitialized.
      *
-     * @return A pointer to the allocated memory block. Returns `nullptr` if the size is zero or if no suitable free block is found.
+     * @throws std::bad_alloc From `allocate` when the heap is exhausted.
      */
-    void *alloc_(size_t size) {
-        static bool initialized = false;
-        if (!initialized) {
-            initialize();
-            initialized = true;
-        }
-
-        if (size == 0) {
-            return nullptr;
-        }
-
-        size = align(size);
+    template<class _typename>
+    struct concurrent_allocator {
+        using value_type = _typename;
 
-        BlockHeader *current = free_list;
-        BlockHeader *previous = nullptr;
+        concurrent_allocator() noexcept = default;
 
-        // Find a free block of sufficient size
-        while (current != nullptr) {
-            if (current->is_free && current->size >= size) {
-                // Split the block if it's larger than needed
-                if (current->size >= size + sizeof(BlockHeader) + ALIGNMENT) {
-                    BlockHeader *new_block = reinterpret_cast<BlockHeader *>(
-                        reinterpret_cast<uint8_t *>(current) + sizeof(BlockHeader) + size);
-                    new_block->size = current->size - size - sizeof(BlockHeader);
-                    new_block->is_free = true;
-                    new_block->next = current->next;
+        template<class _other>
+        concurrent_allocator(const concurrent_allocator<_other> &) noexcept {
+        }
 
-                    current->size = size;
-                    current->next = new_block;
-                }
+        _typename *allocate(const size_t &count) {
+            void *ptr = concurrent::alloc_(count * sizeof(_typename));
+            if (ptr == nullptr)
+                throw std::bad_alloc();
+            return static_cast<_typename *>(ptr);
+        }
 
-                current->is_free = false;
-                return reinterpret_cast<void *>(reinterpret_cast<uint8_t *>(current) + sizeof(BlockHeader));
-            }
+        void deallocate(_typename *ptr, const size_t &) noexcept {
+            concurrent::free_(ptr);
+        }
 
-            previous = current;
-            current = current->next;
+        // default-initializes instead of value-initializing, so growing a byte buffer doesn't
+        // zero it one element at a time
+        template<class _other, class... _args>
+        void construct(_other *ptr, _args &&... args) {
+            ::new(static_cast<void *>(ptr)) _other(std::forward<_args>(args)...);
         }
-        return nullptr;
-    }
 
-    /**
-     * Frees the memory block pointed to by `ptr` and marks it as free,
-     * allowing it to be reused in future memory allocations.
-     *
-     * @param ptr Pointer to the memory block to be freed. If `ptr` is `nullptr`, the function does nothing.
-     */
-    void free_(void *ptr) {
-        if (ptr == nullptr) {
-            return;
+        template<class _other>
+        void construct(_other *ptr) {
+            ::new(static_cast<void *>(ptr)) _other;
         }
 
-        BlockHeader *block = reinterpret_cast<BlockHeader *>(
-            reinterpret_cast<uint8_t *>(ptr) - sizeof(BlockHeader));
-        block->is_free = true;
+        template<class _other>
+        bool operator==(const concurrent_allocator<_other> &) const noexcept { return true; }
+    };
 
-        // Coalesce contiguous free blocks
-        BlockHeader *current = free_list;
-        while (current != nullptr) {
-            BlockHeader *next = current->next;
-            if (next != nullptr && next->is_free) {
-                // Combine current and next blocks
-                current->size += next->size + sizeof(BlockHeader);
-                current->next = next->next;
-            } else {
-                current = next;
-            }
-        }
-    }
+    // buffer whose storage comes from the default heap
+    using heap_wmemory_t = basic_wmemory_t<heap_allocator<uint8_t> >;
+    // buffer whose storage comes from the thread-cached concurrent heap
+    using concurrent_wmemory_t = basic_wmemory_t<concurrent_allocator<uint8_t> >;
 }
 #endif
 #endif //SERIALIZER_H
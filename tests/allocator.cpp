@@ -0,0 +1,105 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <filesystem>
+#include <thread>
+
+// basic_wmemory_t over each allocator: same bytes as wmemory_t, storage taken from the chosen backend
+namespace {
+    using namespace utils;
+
+    const std::string path = (std::filesystem::temp_directory_path() / "serializer_test_allocator.bin").string();
+
+    template<class _memory>
+    void write(_memory &out) {
+        for (int i = 0; i < 500; ++i) {
+            out.setInt(i);
+            out.setString("value " + std::to_string(i));
+            out.setDouble(i * 0.25);
+        }
+    }
+
+    template<class _memory>
+    bool read(_memory &in) {
+        bool same = true;
+        for (int i = 0; i < 500; ++i) {
+            same = same && in.get_int() == i;
+            same = same && in.get_string() == "value " + std::to_string(i);
+            same = same && in.get_double() == i * 0.25;
+        }
+        return same;
+    }
+
+    // written through `_memory`, the bytes match a plain wmemory_t and read back with the same allocator
+    template<class _memory>
+    bool round_trip(const typename _memory::allocator_type &alloc = {}) {
+        wmemory_t expected(0x100, policy_t::growable);
+        write(expected);
+
+        _memory out(0x100, policy_t::growable, alloc);
+        write(out);
+        if (out.lens() != expected.lens() || !std::equal(out.data(), out.data() + out.lens(), expected.data()))
+            return false;
+
+        _memory in(out.data(), out.lens(), alloc);
+        return read(in);
+    }
+
+    void backends() {
+        CHECK(round_trip<wmemory_t>());
+        CHECK(round_trip<heap_wmemory_t>());
+        CHECK(round_trip<concurrent_wmemory_t>());
+
+        arena_t arena(0x1000);
+        CHECK(round_trip<pmr_wmemory_t>(&arena));
+        CHECK(arena.used() > 0);
+
+        heap_t heap(0x100000);
+        CHECK(round_trip<pmr_wmemory_t>(&heap));
+    }
+
+    void storage() {
+        heap_wmemory_t buffer(0x100);
+        CHECK(buffer.data() >= heap && buffer.data() < heap + HEAP_SIZE);
+
+        arena_t arena(0x1000);
+        pmr_wmemory_t scratch(0x100, &arena);
+        CHECK(scratch.get_allocator().resource() == &arena);
+        CHECK(arena.used() >= 0x100);
+
+        pmr_wmemory_t copy(scratch);
+        CHECK(copy.get_allocator().resource() != &arena); // a copy doesn't propagate the resource
+    }
+
+    void threads() {
+        bool same[4] = {};
+        std::vector<std::thread> workers;
+        for (bool &result: same)
+            workers.emplace_back([&result] { result = round_trip<concurrent_wmemory_t>(); });
+        for (std::thread &worker: workers)
+            worker.join();
+        for (const bool &result: same)
+            CHECK(result);
+    }
+
+    void files() {
+        pmr_wmemory_t out(0x100, policy_t::growable);
+        write(out);
+        io::serialize(&out, path.c_str());
+
+        arena_t arena(0x1000);
+        pmr_wmemory_t in(nullptr, &arena);
+        io::deserialize(&in, path.c_str());
+        CHECK(in.size() == out.lens());
+        CHECK(read(in));
+        std::filesystem::remove(path);
+    }
+}
+
+int main() {
+    backends();
+    storage();
+    threads();
+    files();
+    return test::result();
+}
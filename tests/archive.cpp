@@ -0,0 +1,78 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <filesystem>
+#include <random>
+
+// archive_writer_t / archive_reader_t: random access to records of every size
+namespace {
+    using namespace utils;
+
+    std::vector<uint8_t> record_of(const size_t &index) {
+        // empty, small, larger than the staging chunk
+        const size_t size = index % 17 == 0 ? 0 : index % 31 == 0 ? 0x3000 : index * 7 % 300;
+        std::vector<uint8_t> record(size);
+        for (size_t i = 0; i < size; ++i)
+            record[i] = static_cast<uint8_t>(index * 31 + i);
+        return record;
+    }
+}
+
+int main() {
+    const std::string path = (std::filesystem::temp_directory_path() / "serializer_test_archive.msar").string();
+    constexpr size_t count = 1000;
+    {
+        io::archive_writer_t writer(path.c_str(), 0x1000);
+        for (size_t i = 0; i < count; ++i) {
+            if (i % 2 == 0)
+                writer.append(record_of(i));
+            else {
+                wmemory_t buffer(0x4000);
+                const std::vector<uint8_t> record = record_of(i);
+                if (!record.empty())
+                    std::copy(record.begin(), record.end(), buffer.data());
+                buffer.skip(record.size());
+                writer.append(&buffer);
+            }
+        }
+        CHECK(writer.size() == count);
+        writer.close();
+    }
+
+    io::archive_reader_t reader(path.c_str());
+    CHECK(reader.size() == count);
+    std::mt19937_64 engine(0xA5C1);
+    for (int lookup = 0; lookup < 5000; ++lookup) {
+        const size_t index = engine() % count;
+        const std::vector<uint8_t> expected = record_of(index);
+        const std::span<const uint8_t> record = reader.record(index);
+        CHECK(std::equal(record.begin(), record.end(), expected.begin(), expected.end()));
+
+        wmemory_t buffer(0x10);
+        reader.read(index, &buffer);
+        CHECK(buffer.size() == expected.size());
+        CHECK(expected.empty() || std::equal(expected.begin(), expected.end(), buffer.data()));
+    }
+
+    // a record read as values through a view
+    {
+        io::archive_writer_t writer(path.c_str());
+        wmemory_t buffer(0x40);
+        buffer.set_encoding(encoding_t::big);
+        buffer.setInt(42);
+        buffer.setDouble(2.5);
+        writer.append(&buffer);
+    }
+    io::archive_reader_t values(path.c_str());
+    read_view_t view = values.view(0, encoding_t::big);
+    int answer = 0;
+    double half = 0;
+    CHECK(view.read(answer, half) && answer == 42 && half == 2.5);
+    CHECK_THROWS(std::out_of_range, values.record(1));
+
+    // a file cut before its footer is rejected
+    std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+    CHECK_THROWS(std::runtime_error, io::archive_reader_t(path.c_str()));
+    std::filesystem::remove(path);
+    return test::result();
+}
@@ -0,0 +1,132 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+
+// arena_t: aligned disjoint blocks, chunks kept across reset() and given back by release(), huge sizes
+namespace {
+    using namespace utils;
+
+    // parent resource counting what the arena takes and gives back
+    class counting_t : public std::pmr::memory_resource {
+    public:
+        size_t allocations = 0x00, deallocations = 0x00, outstanding = 0x00;
+
+    protected:
+        void *do_allocate(size_t bytes, size_t alignment) override {
+            ++allocations, outstanding += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void *ptr, size_t bytes, size_t alignment) override {
+            ++deallocations, outstanding -= bytes;
+            std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    void blocks() {
+        counting_t upstream;
+        {
+            arena_t arena(0x1000, &upstream);
+            uint8_t *previous = nullptr;
+            for (size_t i = 1; i < 200; ++i) {
+                const size_t alignment = size_t(1) << (i % 7);
+                uint8_t *block = static_cast<uint8_t *>(arena.alloc(i, alignment));
+                CHECK(block != nullptr);
+                CHECK(reinterpret_cast<uintptr_t>(block) % alignment == 0);
+                std::fill(block, block + i, static_cast<uint8_t>(i));
+                if (previous != nullptr)
+                    CHECK(previous[i - 2] == static_cast<uint8_t>(i - 1)); // not overwritten by the next block
+                previous = block;
+            }
+            CHECK(arena.used() == 199 * 200 / 2);
+            CHECK(upstream.allocations > 1);
+
+            // a request larger than a chunk gets a chunk of its own
+            CHECK(arena.alloc(0x10000) != nullptr);
+            CHECK(arena.capacity() >= 0x10000);
+
+            // reset keeps the chunks, the same work takes nothing more from upstream
+            const size_t taken = upstream.allocations;
+            arena.reset();
+            CHECK(arena.used() == 0);
+            for (size_t i = 1; i < 200; ++i)
+                CHECK(arena.alloc(i, size_t(1) << (i % 7)) != nullptr);
+            CHECK(upstream.allocations == taken);
+
+            arena.release();
+            CHECK(upstream.outstanding == 0);
+            CHECK(arena.capacity() == 0);
+            CHECK(arena.alloc(16) != nullptr); // usable again after release
+        }
+        CHECK(upstream.outstanding == 0);
+        CHECK(upstream.allocations == upstream.deallocations);
+    }
+
+    void caller_storage() {
+        alignas(ALIGNMENT) static uint8_t storage[0x400];
+        arena_t arena(storage, sizeof(storage));
+        void *first = arena.alloc(0x100);
+        CHECK(first >= storage && first < storage + sizeof(storage));
+        CHECK(arena.alloc(0x200) != nullptr);
+        CHECK(arena.alloc(0x200) == nullptr); // fixed-size with the null resource
+        arena.reset();
+        CHECK(arena.alloc(0x100) == first);
+        arena.release();
+        CHECK(arena.alloc(0x100) == first); // caller storage stays the first chunk
+
+        CHECK_THROWS(std::invalid_argument, arena_t(nullptr, 0x400));
+        CHECK_THROWS(std::invalid_argument, arena_t(storage, 8));
+
+        // grows from a parent once the caller storage is full
+        counting_t upstream;
+        {
+            arena_t grown(storage, sizeof(storage), &upstream);
+            CHECK(grown.alloc(0x300) != nullptr);
+            CHECK(grown.alloc(0x300) != nullptr);
+            CHECK(upstream.allocations == 1);
+        }
+        CHECK(upstream.outstanding == 0);
+    }
+
+    // sizes close to the integer limit fail instead of wrapping around
+    void huge() {
+        counting_t upstream;
+        arena_t arena(0x1000, &upstream);
+        CHECK(arena.alloc(16) != nullptr);
+        CHECK(arena.alloc(SIZE_MAX) == nullptr);
+        CHECK(arena.alloc(SIZE_MAX - 8) == nullptr);
+        CHECK(arena.alloc(SIZE_MAX - sizeof(void *) * 4, 64) == nullptr);
+        CHECK(arena.alloc(16) != nullptr); // the current chunk is still in use
+        CHECK(upstream.allocations == 1);
+
+        alignas(0x100) uint8_t storage[0x100];
+        arena_t fixed(storage, sizeof(storage));
+        CHECK(fixed.alloc(SIZE_MAX - 8) == nullptr);
+        CHECK(fixed.alloc(0x20, 1) != nullptr);
+        CHECK(fixed.alloc(1, 0x200) == nullptr); // aligned up to or past the end of the storage
+    }
+
+    void memory_resource() {
+        arena_t arena(0x1000);
+        std::pmr::vector<std::pmr::string> values(&arena);
+        for (int i = 0; i < 500; ++i)
+            values.emplace_back("a string long enough to leave the small buffer " + std::to_string(i));
+        CHECK(values[499].ends_with("499"));
+
+        alignas(ALIGNMENT) uint8_t storage[0x100];
+        arena_t fixed(storage, sizeof(storage));
+        CHECK_THROWS(std::bad_alloc, (void) fixed.allocate(0x200));
+    }
+}
+
+int main() {
+    blocks();
+    caller_storage();
+    huge();
+    memory_resource();
+    return test::result();
+}
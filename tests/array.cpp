@@ -0,0 +1,150 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <array>
+#include <limits>
+#include <numeric>
+#include <span>
+
+// set_array / get_array: same bytes as element by element writes, both encodings, short outputs, cut input
+namespace {
+    using namespace utils;
+
+    template<class _typename>
+    std::vector<_typename> sample(const size_t &count) {
+        std::vector<_typename> values(count);
+        for (size_t i = 0; i < count; ++i)
+            values[i] = static_cast<_typename>(i * 2654435761u) - static_cast<_typename>(count);
+        return values;
+    }
+
+    template<class _typename>
+    bool round_trip(const int &encoding, const size_t &count) {
+        const std::vector<_typename> values = sample<_typename>(count);
+        wmemory_t buffer(0x10, policy_t::growable);
+        buffer.set_encoding(encoding);
+        buffer.set_array(values);
+        buffer.setInt(-7); // the cursor ends right after the array
+        buffer.rewind();
+        return buffer.get_array<_typename>() == values && buffer.get_int() == -7;
+    }
+
+    template<class _typename>
+    bool all(const int &encoding) {
+        return round_trip<_typename>(encoding, 0) && round_trip<_typename>(encoding, 1)
+               && round_trip<_typename>(encoding, 1000);
+    }
+
+    void encodings() {
+        for (const int &encoding: {encoding_t::fixed, encoding_t::compact}) {
+            CHECK(all<char>(encoding));
+            CHECK(all<short>(encoding));
+            CHECK(all<int>(encoding));
+            CHECK(all<long long>(encoding));
+            CHECK(all<uint16_t>(encoding));
+            CHECK(all<uint32_t>(encoding));
+            CHECK(all<uint64_t>(encoding));
+            CHECK(all<float>(encoding));
+            CHECK(all<double>(encoding));
+        }
+
+        std::vector<bool> flags = {true, false, false, true, true};
+        wmemory_t buffer(0x40);
+        buffer.set_array(std::vector<uint8_t>(flags.begin(), flags.end()));
+        buffer.rewind();
+        CHECK(buffer.get_array<bool>() == flags);
+    }
+
+    // a bulk write produces the bytes of a length followed by one write per element
+    void same_bytes() {
+        const std::vector<int> values = sample<int>(100);
+        for (const int &encoding: {encoding_t::fixed, encoding_t::compact}) {
+            wmemory_t bulk(0x1000), single(0x1000);
+            bulk.set_encoding(encoding), single.set_encoding(encoding);
+            bulk.set_array(values);
+            if (encoding == encoding_t::compact)
+                single.setUInt(values.size());
+            else
+                single.setULong(values.size());
+            for (const int &value: values)
+                single.setInt(value);
+            CHECK(bulk.lens() == single.lens());
+            CHECK(std::equal(bulk.data(), bulk.data() + bulk.lens(), single.data()));
+        }
+    }
+
+    void ranges() {
+        std::array<double, 4> source = {0.5, -1.5, 2.25, 1e300};
+        wmemory_t buffer(0x100);
+        buffer.set_array(source);
+        buffer.set_array(std::span<const double>(source).first(2));
+        buffer.rewind();
+
+        std::array<double, 4> out{};
+        CHECK(buffer.get_array(std::span<double>(out)) == 4);
+        CHECK(out == source);
+
+        // too small an output throws and leaves the position on the length
+        std::array<double, 1> small{};
+        const uintmax_t position = buffer.lens();
+        CHECK_THROWS(std::length_error, buffer.get_array(std::span<double>(small)));
+        CHECK(buffer.lens() == position);
+        CHECK(buffer.get_array(std::span<double>(out)) == 2);
+        CHECK(out[1] == -1.5);
+    }
+
+    // a count beyond the remaining bytes throws before anything is sized, the position stays
+    void truncated() {
+        for (const int encoding: {encoding_t::fixed, encoding_t::big, encoding_t::compact}) {
+            wmemory_t buffer(0x10, policy_t::growable);
+            buffer.set_encoding(encoding);
+            buffer.set_array(sample<long long>(50));
+            buffer.set_array(sample<double>(20));
+            std::vector<uint8_t> bytes(buffer.data(), buffer.data() + buffer.lens());
+
+            wmemory_t whole(bytes);
+            whole.set_encoding(encoding);
+            CHECK(whole.get_array<long long>() == sample<long long>(50));
+            const uintmax_t position = whole.lens();
+            for (size_t size = position + 1; size < bytes.size(); ++size) {
+                wmemory_t cut(bytes.data(), size);
+                cut.set_encoding(encoding);
+                (void) cut.get_array<long long>();
+                CHECK_THROWS(std::out_of_range, cut.get_array<double>());
+                CHECK(cut.lens() == position);
+            }
+            for (size_t size = 12; size < position; ++size) {
+                wmemory_t cut(bytes.data(), size);
+                cut.set_encoding(encoding);
+                CHECK_THROWS(std::out_of_range, cut.get_array<long long>());
+                CHECK(cut.lens() == 0);
+                long long out[50];
+                CHECK_THROWS(std::out_of_range, cut.get_array(std::span<long long>(out)));
+                CHECK(cut.lens() == 0);
+            }
+        }
+
+        // a corrupt count close to the integer limit
+        wmemory_t corrupt(0x20);
+        corrupt.setULong(UINT64_MAX / 2);
+        corrupt.setULong(1);
+        corrupt.rewind();
+        CHECK_THROWS(std::out_of_range, corrupt.get_array<uint16_t>());
+        CHECK_THROWS(std::out_of_range, corrupt.get_array<bool>());
+        CHECK(corrupt.lens() == 0);
+    }
+
+    void fixed_size() {
+        wmemory_t buffer(0x10);
+        CHECK_THROWS(std::runtime_error, buffer.set_array(sample<int>(100)));
+    }
+}
+
+int main() {
+    encodings();
+    same_bytes();
+    ranges();
+    truncated();
+    fixed_size();
+    return test::result();
+}
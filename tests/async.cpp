@@ -0,0 +1,84 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <filesystem>
+
+// io::async_t: many files in flight on both backends, futures, callbacks and reported errors
+namespace {
+    using namespace utils;
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "serializer_test_async";
+
+    std::string file(const int &index) {
+        return (directory / ("file_" + std::to_string(index) + ".bin")).string();
+    }
+
+    // more files than the submission ring holds, so some wait in the backlog
+    void backend(const int &kind) {
+        constexpr int FILES = 300;
+        std::vector<wmemory_t> buffers;
+        buffers.reserve(FILES);
+        for (int i = 0; i < FILES; ++i) {
+            buffers.emplace_back(0x10, policy_t::growable);
+            for (int value = 0; value <= i * 10; ++value)
+                buffers.back().setInt(value ^ i);
+        }
+
+        std::atomic<int> written{0}, failed{0};
+        {
+            io::async_t engine(kind, 2);
+            for (int i = 0; i < FILES; ++i)
+                engine.serialize(&buffers[i], file(i).c_str(), [&](std::exception_ptr error) {
+                    ++(error ? failed : written);
+                });
+        } // the destructor waits for the operations in flight
+        CHECK(written == FILES);
+        CHECK(failed == 0);
+
+        std::vector<wmemory_t> read;
+        for (int i = 0; i < FILES; ++i)
+            read.emplace_back(nullptr);
+        std::atomic<int> done{0};
+        {
+            io::async_t engine(kind);
+            for (int i = 0; i < FILES; ++i)
+                engine.deserialize(&read[i], file(i).c_str(), [&](std::exception_ptr error) {
+                    if (!error)
+                        ++done;
+                });
+        }
+        CHECK(done == FILES);
+        bool same = true;
+        for (int i = 0; i < FILES; ++i)
+            same = same && read[i].size() == buffers[i].lens()
+                   && std::equal(buffers[i].data(), buffers[i].data() + buffers[i].lens(), read[i].data());
+        CHECK(same);
+    }
+
+    void futures() {
+        wmemory_t out(0x100);
+        out.setString("future");
+        io::serialize_async(&out, file(0).c_str()).get();
+
+        wmemory_t in(nullptr);
+        io::deserialize_async(&in, file(0).c_str()).get();
+        CHECK(in.get_string() == "future");
+
+        const std::string missing = (directory / "missing" / "file.bin").string();
+        CHECK_THROWS(std::exception, io::serialize_async(&out, missing.c_str()).get());
+        CHECK_THROWS(std::exception, io::deserialize_async(&in, missing.c_str()).get());
+
+        std::promise<bool> called;
+        io::deserialize_async(&in, missing.c_str(), [&](std::exception_ptr error) { called.set_value(error != nullptr); });
+        CHECK(called.get_future().get());
+    }
+}
+
+int main() {
+    std::filesystem::create_directories(directory);
+    backend(io::backend_t::uring);
+    backend(io::backend_t::threads);
+    futures();
+    std::filesystem::remove_all(directory);
+    return test::result();
+}
@@ -0,0 +1,121 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <filesystem>
+#include <limits>
+
+// encoding_t::compact: LEB128 varints and zigzag on the wire, limits round trip, streams match
+namespace {
+    using namespace utils;
+
+    const std::string path = (std::filesystem::temp_directory_path() / "serializer_test_compact.bin").string();
+
+    bool bytes(wmemory_t &buffer, const std::vector<uint8_t> &expected) {
+        const bool same = buffer.lens() == expected.size() && std::equal(expected.begin(), expected.end(), buffer.data());
+        buffer.rewind();
+        return same;
+    }
+
+    void layout() {
+        wmemory_t buffer(0x40);
+        buffer.set_encoding(encoding_t::compact);
+        CHECK(buffer.encoding() == encoding_t::compact);
+
+        buffer.setUInt(0);
+        CHECK(bytes(buffer, {0x00}));
+        buffer.setUInt(127);
+        CHECK(bytes(buffer, {0x7F}));
+        buffer.setUInt(300);
+        CHECK(bytes(buffer, {0xAC, 0x02}));
+        buffer.setInt(-1);
+        CHECK(bytes(buffer, {0x01}));
+        buffer.setInt(1);
+        CHECK(bytes(buffer, {0x02}));
+        buffer.setInt(-64);
+        CHECK(bytes(buffer, {0x7F}));
+        buffer.setULong(std::numeric_limits<uint64_t>::max());
+        CHECK(bytes(buffer, {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01}));
+        buffer.setString("ab");
+        CHECK(bytes(buffer, {0x02, 'a', 'b'}));
+
+        // single bytes, bools and floating point keep their fixed width
+        buffer.setBytes('x');
+        buffer.setBool(true);
+        buffer.setDouble(1.5);
+        CHECK(buffer.lens() == 2 + sizeof(double));
+    }
+
+    void limits() {
+        wmemory_t buffer(0x10, policy_t::growable);
+        buffer.set_encoding(encoding_t::compact);
+        const long long longs[] = {0, -1, 1, std::numeric_limits<long long>::min(), std::numeric_limits<long long>::max()};
+        const int ints[] = {std::numeric_limits<int>::min(), std::numeric_limits<int>::max(), -300, 300};
+        for (const long long &value: longs)
+            buffer.setLong(value);
+        for (const int &value: ints)
+            buffer.setInt(value);
+        buffer.setShort(std::numeric_limits<short>::min());
+        buffer.setUShort(std::numeric_limits<uint16_t>::max());
+        buffer.setUInt(std::numeric_limits<uint32_t>::max());
+        buffer.setULong(std::numeric_limits<uint64_t>::max());
+        buffer.setString(std::string(200, 'z')); // a two-byte length
+        buffer.setFloat(-0.5f);
+
+        buffer.rewind();
+        for (const long long &value: longs)
+            CHECK(buffer.get_llong() == value);
+        for (const int &value: ints)
+            CHECK(buffer.get_int() == value);
+        CHECK(buffer.get_short() == std::numeric_limits<short>::min());
+        CHECK(buffer.get_ushort() == std::numeric_limits<uint16_t>::max());
+        CHECK(buffer.get_uint() == std::numeric_limits<uint32_t>::max());
+        CHECK(buffer.get_uint64() == std::numeric_limits<uint64_t>::max());
+        CHECK(buffer.get_string() == std::string(200, 'z'));
+        CHECK(buffer.get_float() == -0.5f);
+    }
+
+    void smaller() {
+        wmemory_t fixed(0x1000), compact(0x1000);
+        compact.set_encoding(encoding_t::compact);
+        for (int i = -100; i < 100; ++i) {
+            fixed.setInt(i), compact.setInt(i);
+            fixed.setString("id"), compact.setString("id");
+        }
+        CHECK(compact.lens() * 3 < fixed.lens());
+    }
+
+    void streams() {
+        wmemory_t expected(0x100, policy_t::growable);
+        expected.set_encoding(encoding_t::compact);
+        {
+            io::stream_writer_t out(path.c_str(), 0x40);
+            out.set_encoding(encoding_t::compact);
+            for (int i = -500; i < 500; ++i) {
+                out.setInt(i * 1000), expected.setInt(i * 1000);
+                out.setString(std::to_string(i)), expected.setString(std::to_string(i));
+            }
+        }
+        wmemory_t written(nullptr);
+        io::deserialize(&written, path.c_str());
+        CHECK(written.size() == expected.lens());
+        CHECK(std::equal(expected.data(), expected.data() + expected.lens(), written.data()));
+
+        io::stream_reader_t in(path.c_str(), 0x40);
+        in.set_encoding(encoding_t::compact);
+        bool same = true;
+        for (int i = -500; i < 500; ++i) {
+            same = same && in.get_int() == i * 1000;
+            same = same && in.get_string() == std::to_string(i);
+        }
+        CHECK(same);
+        std::filesystem::remove(path);
+    }
+}
+
+int main() {
+    layout();
+    limits();
+    smaller();
+    streams();
+    return test::result();
+}
@@ -0,0 +1,115 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <thread>
+
+// concurrent::alloc_ / free_: distinct blocks across threads, cross-thread frees, large blocks
+namespace {
+    using namespace utils;
+
+    constexpr int THREADS = 4;
+    constexpr int ROUNDS = 200;
+
+    // every thread fills its blocks with its own pattern and checks nobody else wrote over them
+    void churn(const uint8_t &pattern, bool &intact) {
+        std::vector<std::pair<uint8_t *, size_t>> blocks;
+        for (int round = 0; round < ROUNDS; ++round) {
+            const size_t size = 1 + (round * 37) % concurrent::MAX_CLASS_SIZE;
+            uint8_t *block = static_cast<uint8_t *>(concurrent::alloc_(size));
+            if (block == nullptr) {
+                intact = false;
+                return;
+            }
+            if (reinterpret_cast<uintptr_t>(block) % ALIGNMENT != 0x00)
+                intact = false;
+            std::fill(block, block + size, pattern);
+            blocks.emplace_back(block, size);
+            if (blocks.size() > 16) {
+                auto [first, length] = blocks.front();
+                intact = intact && std::all_of(first, first + length, [&](uint8_t c) { return c == pattern; });
+                concurrent::free_(first);
+                blocks.erase(blocks.begin());
+            }
+        }
+        for (auto [block, size]: blocks) {
+            intact = intact && std::all_of(block, block + size, [&](uint8_t c) { return c == pattern; });
+            concurrent::free_(block);
+        }
+    }
+
+    void threads() {
+        bool intact[THREADS] = {true, true, true, true};
+        std::vector<std::thread> workers;
+        for (int i = 0; i < THREADS; ++i)
+            workers.emplace_back(churn, static_cast<uint8_t>(0x10 + i), std::ref(intact[i]));
+        for (std::thread &worker: workers)
+            worker.join();
+        for (const bool &ok: intact)
+            CHECK(ok);
+    }
+
+    void cross_thread_free() {
+        std::vector<void *> blocks;
+        for (int i = 0; i < 100; ++i)
+            blocks.push_back(concurrent::alloc_(64));
+        CHECK(std::find(blocks.begin(), blocks.end(), nullptr) == blocks.end());
+        std::thread([&] {
+            for (void *block: blocks)
+                concurrent::free_(block);
+        }).join(); // the other thread's cache drains back to the central pool when it exits
+
+        void *again = concurrent::alloc_(64);
+        CHECK(again != nullptr);
+        concurrent::free_(again);
+    }
+
+    void large_blocks() {
+        const size_t size = concurrent::MAX_CLASS_SIZE * 4;
+        uint8_t *first = static_cast<uint8_t *>(concurrent::alloc_(size));
+        uint8_t *second = static_cast<uint8_t *>(concurrent::alloc_(size));
+        CHECK(first != nullptr);
+        CHECK(second != nullptr);
+        CHECK(second >= first + size || first >= second + size);
+        std::fill(first, first + size, 0xAA);
+        std::fill(second, second + size, 0x55);
+        CHECK(first[size - 1] == 0xAA);
+        concurrent::free_(first);
+        concurrent::free_(second);
+
+        // the freed space goes back to the heap and is found again
+        void *again = concurrent::alloc_(size);
+        CHECK(again != nullptr);
+        concurrent::free_(again);
+    }
+
+    // slabs go back to the heap once all their objects are free, so a large block fits again
+    void slabs_returned() {
+        std::thread([] {
+            std::vector<void *> blocks;
+            while (void *block = concurrent::alloc_(concurrent::MAX_CLASS_SIZE))
+                blocks.push_back(block);
+            CHECK(!blocks.empty());
+            for (void *block: blocks)
+                concurrent::free_(block);
+        }).join();
+
+        void *large = concurrent::alloc_(HEAP_SIZE / 2);
+        CHECK(large != nullptr);
+        concurrent::free_(large);
+    }
+
+    void edges() {
+        CHECK(concurrent::alloc_(0) == nullptr);
+        concurrent::free_(nullptr);
+        CHECK(concurrent::alloc_(HEAP_SIZE * 2) == nullptr);
+    }
+}
+
+int main() {
+    slabs_returned();
+    threads();
+    cross_thread_free();
+    large_blocks();
+    edges();
+    return test::result();
+}
@@ -0,0 +1,116 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <limits>
+
+// encoding_t::little / big: bytes on the wire, round trips, bulk arrays swapped like single values
+namespace {
+    using namespace utils;
+
+    bool bytes(wmemory_t &buffer, const std::vector<uint8_t> &expected) {
+        const bool same = buffer.lens() == expected.size() && std::equal(expected.begin(), expected.end(), buffer.data());
+        buffer.rewind();
+        return same;
+    }
+
+    void layout() {
+        wmemory_t buffer(0x40);
+        buffer.set_encoding(encoding_t::big);
+        buffer.setInt(0x01020304);
+        CHECK(bytes(buffer, {0x01, 0x02, 0x03, 0x04}));
+        buffer.setUShort(0xABCD);
+        CHECK(bytes(buffer, {0xAB, 0xCD}));
+        buffer.setDouble(1.0);
+        CHECK(bytes(buffer, {0x3F, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}));
+        buffer.setString("hi"); // the length is a 64-bit prefix in wire order too
+        CHECK(bytes(buffer, {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 'h', 'i'}));
+
+        buffer.set_encoding(encoding_t::little);
+        buffer.setInt(0x01020304);
+        CHECK(bytes(buffer, {0x04, 0x03, 0x02, 0x01}));
+        buffer.setFloat(1.0f);
+        CHECK(bytes(buffer, {0x00, 0x00, 0x80, 0x3F}));
+
+        // varints have a single byte order, compact only changes the fixed-width values
+        buffer.set_encoding(encoding_t::compact | encoding_t::big);
+        buffer.setUInt(300);
+        buffer.setDouble(1.0);
+        CHECK(bytes(buffer, {0xAC, 0x02, 0x3F, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}));
+    }
+
+    void round_trip(const int &encoding) {
+        wmemory_t buffer(0x10, policy_t::growable);
+        buffer.set_encoding(encoding);
+        buffer.setShort(std::numeric_limits<short>::min());
+        buffer.setInt(-123456789);
+        buffer.setLong(std::numeric_limits<long long>::min());
+        buffer.setUShort(0xBEEF);
+        buffer.setUInt(0xDEADBEEF);
+        buffer.setULong(0x0102030405060708);
+        buffer.setFloat(-3.5f);
+        buffer.setDouble(6.02214076e23);
+        buffer.setBytes('q');
+        buffer.setBool(true);
+        buffer.setString("round trip");
+
+        buffer.rewind();
+        CHECK(buffer.get_short() == std::numeric_limits<short>::min());
+        CHECK(buffer.get_int() == -123456789);
+        CHECK(buffer.get_long() == std::numeric_limits<long long>::min());
+        CHECK(buffer.get_ushort() == 0xBEEF);
+        CHECK(buffer.get_uint() == 0xDEADBEEF);
+        CHECK(buffer.get_uint64() == 0x0102030405060708);
+        CHECK(buffer.get_float() == -3.5f);
+        CHECK(buffer.get_double() == 6.02214076e23);
+        CHECK(buffer.get_bytes() == 'q');
+        CHECK(buffer.get_bool());
+        CHECK(buffer.get_string() == "round trip");
+    }
+
+    void put(wmemory_t &buffer, const uint16_t &value) { buffer.setUShort(value); }
+    void put(wmemory_t &buffer, const int &value) { buffer.setInt(value); }
+    void put(wmemory_t &buffer, const uint64_t &value) { buffer.setULong(value); }
+    void put(wmemory_t &buffer, const float &value) { buffer.setFloat(value); }
+    void put(wmemory_t &buffer, const double &value) { buffer.setDouble(value); }
+
+    // the vectorized swap handles every length, including the tail after the last full block
+    template<class _typename>
+    bool arrays(const int &encoding) {
+        bool same = true;
+        for (size_t count: {0, 1, 3, 7, 8, 9, 17, 1000}) {
+            std::vector<_typename> values(count);
+            for (size_t i = 0; i < count; ++i)
+                values[i] = static_cast<_typename>(0x0102030405060708ull * (i + 1));
+            wmemory_t bulk(0x10, policy_t::growable), single(0x10, policy_t::growable);
+            bulk.set_encoding(encoding), single.set_encoding(encoding);
+            bulk.set_array(values);
+            single.setULong(count);
+            for (const _typename &value: values)
+                put(single, value);
+            same = same && bulk.lens() == single.lens()
+                   && std::equal(bulk.data(), bulk.data() + bulk.lens(), single.data());
+            bulk.rewind();
+            same = same && bulk.get_array<_typename>() == values;
+        }
+        return same;
+    }
+
+    void bulk() {
+        for (const int &encoding: {encoding_t::little, encoding_t::big}) {
+            CHECK(arrays<uint16_t>(encoding));
+            CHECK(arrays<int>(encoding));
+            CHECK(arrays<uint64_t>(encoding));
+            CHECK(arrays<float>(encoding));
+            CHECK(arrays<double>(encoding));
+        }
+    }
+}
+
+int main() {
+    layout();
+    for (const int &encoding: {encoding_t::little, encoding_t::big, encoding_t::little | encoding_t::compact,
+                               encoding_t::big | encoding_t::compact})
+        round_trip(encoding);
+    bulk();
+    return test::result();
+}
@@ -0,0 +1,67 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <limits>
+
+// format_to: every argument type, exact fit and overflow, appends into wmemory_t
+namespace {
+    using namespace utils;
+
+    template<class... _args>
+    std::string formatted(format_string_t<_args...> fmt, const _args &... args) {
+        char out[256];
+        return std::string(out, format_to(std::span<char>(out), fmt, args...));
+    }
+
+    void values() {
+        CHECK(formatted("plain") == "plain");
+        CHECK(formatted("{}", 42) == "42");
+        CHECK(formatted("{}{}", 1, 2) == "12");
+        CHECK(formatted("a={} b={} c={}", -7, 3u, 'x') == "a=-7 b=3 c=x");
+        CHECK(formatted("{} {}", true, false) == "1 0");
+        CHECK(formatted("{}", uint8_t(200)) == "200");
+        CHECK(formatted("{}", std::numeric_limits<int64_t>::min()) == "-9223372036854775808");
+        CHECK(formatted("{}", std::numeric_limits<uint64_t>::max()) == "18446744073709551615");
+        CHECK(formatted("{} {}", 0.1, 1e300) == "0.1 1e+300");
+        CHECK(formatted("{}", 123456789.0) == "123456789");
+        CHECK(formatted("{}", -0.5f) == "-0.5");
+        CHECK(formatted("[{}|{}|{}]", "literal", std::string("string"), std::string_view("view")) == "[literal|string|view]");
+        CHECK(formatted("{}", "") == "");
+        CHECK(formatted("{ } {}", 1) == "{ } 1");
+    }
+
+    void bounds() {
+        char exact[5];
+        CHECK(format_to(std::span<char>(exact), "ab{}", 123) == 5);
+        CHECK(std::string_view(exact, 5) == "ab123");
+        CHECK_THROWS(std::length_error, format_to(std::span<char>(exact), "ab{}", 1234));
+        CHECK_THROWS(std::length_error, format_to(std::span<char>(exact), "abcdef"));
+        CHECK_THROWS(std::length_error, format_to(std::span<char>(exact, 2), "{}", std::string("long")));
+        CHECK_THROWS(std::length_error, format_to(std::span<char>(exact, 0), "{}", 'c'));
+    }
+
+    void buffers() {
+        wmemory_t growable(0x4, policy_t::growable);
+        for (int i = 0; i < 100; ++i)
+            format_to(&growable, "line {}: {} {}\n", i, i * 0.5, "ok");
+        std::string expected;
+        for (int i = 0; i < 100; ++i)
+            expected += "line " + std::to_string(i) + ": " + formatted("{}", i * 0.5) + " ok\n";
+        CHECK(std::string_view(reinterpret_cast<const char *>(growable.data()), growable.lens()) == expected);
+
+        // raw characters, no length prefix, next to regular values
+        wmemory_t fixed(0x10);
+        fixed.setBytes('<');
+        format_to(&fixed, "{}-{}", 1, 2);
+        CHECK(fixed.lens() == 4);
+        CHECK(std::string_view(reinterpret_cast<const char *>(fixed.data()), 4) == "<1-2");
+        CHECK_THROWS(std::runtime_error, format_to(&fixed, "{}", std::string(0x20, 'x')));
+    }
+}
+
+int main() {
+    values();
+    bounds();
+    buffers();
+    return test::result();
+}
@@ -0,0 +1,103 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <algorithm>
+#include <random>
+
+// alloc_ / free_: blocks stay aligned and disjoint under churn, and freeing everything coalesces back
+namespace {
+    using namespace utils;
+
+    struct block_t {
+        uint8_t *data;
+        size_t size;
+        uint8_t fill;
+    };
+
+    // the whole pool minus the header of its only block
+    constexpr size_t WHOLE = HEAP_SIZE - sizeof(BlockHeader);
+
+    void churn(std::mt19937_64 &engine) {
+        std::vector<block_t> live;
+        for (int step = 0; step < 20000; ++step) {
+            if (!live.empty() && (engine() % 3 == 0 || live.size() > 300)) {
+                const size_t at = engine() % live.size();
+                const block_t block = live[at];
+                CHECK(std::all_of(block.data, block.data + block.size, [&](uint8_t byte) { return byte == block.fill; }));
+                free_(block.data);
+                live[at] = live.back();
+                live.pop_back();
+                continue;
+            }
+            const size_t size = 1 + engine() % (engine() % 8 == 0 ? 0x2000 : 0x100);
+            uint8_t *data = static_cast<uint8_t *>(alloc_(size));
+            CHECK(data != nullptr); // at most ~300 live blocks, far below the pool size
+            if (data == nullptr)
+                continue;
+            CHECK(reinterpret_cast<uintptr_t>(data) % ALIGNMENT == 0);
+            CHECK(data >= heap && data + size <= heap + HEAP_SIZE);
+            const uint8_t fill = static_cast<uint8_t>(step);
+            std::fill(data, data + size, fill);
+            live.push_back({data, size, fill});
+        }
+
+        std::sort(live.begin(), live.end(), [](const block_t &a, const block_t &b) { return a.data < b.data; });
+        for (size_t i = 1; i < live.size(); ++i)
+            CHECK(live[i - 1].data + live[i - 1].size <= live[i].data);
+
+        std::shuffle(live.begin(), live.end(), engine);
+        for (const block_t &block: live)
+            free_(block.data);
+    }
+
+    // a request that fits only some blocks of its own free list is still served
+    void exact_fit() {
+        void *a = alloc_(1000), *fence = alloc_(16), *b = alloc_(1016);
+        void *rest = alloc_(WHOLE - 1000 - 16 - 1016 - 3 * sizeof(BlockHeader)); // nothing larger is left
+        CHECK(rest != nullptr);
+        free_(a);
+        free_(b);
+        void *c = alloc_(1010);
+        CHECK(c == b);
+        free_(c);
+        free_(fence);
+        free_(rest);
+    }
+
+    // a freed block merges with the free block before it, after it, or both
+    void neighbours() {
+        void *a = alloc_(64), *b = alloc_(64), *c = alloc_(64), *d = alloc_(64), *e = alloc_(64);
+        free_(b);
+        free_(d);
+        free_(c); // merges b, c and d
+        void *merged = alloc_(3 * 64 + 2 * sizeof(BlockHeader));
+        CHECK(merged == b);
+        free_(merged);
+        free_(a); // merges with the free run after it
+        void *front = alloc_(4 * 64 + 3 * sizeof(BlockHeader));
+        CHECK(front == a);
+        free_(e); // merges with the rest of the pool
+        free_(front);
+    }
+
+    void whole() {
+        void *block = alloc_(WHOLE);
+        CHECK(block != nullptr); // nothing left fragmented
+        CHECK(alloc_(1) == nullptr);
+        free_(block);
+        CHECK(alloc_(0) == nullptr);
+        CHECK(alloc_(HEAP_SIZE + 1) == nullptr);
+        free_(nullptr);
+    }
+}
+
+int main() {
+    std::mt19937_64 engine(0x7A5F);
+    churn(engine);
+    whole();
+    exact_fit();
+    whole();
+    neighbours();
+    whole();
+    return test::result();
+}
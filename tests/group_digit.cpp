@@ -0,0 +1,77 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <limits>
+#include <random>
+
+// group_digit / group_digits: every digit count, minimum values, reference grouping, short outputs
+namespace {
+    using namespace utils;
+
+    // grouping done the slow way, to compare against
+    std::string reference(const std::string &digits, const char &separator) {
+        const bool negative = digits[0] == '-';
+        std::string grouped;
+        const size_t first = negative ? 1 : 0;
+        for (size_t i = first; i < digits.size(); ++i) {
+            if (i != first && (digits.size() - i) % 3 == 0)
+                grouped += separator;
+            grouped += digits[i];
+        }
+        return negative ? "-" + grouped : grouped;
+    }
+
+    template<class _typename>
+    bool matches(const _typename &number, const char &separator = ',') {
+        return group_digit(number, separator) == reference(std::to_string(number), separator);
+    }
+
+    void numbers(std::mt19937_64 &engine) {
+        CHECK(group_digit(0) == "0");
+        CHECK(group_digit(999) == "999");
+        CHECK(group_digit(1000) == "1,000");
+        CHECK(group_digit(-1234567) == "-1,234,567");
+        CHECK(group_digit(1234567, '.') == "1.234.567");
+        CHECK(group_digit(std::numeric_limits<int64_t>::min()) == "-9,223,372,036,854,775,808");
+        CHECK(group_digit(std::numeric_limits<uint64_t>::max()) == "18,446,744,073,709,551,615");
+        CHECK(group_digit(std::numeric_limits<int8_t>::min()) == "-128");
+        CHECK(group_digit(std::numeric_limits<short>::min()) == "-32,768");
+        CHECK(group_digit(std::numeric_limits<int>::min()) == "-2,147,483,648");
+
+        // every power of ten and its neighbours, then random magnitudes
+        bool same = true;
+        for (uint64_t power = 1; power <= 1000000000000000000ull; power *= 10)
+            same = same && matches(power - 1) && matches(power) && matches(power + 1)
+                   && matches(-static_cast<int64_t>(power)) && matches(1 - static_cast<int64_t>(power));
+        for (int i = 0; i < 10000; ++i) {
+            const uint64_t value = engine() >> (engine() % 64);
+            same = same && matches(value) && matches(static_cast<int64_t>(value)) && matches(static_cast<int32_t>(value), ' ');
+        }
+        CHECK(same);
+    }
+
+    void buffers() {
+        char out[9];
+        CHECK(group_digit(std::span<char>(out), 1234567) == 9);
+        CHECK(std::string_view(out, 9) == "1,234,567");
+        CHECK_THROWS(std::length_error, group_digit(std::span<char>(out), -1234567));
+        CHECK_THROWS(std::length_error, group_digit(std::span<char>(out, 0), 0));
+
+        const std::vector<int64_t> values = {0, -1, 1000, std::numeric_limits<int64_t>::min(), 999999};
+        CHECK(group_digits(values) == "0\n-1\n1,000\n-9,223,372,036,854,775,808\n999,999\n");
+        CHECK(group_digits(values, '_', ';') == "0;-1;1_000;-9_223_372_036_854_775_808;999_999;");
+        CHECK(group_digits(std::vector<int>()).empty());
+
+        char small[12];
+        CHECK(group_digits(std::span<char>(small), std::vector<int>{1, 22, 333}) == 9);
+        CHECK(std::string_view(small, 9) == "1\n22\n333\n");
+        CHECK_THROWS(std::length_error, group_digits(std::span<char>(small), std::vector<int>{1, 22, 444444}));
+    }
+}
+
+int main() {
+    std::mt19937_64 engine(0x6D16);
+    numbers(engine);
+    buffers();
+    return test::result();
+}
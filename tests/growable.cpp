@@ -0,0 +1,66 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+
+// policy_t: a fixed buffer throws once full, a growable one doubles and keeps what was written
+namespace {
+    using namespace utils;
+
+    void fixed() {
+        wmemory_t buffer(8);
+        CHECK(buffer.policy() == policy_t::fixed);
+        buffer.setInt(1);
+        buffer.setInt(2);
+        CHECK(buffer.lens() == 8);
+        CHECK_THROWS(std::runtime_error, buffer.setInt(3));
+        CHECK(buffer.lens() == 8 && buffer.size() == 8);
+        CHECK_THROWS(std::runtime_error, buffer.setString("too long"));
+    }
+
+    void growable() {
+        wmemory_t buffer(1, policy_t::growable);
+        for (int i = 0; i < 0x1000; ++i)
+            buffer.setInt(i);
+        buffer.setString("tail");
+        CHECK(buffer.lens() == 0x1000 * sizeof(int) + sizeof(uint64_t) + 4);
+        CHECK(buffer.size() >= buffer.lens());
+        CHECK(buffer.size() < 2 * buffer.lens() + 0x40); // geometric, not far beyond what's needed
+
+        wmemory_t copy(std::vector<uint8_t>(buffer.data(), buffer.data() + buffer.lens()));
+        bool same = true;
+        for (int i = 0; i < 0x1000; ++i)
+            same &= copy.get_int() == i;
+        CHECK(same);
+        CHECK(copy.get_string() == "tail");
+
+        // a single value bigger than twice the capacity
+        wmemory_t small(4, policy_t::growable);
+        const std::string large(1000, 'x');
+        small.setString(large);
+        CHECK(small.size() >= sizeof(uint64_t) + large.size());
+        CHECK(wmemory_t(std::vector<uint8_t>(small.data(), small.data() + small.lens())).get_string() == large);
+    }
+
+    void reserve_and_resize() {
+        wmemory_t buffer(4, policy_t::growable);
+        buffer.setInt(7);
+        buffer.reserve(0x100);
+        CHECK(buffer.size() == 0x100 && buffer.lens() == 4);
+        buffer.reserve(0x10); // never shrinks
+        CHECK(buffer.size() == 0x100);
+        CHECK(wmemory_t(std::vector<uint8_t>(buffer.data(), buffer.data() + 4)).get_int() == 7);
+
+        buffer.resize(2); // the position is clamped to the new size
+        CHECK(buffer.size() == 2 && buffer.lens() == 2);
+
+        buffer.set_policy(policy_t::fixed);
+        CHECK_THROWS(std::runtime_error, buffer.setInt(1));
+    }
+}
+
+int main() {
+    fixed();
+    growable();
+    reserve_and_resize();
+    return test::result();
+}
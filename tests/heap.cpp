@@ -0,0 +1,147 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <algorithm>
+#include <map>
+#include <random>
+
+// heap_t: blocks stay aligned, inside the region and disjoint, and freeing everything coalesces back
+namespace {
+    using namespace utils;
+
+    struct block_t {
+        uint8_t *data;
+        size_t size;
+        uint8_t fill;
+    };
+
+    void invariants(std::mt19937_64 &engine) {
+        heap_t heap(0x40000);
+        const size_t whole = heap.largest_free();
+        CHECK(whole == heap.size() - sizeof(BlockHeader));
+        CHECK(heap.alloc(0) == nullptr);
+        CHECK(heap.alloc(heap.size() + 1) == nullptr);
+
+        std::vector<block_t> live;
+        for (int step = 0; step < 20000; ++step) {
+            if (!live.empty() && (engine() % 3 == 0 || live.size() > 200)) {
+                const size_t at = engine() % live.size();
+                const block_t block = live[at];
+                CHECK(std::all_of(block.data, block.data + block.size, [&](uint8_t byte) { return byte == block.fill; }));
+                heap.free(block.data);
+                live[at] = live.back();
+                live.pop_back();
+                continue;
+            }
+            const size_t size = 1 + engine() % (engine() % 8 == 0 ? 0x2000 : 0x100);
+            const size_t largest = heap.largest_free();
+            uint8_t *data = static_cast<uint8_t *>(heap.alloc(size));
+            if (size <= largest)
+                CHECK(data != nullptr); // whatever the fragmentation, the largest free block fits
+            if (data == nullptr)
+                continue;
+            CHECK(reinterpret_cast<uintptr_t>(data) % ALIGNMENT == 0);
+            CHECK(data >= heap.data() && data + size <= heap.data() + heap.size());
+            const uint8_t fill = static_cast<uint8_t>(step);
+            std::fill(data, data + size, fill);
+            live.push_back({data, size, fill});
+        }
+
+        std::sort(live.begin(), live.end(), [](const block_t &a, const block_t &b) { return a.data < b.data; });
+        for (size_t i = 1; i < live.size(); ++i)
+            CHECK(live[i - 1].data + live[i - 1].size <= live[i].data);
+        CHECK(heap.largest_free() < whole);
+
+        std::shuffle(live.begin(), live.end(), engine);
+        for (const block_t &block: live)
+            heap.free(block.data);
+        CHECK(heap.largest_free() == whole); // nothing left fragmented
+        CHECK(heap.alloc(whole) != nullptr);
+        CHECK(heap.largest_free() == 0);
+        CHECK(heap.alloc(1) == nullptr);
+    }
+
+    void reinitialize() {
+        static uint8_t region[0x10000];
+        heap_t heap(region, sizeof(region));
+        for (int i = 0; i < 50; ++i)
+            CHECK(heap.alloc(0x100) != nullptr);
+        heap.initialize();
+        CHECK(heap.alloc(sizeof(region) - sizeof(BlockHeader)) != nullptr);
+        CHECK_THROWS(std::invalid_argument, heap_t(nullptr, sizeof(region)));
+        CHECK_THROWS(std::invalid_argument, heap_t(region, sizeof(BlockHeader)));
+    }
+
+    // a heap carved out of another heap
+    void nested() {
+        heap_t parent(0x20000);
+        {
+            heap_t child(0x8000, &parent);
+            CHECK(child.data() >= parent.data() && child.data() + child.size() <= parent.data() + parent.size());
+            CHECK(child.alloc(0x100) != nullptr);
+            CHECK(parent.alloc(0x20000 - sizeof(BlockHeader)) == nullptr);
+        }
+        CHECK(parent.alloc(0x20000 - sizeof(BlockHeader)) != nullptr); // the child gave its region back
+    }
+
+    // parent resource checking that every region comes back with the size it was requested with
+    class checking_t : public std::pmr::memory_resource {
+    public:
+        std::map<void *, size_t> regions;
+        bool matched = true;
+
+    protected:
+        void *do_allocate(size_t bytes, size_t alignment) override {
+            void *ptr = std::pmr::new_delete_resource()->allocate(bytes, alignment);
+            regions[ptr] = bytes;
+            return ptr;
+        }
+
+        void do_deallocate(void *ptr, size_t bytes, size_t alignment) override {
+            matched = matched && regions[ptr] == bytes;
+            regions.erase(ptr);
+            std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    void upstream_size() {
+        checking_t upstream;
+        {
+            heap_t heap(0x10003, &upstream); // not a multiple of ALIGNMENT
+            CHECK(heap.size() <= 0x10003);
+            CHECK(heap.alloc(0x100) != nullptr);
+        }
+        CHECK(upstream.regions.empty());
+        CHECK(upstream.matched);
+
+        // a size that is too small is rejected before anything is taken from the upstream
+        CHECK_THROWS(std::invalid_argument, heap_t(sizeof(BlockHeader), &upstream));
+        CHECK_THROWS(std::invalid_argument, heap_t(0, &upstream));
+        CHECK(upstream.regions.empty());
+    }
+
+    void memory_resource() {
+        heap_t heap(0x10000);
+        std::pmr::vector<int> values(&heap);
+        for (int i = 0; i < 1000; ++i)
+            values.push_back(i);
+        CHECK(values[999] == 999);
+        values = std::pmr::vector<int>(&heap);
+        values.shrink_to_fit();
+        CHECK(heap.alloc(heap.size() - sizeof(BlockHeader)) != nullptr);
+    }
+}
+
+int main() {
+    std::mt19937_64 engine(0x71F5);
+    invariants(engine);
+    reinitialize();
+    nested();
+    upstream_size();
+    memory_resource();
+    return test::result();
+}
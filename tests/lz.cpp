@@ -0,0 +1,143 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+// lz::compress / lz::decompress on random, repetitive and corrupt blocks, compressed files
+namespace {
+    using namespace utils;
+
+    const std::string path = (std::filesystem::temp_directory_path() / "serializer_test_lz.bin").string();
+
+    std::vector<uint8_t> compress(const std::vector<uint8_t> &block) {
+        std::vector<uint8_t> out(lz::bound(block.size()));
+        out.resize(lz::compress(block.data(), block.size(), out.data()));
+        return out;
+    }
+
+    bool round_trips(const std::vector<uint8_t> &block) {
+        const std::vector<uint8_t> compressed = compress(block);
+        std::vector<uint8_t> decoded(block.size());
+        return compressed.size() <= lz::bound(block.size())
+               && lz::decompress(compressed.data(), compressed.size(), decoded.data(), decoded.size())
+               && decoded == block;
+    }
+
+    void random(std::mt19937_64 &engine) {
+        for (const size_t size: {0, 1, 4, 12, 13, 64, 1000, 0x10000, 0x40001}) {
+            std::vector<uint8_t> block(size);
+            for (uint8_t &byte: block)
+                byte = static_cast<uint8_t>(engine());
+            CHECK(round_trips(block));
+        }
+    }
+
+    void repetitive(std::mt19937_64 &engine) {
+        std::vector<uint8_t> zeros(0x10000, 0x00);
+        CHECK(round_trips(zeros));
+        CHECK(compress(zeros).size() < zeros.size() / 100);
+
+        // short alphabet with repeats at every distance, overlapping matches included
+        for (const size_t period: {1, 2, 3, 7, 16, 100, 5000}) {
+            std::vector<uint8_t> block(0x20000);
+            for (size_t i = 0; i < block.size(); ++i)
+                block[i] = static_cast<uint8_t>(i % period < 3 ? engine() % 4 : 'a' + i % period);
+            CHECK(round_trips(block));
+        }
+
+        std::string text;
+        while (text.size() < 0x8000)
+            text += "time=1712345678 level=info msg=\"request served\" status=200\n";
+        const std::vector<uint8_t> log(text.begin(), text.end());
+        CHECK(round_trips(log));
+        CHECK(compress(log).size() < log.size() / 4);
+    }
+
+    void corrupt(std::mt19937_64 &engine) {
+        std::vector<uint8_t> block(0x4000);
+        for (size_t i = 0; i < block.size(); ++i)
+            block[i] = static_cast<uint8_t>(i % 64 < 8 ? engine() : i % 13);
+        const std::vector<uint8_t> compressed = compress(block);
+        std::vector<uint8_t> decoded(block.size());
+
+        // wrong size, every truncation
+        CHECK(!lz::decompress(compressed.data(), compressed.size(), decoded.data(), decoded.size() - 1));
+        decoded.resize(block.size() + 1);
+        CHECK(!lz::decompress(compressed.data(), compressed.size(), decoded.data(), decoded.size()));
+        decoded.resize(block.size());
+        for (size_t size = 0; size < compressed.size(); ++size)
+            CHECK(!lz::decompress(compressed.data(), size, decoded.data(), decoded.size()));
+
+        // random bit flips and random garbage must never read or write out of bounds
+        for (int round = 0; round < 2000; ++round) {
+            std::vector<uint8_t> damaged = compressed;
+            for (int flip = 0; flip < 1 + round % 4; ++flip)
+                damaged[engine() % damaged.size()] ^= static_cast<uint8_t>(1u << engine() % 8);
+            lz::decompress(damaged.data(), damaged.size(), decoded.data(), decoded.size());
+        }
+        for (int round = 0; round < 2000; ++round) {
+            std::vector<uint8_t> garbage(1 + engine() % 256);
+            for (uint8_t &byte: garbage)
+                byte = static_cast<uint8_t>(engine());
+            lz::decompress(garbage.data(), garbage.size(), decoded.data(), decoded.size());
+        }
+
+        // an offset reaching before the start of the output
+        const uint8_t before_start[] = {0x10, 'a', 0x05, 0x00, 0x50, 'b', 'c', 'd', 'e', 'f'};
+        std::vector<uint8_t> out(0x20);
+        CHECK(!lz::decompress(before_start, sizeof(before_start), out.data(), out.size()));
+    }
+
+    // several blocks, some stored raw, read back whole or by range
+    void files(std::mt19937_64 &engine) {
+        wmemory_t buffer(0x10, policy_t::growable);
+        for (int i = 0; i < 20000; ++i) {
+            buffer.setInt(i % 100);
+            buffer.setString(i % 1000 < 500 ? "compressible text" : std::to_string(engine()));
+        }
+        io::serialize_compressed(&buffer, path.c_str(), 0x1003, 2);
+        CHECK(std::filesystem::file_size(path) < buffer.lens());
+
+        wmemory_t whole(nullptr);
+        io::deserialize_compressed(&whole, path.c_str(), 2);
+        CHECK(whole.size() == buffer.lens());
+        CHECK(std::equal(buffer.data(), buffer.data() + buffer.lens(), whole.data()));
+
+        io::compressed_reader_t reader(path.c_str());
+        CHECK(reader.size() == buffer.lens());
+        CHECK(reader.block_size() == 0x1003);
+        CHECK(reader.blocks() == (buffer.lens() + 0x1002) / 0x1003);
+        bool same = true;
+        for (int round = 0; round < 200; ++round) {
+            const uintmax_t offset = engine() % reader.size();
+            std::vector<uint8_t> out(std::min<uintmax_t>(engine() % 0x3000, reader.size() - offset));
+            reader.read(offset, out);
+            same = same && std::equal(out.begin(), out.end(), buffer.data() + offset);
+        }
+        CHECK(same);
+        std::vector<uint8_t> block(reader.block_size());
+        CHECK_THROWS(std::out_of_range, reader.read_block(reader.blocks(), block.data()));
+        CHECK_THROWS(std::out_of_range, reader.read(reader.size(), std::span<uint8_t>(block.data(), 1)));
+        CHECK_THROWS(std::invalid_argument, io::serialize_compressed(&buffer, path.c_str(), 0));
+
+        // a truncated file is refused up front
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 1);
+        CHECK_THROWS(std::runtime_error, io::compressed_reader_t(path.c_str()));
+        {
+            std::ofstream(path, std::ios::binary) << "not a compressed file at all, but long enough";
+        }
+        CHECK_THROWS(std::runtime_error, io::compressed_reader_t(path.c_str()));
+        std::filesystem::remove(path);
+    }
+}
+
+int main() {
+    std::mt19937_64 engine(0x5EED);
+    random(engine);
+    repetitive(engine);
+    corrupt(engine);
+    files(engine);
+    return test::result();
+}
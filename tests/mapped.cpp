@@ -0,0 +1,83 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <filesystem>
+#include <fstream>
+
+// io::map / attach: reads go straight to the mapping, writes and growth never reach the file
+namespace {
+    using namespace utils;
+
+    const std::string path = (std::filesystem::temp_directory_path() / "serializer_test_mapped.bin").string();
+
+    std::string content() {
+        std::ifstream file(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    void write_sample() {
+        wmemory_t buffer(0x100);
+        buffer.setInt(42);
+        buffer.setString("mapped");
+        buffer.setDouble(0.5);
+        io::serialize(&buffer, path.c_str());
+    }
+
+    void read_back() {
+        for (const int advice: {io::advice_t::normal, io::advice_t::sequential | io::advice_t::willneed,
+                                io::advice_t::random}) {
+            wmemory_t buffer(nullptr);
+            io::map(&buffer, path.c_str(), advice);
+            CHECK(buffer.size() == 4 + 8 + 6 + 8 && buffer.lens() == 0);
+            CHECK(buffer.get_int() == 42);
+            CHECK(buffer.get_string_view() == "mapped");
+            CHECK(buffer.get_double() == 0.5);
+        }
+
+        wmemory_t copied(nullptr);
+        io::deserialize(&copied, path.c_str());
+        CHECK(copied.size() == 26 && copied.get_int() == 42 && copied.get_string() == "mapped");
+    }
+
+    void private_writes() {
+        const std::string before = content();
+        wmemory_t buffer(nullptr);
+        io::map(&buffer, path.c_str());
+        buffer.setInt(-1); // copy-on-write page, the file keeps its bytes
+        CHECK(content() == before);
+
+        // growing moves the bytes into the buffer's own storage once
+        buffer.set_policy(policy_t::growable);
+        buffer.skip(buffer.size() - buffer.lens());
+        buffer.setInt(7);
+        CHECK(buffer.size() >= 30 && buffer.lens() == 30);
+        wmemory_t in(std::vector<uint8_t>(buffer.data(), buffer.data() + buffer.lens()));
+        CHECK(in.get_int() == -1 && in.get_string() == "mapped" && in.get_double() == 0.5 && in.get_int() == 7);
+        CHECK(content() == before);
+    }
+
+    void attach() {
+        std::shared_ptr<uint8_t[]> owner(new uint8_t[8]());
+        wmemory_t buffer(nullptr);
+        buffer.attach(owner.get(), 8, owner);
+        buffer.setInt(5);
+        CHECK(buffer.data() == owner.get() && owner[0] == 5); // no copy
+        CHECK_THROWS(std::invalid_argument, buffer.attach(nullptr, 8, nullptr));
+    }
+
+    void errors() {
+        CHECK_THROWS(std::runtime_error, io::mapped_file_t("/nonexistent/serializer_test"));
+        std::ofstream(path, std::ios::trunc).close();
+        CHECK_THROWS(std::runtime_error, io::mapped_file_t(path.c_str()));
+    }
+}
+
+int main() {
+    write_sample();
+    read_back();
+    private_writes();
+    attach();
+    errors();
+    std::filesystem::remove(path);
+    return test::result();
+}
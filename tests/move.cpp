@@ -0,0 +1,152 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <deque>
+#include <memory_resource>
+
+// wmemory_t moves, swap, release and adopt: storage changes hands without copying
+namespace {
+    using namespace utils;
+
+    void moves() {
+        wmemory_t source(0x10, policy_t::growable);
+        for (int i = 0; i < 100; ++i)
+            source.setInt(i);
+        const uint8_t *storage = source.data();
+        const uintmax_t lens = source.lens();
+
+        wmemory_t moved(std::move(source));
+        CHECK(moved.data() == storage);
+        CHECK(moved.lens() == lens);
+        CHECK(moved.policy() == policy_t::growable);
+        CHECK(source.lens() == 0 && source.size() == 0 && source.data() == nullptr);
+
+        wmemory_t assigned(0x8);
+        assigned = std::move(moved);
+        CHECK(assigned.data() == storage);
+        CHECK(assigned.lens() == lens);
+        CHECK(moved.data() == nullptr);
+        assigned.rewind();
+        bool same = true;
+        for (int i = 0; i < 100; ++i)
+            same = same && assigned.get_int() == i;
+        CHECK(same);
+
+        // attached memory moves by pointer too
+        uint8_t raw[0x10] = {};
+        wmemory_t attached(nullptr);
+        attached.attach(raw, sizeof(raw), nullptr);
+        attached.setInt(7);
+        wmemory_t taken(std::move(attached));
+        CHECK(taken.data() == raw && taken.lens() == sizeof(int));
+
+        std::deque<wmemory_t> queue;
+        queue.push_back(std::move(taken));
+        CHECK(queue.front().data() == raw);
+
+        static_assert(std::is_nothrow_move_constructible_v<wmemory_t>);
+        static_assert(std::is_nothrow_move_assignable_v<wmemory_t>);
+    }
+
+    void swaps() {
+        wmemory_t first(0x10), second(0x20, policy_t::growable);
+        first.setInt(1);
+        second.setString("second");
+        const uint8_t *one = first.data(), *two = second.data();
+        const uintmax_t lens = second.lens();
+
+        swap(first, second);
+        CHECK(first.data() == two && second.data() == one);
+        CHECK(first.lens() == lens && second.lens() == sizeof(int));
+        CHECK(first.policy() == policy_t::growable && second.policy() == policy_t::fixed);
+        first.swap(second);
+        CHECK(first.data() == one && second.data() == two);
+    }
+
+    void releases() {
+        wmemory_t buffer(0x100);
+        buffer.setInt(42);
+        buffer.setString("bytes");
+        const uint8_t *storage = buffer.data();
+        const uintmax_t lens = buffer.lens();
+
+        std::vector<uint8_t> bytes = buffer.release();
+        CHECK(bytes.data() == storage); // the same allocation
+        CHECK(bytes.size() == lens);
+        CHECK(buffer.data() == nullptr && buffer.lens() == 0);
+
+        wmemory_t reader(nullptr);
+        reader.adopt(std::move(bytes));
+        CHECK(bytes.empty());
+        CHECK(reader.data() == storage);
+        CHECK(reader.size() == lens && reader.lens() == 0);
+        CHECK(reader.get_int() == 42);
+        CHECK(reader.get_string() == "bytes");
+
+        // attached memory is copied once
+        uint8_t raw[0x10] = {};
+        wmemory_t attached(nullptr);
+        attached.attach(raw, sizeof(raw), nullptr);
+        attached.setShort(5);
+        std::vector<uint8_t> copied = attached.release();
+        CHECK(copied.size() == sizeof(short) && copied.data() != raw);
+        CHECK(attached.data() == nullptr);
+
+        wmemory_t empty(nullptr);
+        CHECK(empty.release().empty());
+    }
+
+    void adopts() {
+        std::unique_ptr<uint8_t[]> data(new uint8_t[0x20]);
+        uint8_t *raw = data.get();
+        wmemory_t buffer(nullptr);
+        buffer.adopt(std::move(data), 0x20);
+        CHECK(buffer.data() == raw && buffer.size() == 0x20);
+        buffer.setLong(9);
+        buffer.rewind();
+        CHECK(buffer.get_long() == 9);
+
+        // a custom deleter runs once the buffer lets go of the allocation
+        int deleted = 0;
+        auto deleter = [&deleted](uint8_t *bytes) { ++deleted, delete[] bytes; };
+        {
+            wmemory_t owner(nullptr);
+            owner.adopt(std::unique_ptr<uint8_t[], decltype(deleter)>(new uint8_t[0x10], deleter), 0x10);
+            CHECK(deleted == 0);
+        }
+        CHECK(deleted == 1);
+
+        wmemory_t invalid(nullptr);
+        CHECK_THROWS(std::invalid_argument, invalid.adopt(std::unique_ptr<uint8_t[]>(), 0x10));
+        CHECK_THROWS(std::invalid_argument, invalid.adopt(std::unique_ptr<uint8_t[]>(new uint8_t[1]), 0));
+    }
+
+    // vectors from another resource are copied into the buffer's own
+    void resources() {
+        std::pmr::monotonic_buffer_resource first, second;
+        pmr_wmemory_t writer(0x40, &first);
+        writer.setInt(3);
+        writer.setString("pmr");
+
+        std::pmr::vector<uint8_t> bytes = writer.release();
+        const uint8_t *storage = bytes.data();
+        pmr_wmemory_t same(nullptr, &first), other(nullptr, &second);
+        same.adopt(std::pmr::vector<uint8_t>(bytes, &first));
+        other.adopt(std::move(bytes));
+        CHECK(other.data() != storage);
+        CHECK(other.get_int() == 3 && other.get_string() == "pmr");
+        CHECK(same.get_int() == 3 && same.get_string() == "pmr");
+
+        pmr_wmemory_t moved(std::move(other));
+        CHECK(moved.get_allocator().resource() == &second);
+    }
+}
+
+int main() {
+    moves();
+    swaps();
+    releases();
+    adopts();
+    resources();
+    return test::result();
+}
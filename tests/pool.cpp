@@ -0,0 +1,123 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <thread>
+
+// buffer_pool_t: buffers come back empty and are reused, returns from other threads are drained
+namespace {
+    using namespace utils;
+
+    void reuse() {
+        buffer_pool_t pool(0x100, policy_t::growable, 2);
+        uint8_t *storage;
+        {
+            buffer_pool_t::handle_t buffer = pool.acquire();
+            CHECK(static_cast<bool>(buffer));
+            CHECK(buffer->lens() == 0);
+            CHECK(buffer->size() >= 0x100);
+            for (int i = 0; i < 100; ++i)
+                buffer->setInt(i);
+            storage = buffer->data();
+        }
+        CHECK(pool.misses() == 1);
+        CHECK(pool.idle() == 1);
+
+        buffer_pool_t::handle_t buffer = pool.acquire();
+        CHECK(pool.hits() == 1);
+        CHECK(buffer->data() == storage);
+        CHECK(buffer->lens() == 0); // behaves like a fresh buffer
+        buffer->setString("again");
+        CHECK(buffer->lens() > 0);
+
+        // the idle list keeps at most `limit` buffers
+        std::vector<buffer_pool_t::handle_t> handles;
+        for (int i = 0; i < 5; ++i)
+            handles.push_back(pool.acquire());
+        handles.clear();
+        CHECK(pool.idle() == 2);
+
+        buffer.reset();
+        CHECK(!buffer);
+        CHECK(pool.idle() == 2);
+    }
+
+    // a recycled buffer keeps its storage as is, only the position and encoding are reset
+    void recycled() {
+        static uint8_t outside[0x40];
+        buffer_pool_t pool(0x1000, policy_t::fixed);
+        uint8_t *storage;
+        {
+            buffer_pool_t::handle_t buffer = pool.acquire();
+            buffer->set_encoding(encoding_t::compact);
+            buffer->setBytes(0x5A);
+            storage = buffer->data();
+        }
+        {
+            buffer_pool_t::handle_t buffer = pool.acquire();
+            CHECK(buffer->data() == storage);
+            CHECK(buffer->lens() == 0);
+            CHECK(buffer->size() >= 0x1000);
+            CHECK(buffer->encoding() == encoding_t::fixed);
+            CHECK(buffer->data()[0] == 0x5A); // not refilled
+
+            // attached memory is dropped, the buffer gets storage of its own again
+            buffer->attach(outside, sizeof(outside), nullptr);
+        }
+        buffer_pool_t::handle_t buffer = pool.acquire();
+        CHECK(buffer->data() != outside);
+        CHECK(buffer->size() >= 0x1000);
+    }
+
+    void moves() {
+        buffer_pool_t pool(0x40);
+        buffer_pool_t::handle_t first = pool.acquire();
+        buffer_pool_t::handle_t second = std::move(first);
+        CHECK(!first);
+        CHECK(static_cast<bool>(second));
+        first = std::move(second);
+        CHECK(static_cast<bool>(first));
+        first = buffer_pool_t::handle_t();
+        CHECK(pool.idle() == 1);
+        CHECK_THROWS(std::invalid_argument, buffer_pool_t(0));
+    }
+
+    void other_thread() {
+        buffer_pool_t pool(0x100);
+        std::vector<buffer_pool_t::handle_t> handles;
+        for (int i = 0; i < 4; ++i)
+            handles.push_back(pool.acquire());
+        std::thread([&] { handles.clear(); }).join(); // released on a thread that doesn't own the pool
+        CHECK(pool.idle() == 0);
+
+        buffer_pool_t::handle_t buffer = pool.acquire(); // drains the return list
+        CHECK(pool.hits() == 1);
+        CHECK(pool.idle() == 3);
+    }
+
+    void outlives_pool() {
+        buffer_pool_t::handle_t buffer;
+        {
+            buffer_pool_t pool(0x100);
+            buffer = pool.acquire();
+        }
+        buffer->setInt(7);
+        CHECK(buffer->lens() == sizeof(int));
+    }
+
+    void local() {
+        buffer_pool_t *mine = &buffer_pool_t::local(), *theirs = nullptr;
+        CHECK(mine == &buffer_pool_t::local());
+        std::thread([&] { theirs = &buffer_pool_t::local(); }).join();
+        CHECK(mine != theirs);
+    }
+}
+
+int main() {
+    reuse();
+    recycled();
+    moves();
+    other_thread();
+    outlives_pool();
+    local();
+    return test::result();
+}
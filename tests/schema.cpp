@@ -0,0 +1,166 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+
+// set_struct / get_struct: wire layout in every encoding, round-trips and truncated input
+struct position_t {
+    int x;
+    int y;
+};
+
+struct order_t {
+    uint32_t id;
+    short quantity;
+    double price;
+    std::string symbol;
+    std::vector<uint16_t> fills;
+    position_t at;
+};
+
+struct record_t {
+    std::string name;
+    uint64_t count;
+};
+
+template<>
+struct utils::schema_t<position_t> {
+    static constexpr auto fields = std::make_tuple(&position_t::x, &position_t::y);
+};
+
+template<>
+struct utils::schema_t<order_t> {
+    static constexpr auto fields = std::make_tuple(&order_t::id, &order_t::quantity, &order_t::price,
+                                                   &order_t::symbol, &order_t::fills, &order_t::at);
+};
+
+template<>
+struct utils::schema_t<record_t> {
+    static constexpr auto fields = std::make_tuple(&record_t::name, &record_t::count);
+};
+
+namespace {
+    using namespace utils;
+
+    const order_t sample{0x01020304, -2, 1.5, "ACME", {0x0A0B, 7}, {-1, 0x7FFFFFFF}};
+
+    bool same(const order_t &first, const order_t &second) {
+        return first.id == second.id && first.quantity == second.quantity && first.price == second.price
+               && first.symbol == second.symbol && first.fills == second.fills
+               && first.at.x == second.at.x && first.at.y == second.at.y;
+    }
+
+    std::vector<uint8_t> encode(const int &encoding) {
+        wmemory_t buffer(0x10, policy_t::growable);
+        buffer.set_encoding(encoding);
+        buffer.set_struct(sample);
+        return {buffer.data(), buffer.data() + buffer.lens()};
+    }
+
+    void layout() {
+        const std::vector<uint8_t> little = encode(encoding_t::little);
+        // id, quantity, price, symbol length + bytes, fills count + elements, x, y
+        CHECK(little.size() == 4 + 2 + 8 + 8 + 4 + 8 + 2 * 2 + 4 + 4);
+        CHECK(little[0] == 0x04 && little[1] == 0x03 && little[2] == 0x02 && little[3] == 0x01);
+        CHECK(little[4] == 0xFE && little[5] == 0xFF);
+        CHECK(little[14] == 4 && little[21] == 0 && little[22] == 'A' && little[25] == 'E');
+        CHECK(little[26] == 2 && little[34] == 0x0B && little[35] == 0x0A);
+
+        const std::vector<uint8_t> big = encode(encoding_t::big);
+        CHECK(big.size() == little.size());
+        CHECK(big[0] == 0x01 && big[1] == 0x02 && big[2] == 0x03 && big[3] == 0x04);
+        CHECK(big[21] == 4 && big[22] == 'A');
+        CHECK(big[34] == 0x0A && big[35] == 0x0B);
+
+        // compact: zigzag varints for the integers, varint lengths
+        const std::vector<uint8_t> compact = encode(encoding_t::compact);
+        CHECK(compact.size() < little.size());
+    }
+
+    void round_trip() {
+        for (const int encoding: {encoding_t::fixed, encoding_t::little, encoding_t::big, encoding_t::compact,
+                                  encoding_t::compact | encoding_t::big}) {
+            const std::vector<uint8_t> bytes = encode(encoding);
+            wmemory_t buffer(bytes);
+            buffer.set_encoding(encoding);
+            const order_t decoded = buffer.get_struct<order_t>();
+            CHECK(same(decoded, sample));
+            CHECK(buffer.lens() == bytes.size());
+        }
+
+        // several structs back to back, empty strings and vectors
+        wmemory_t buffer(0x10, policy_t::growable);
+        order_t empty{};
+        buffer.set_struct(sample);
+        buffer.set_struct(empty);
+        buffer.set_struct(sample);
+        buffer.rewind();
+        CHECK(same(buffer.get_struct<order_t>(), sample));
+        CHECK(same(buffer.get_struct<order_t>(), empty));
+        CHECK(same(buffer.get_struct<order_t>(), sample));
+    }
+
+    void truncated() {
+        for (const int encoding: {encoding_t::fixed, encoding_t::big}) {
+            std::vector<uint8_t> bytes = encode(encoding);
+            for (size_t size = 1; size < bytes.size(); ++size) {
+                wmemory_t buffer(bytes.data(), size);
+                buffer.set_encoding(encoding);
+                CHECK_THROWS(std::out_of_range, buffer.get_struct<order_t>());
+                CHECK(buffer.lens() == 0);
+            }
+
+            // a corrupt fills count far beyond the buffer
+            std::fill(bytes.begin() + 26, bytes.begin() + 34, uint8_t(0x7F));
+            wmemory_t buffer(bytes);
+            buffer.set_encoding(encoding);
+            CHECK_THROWS(std::out_of_range, buffer.get_struct<order_t>());
+        }
+
+        // compact lengths, counts and integers are varints, any of them can be cut
+        for (const int encoding: {encoding_t::compact, encoding_t::compact | encoding_t::big}) {
+            std::vector<uint8_t> bytes = encode(encoding);
+            for (size_t size = 1; size < bytes.size(); ++size) {
+                wmemory_t buffer(bytes.data(), size);
+                buffer.set_encoding(encoding);
+                CHECK_THROWS(std::out_of_range, buffer.get_struct<order_t>());
+                CHECK(buffer.lens() == 0);
+            }
+        }
+
+        wmemory_t record(0x10, policy_t::growable);
+        record.set_encoding(encoding_t::compact);
+        record.set_struct(record_t{std::string(40, 'r'), 0xFFFFFFFFFFFF});
+        std::vector<uint8_t> encoded(record.data(), record.data() + record.lens());
+        for (size_t size = 1; size < encoded.size(); ++size) {
+            wmemory_t buffer(encoded.data(), size);
+            buffer.set_encoding(encoding_t::compact);
+            CHECK_THROWS(std::out_of_range, buffer.get_struct<record_t>());
+            CHECK(buffer.lens() == 0);
+        }
+
+        // a corrupt string length, fills count and endless varint
+        std::vector<uint8_t> bytes = encode(encoding_t::compact);
+        const size_t symbol = 4 + 1 + sizeof(double); // after the id, quantity and price
+        CHECK(bytes[symbol] == sample.symbol.size());
+        for (const std::vector<uint8_t> &corrupt: {std::vector<uint8_t>{0xFF, 0xFF, 0x7F}, std::vector<uint8_t>(12, 0xFF)}) {
+            std::vector<uint8_t> changed(bytes.begin(), bytes.begin() + symbol);
+            changed.insert(changed.end(), corrupt.begin(), corrupt.end());
+            changed.insert(changed.end(), bytes.begin() + symbol + 1, bytes.end());
+            wmemory_t buffer(changed);
+            buffer.set_encoding(encoding_t::compact);
+            CHECK_THROWS(std::out_of_range, buffer.get_struct<order_t>());
+            CHECK(buffer.lens() == 0);
+        }
+        bytes[symbol + 1 + sample.symbol.size()] = 0x7F;
+        wmemory_t buffer(bytes);
+        buffer.set_encoding(encoding_t::compact);
+        CHECK_THROWS(std::out_of_range, buffer.get_struct<order_t>());
+    }
+}
+
+int main() {
+    layout();
+    round_trip();
+    truncated();
+    return test::result();
+}
@@ -0,0 +1,117 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <filesystem>
+#include <fstream>
+
+// io::snapshot_t: the target holds the old or the new content, never leftovers, group commits
+namespace {
+    using namespace utils;
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path() / "serializer_test_snapshot";
+
+    std::string content(const std::filesystem::path &path) {
+        std::ifstream file(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    // nothing but the targets is left in the directory
+    size_t entries() {
+        return std::distance(std::filesystem::directory_iterator(directory), std::filesystem::directory_iterator());
+    }
+
+    void replace() {
+        const std::filesystem::path target = directory / "state.bin";
+        {
+            std::ofstream(target, std::ios::binary) << "previous";
+        }
+        {
+            io::snapshot_t snapshot(target.string().c_str());
+            snapshot.write(std::span<const uint8_t>(reinterpret_cast<const uint8_t *>("new "), 4));
+            wmemory_t buffer(0x40);
+            buffer.setBytes('!');
+            snapshot.write(&buffer);
+            CHECK(snapshot.written() == 5);
+            CHECK(content(target) == "previous"); // untouched until the commit
+            CHECK(entries() == 2);
+            snapshot.commit();
+            CHECK_THROWS(std::runtime_error, snapshot.write(std::span<const uint8_t>()));
+            CHECK_THROWS(std::runtime_error, snapshot.commit());
+        }
+        CHECK(content(target) == "new !");
+        CHECK(entries() == 1);
+
+        // dropped without a commit, the target stays as it was
+        {
+            io::snapshot_t snapshot(target.string().c_str(), 0x10);
+            for (int i = 0; i < 100; ++i)
+                snapshot.write(std::span<const uint8_t>(reinterpret_cast<const uint8_t *>("abcdefgh"), 8));
+        }
+        CHECK(content(target) == "new !");
+        CHECK(entries() == 1);
+    }
+
+    void group() {
+        std::filesystem::create_directories(directory / "nested");
+        std::vector<std::unique_ptr<io::snapshot_t> > snapshots;
+        std::vector<io::snapshot_t *> pointers;
+        for (int i = 0; i < 10; ++i) {
+            const std::filesystem::path target = directory / (i % 2 ? "nested" : ".") / ("part_" + std::to_string(i));
+            snapshots.push_back(std::make_unique<io::snapshot_t>(target.string().c_str()));
+            const std::string text = std::to_string(i * i);
+            snapshots.back()->write(std::span<const uint8_t>(reinterpret_cast<const uint8_t *>(text.data()), text.size()));
+            pointers.push_back(snapshots.back().get());
+        }
+        io::commit(std::span<io::snapshot_t *const>(pointers));
+        for (int i = 0; i < 10; ++i)
+            CHECK(content(snapshots[i]->target()) == std::to_string(i * i));
+
+        io::snapshot_t first((directory / "first").string().c_str()), second((directory / "second").string().c_str());
+        io::commit({&first, &second});
+        CHECK(std::filesystem::exists(directory / "first") && std::filesystem::exists(directory / "second"));
+    }
+
+    // the target keeps its permissions, a new file gets the usual ones
+    void permissions() {
+        using std::filesystem::perms;
+        const std::filesystem::path target = directory / "private.bin";
+        {
+            std::ofstream(target, std::ios::binary) << "secret";
+        }
+        std::filesystem::permissions(target, perms::owner_read | perms::owner_write);
+        {
+            io::snapshot_t snapshot(target.string().c_str());
+            snapshot.commit();
+        }
+        CHECK((std::filesystem::status(target).permissions() & perms::all) == (perms::owner_read | perms::owner_write));
+
+        const std::filesystem::path created = directory / "created.bin";
+        const mode_t mask = ::umask(0);
+        ::umask(mask);
+        {
+            io::snapshot_t snapshot(created.string().c_str());
+            snapshot.commit();
+        }
+        CHECK((std::filesystem::status(created).permissions() & perms::all) == static_cast<perms>(0666 & ~mask));
+    }
+
+    void failures() {
+        const std::string missing = (directory / "missing" / "file.bin").string();
+        CHECK_THROWS(std::runtime_error, io::snapshot_t(missing.c_str()));
+
+        wmemory_t buffer(0x10);
+        buffer.setInt(1);
+        CHECK_THROWS(std::runtime_error, io::serialize(&buffer, missing.c_str()));
+    }
+}
+
+int main() {
+    std::filesystem::remove_all(directory);
+    std::filesystem::create_directories(directory);
+    replace();
+    group();
+    permissions();
+    failures();
+    std::filesystem::remove_all(directory);
+    return test::result();
+}
@@ -0,0 +1,117 @@
+#define __USING_SERIALIZER__
+#define __SERIALIZER_STATS__
+#include "../serializer.h"
+#include "test.h"
+#include <filesystem>
+#include <thread>
+
+// stats: counters follow buffer and file traffic, survive their thread, heap gauges, snapshot text
+namespace {
+    using namespace utils;
+
+    const std::string path = (std::filesystem::temp_directory_path() / "serializer_test_stats.bin").string();
+
+    // change of every counter over `work`
+    template<class _work>
+    std::vector<uint64_t> delta(_work &&work) {
+        std::vector<uint64_t> before(stats::counter_t::count);
+        for (size_t i = 0; i < before.size(); ++i)
+            before[i] = stats::value(i);
+        work();
+        for (size_t i = 0; i < before.size(); ++i)
+            before[i] = stats::value(i) - before[i];
+        return before;
+    }
+
+    void buffers() {
+        using stats::counter_t;
+        wmemory_t buffer(0x8, policy_t::growable);
+        std::vector<uint64_t> counted = delta([&] {
+            buffer.setInt(1);
+            buffer.setDouble(2.0);
+            buffer.setString("abc");
+        });
+        CHECK(counted[counter_t::buffer_writes] == 3);
+        CHECK(counted[counter_t::buffer_write_bytes] == buffer.lens());
+        CHECK(counted[counter_t::buffer_resizes] >= 1);
+
+        buffer.rewind();
+        counted = delta([&] {
+            (void) buffer.get_int();
+            (void) buffer.get_double();
+        });
+        CHECK(counted[counter_t::buffer_reads] == 2);
+        CHECK(counted[counter_t::buffer_read_bytes] == sizeof(int) + sizeof(double));
+
+        wmemory_t fixed(0x4);
+        counted = delta([&] { CHECK_THROWS(std::runtime_error, fixed.setLong(1)); });
+        CHECK(counted[counter_t::buffer_overflows] == 1);
+        CHECK(counted[counter_t::buffer_writes] == 0);
+    }
+
+    void files() {
+        using stats::counter_t;
+        wmemory_t buffer(0x1000);
+        for (int i = 0; i < 100; ++i)
+            buffer.setInt(i);
+        std::vector<uint64_t> counted = delta([&] { io::serialize(&buffer, path.c_str()); });
+        CHECK(counted[counter_t::io_writes] >= 1);
+        CHECK(counted[counter_t::io_write_bytes] == buffer.lens());
+
+        wmemory_t read(nullptr);
+        counted = delta([&] { io::deserialize(&read, path.c_str()); });
+        CHECK(counted[counter_t::io_read_bytes] == buffer.lens());
+        std::filesystem::remove(path);
+    }
+
+    // counts of a thread that exited are kept
+    void threads() {
+        const uint64_t before = stats::value(stats::counter_t::buffer_writes);
+        std::thread([] {
+            wmemory_t buffer(0x100);
+            for (int i = 0; i < 10; ++i)
+                buffer.setInt(i);
+        }).join();
+        CHECK(stats::value(stats::counter_t::buffer_writes) == before + 10);
+    }
+
+    void gauges() {
+        heap_t heap(0x10000);
+        CHECK(heap.used() == 0 && heap.peak() == 0);
+        void *first = heap.alloc(100), *second = heap.alloc(200), *third = heap.alloc(300);
+        CHECK(heap.used() == align(100) + align(200) + align(300));
+        heap.free(second);
+        CHECK(heap.used() == align(100) + align(300));
+        CHECK(heap.peak() == align(100) + align(200) + align(300));
+        CHECK(heap.free_blocks() == 2); // the hole and the rest of the region
+        heap.free(first);
+        heap.free(third);
+        CHECK(heap.used() == 0);
+        CHECK(heap.free_blocks() == 1);
+        heap.initialize();
+        CHECK(heap.peak() == 0);
+    }
+
+    void snapshot() {
+        wmemory_t buffer(0x8, policy_t::growable);
+        for (int i = 0; i < 100; ++i)
+            buffer.setInt(i);
+        const std::string text = stats::snapshot();
+        CHECK(text.find("# TYPE serializer_buffer_writes_total counter\n") != std::string::npos);
+        CHECK(text.find("\nserializer_buffer_writes_total " + std::to_string(stats::value(stats::counter_t::buffer_writes)) + "\n")
+            != std::string::npos);
+        CHECK(text.find("serializer_buffer_resize_ns_bucket{le=\"+Inf\"}") != std::string::npos);
+        CHECK(text.find("serializer_heap_size_bytes " + std::to_string(HEAP_SIZE)) != std::string::npos);
+        CHECK(text.back() == '\n');
+    }
+}
+
+int main() {
+    static_assert(stats::enabled);
+    buffers();
+    files();
+    threads();
+    gauges();
+    snapshot();
+    return test::result();
+}
@@ -0,0 +1,156 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <filesystem>
+#include <fstream>
+
+// stream_writer_t / stream_reader_t: same bytes as a wmemory_t, values and strings across chunk boundaries, early ends
+namespace {
+    using namespace utils;
+
+    const std::string path = (std::filesystem::temp_directory_path() / "serializer_test_stream.bin").string();
+
+    template<class _writer>
+    void fill(_writer &out, const std::string &large) {
+        for (int i = 0; i < 1000; ++i) {
+            out.setBytes(static_cast<char>(i));
+            out.setInt(i);
+            out.setDouble(i * 0.5);
+            out.setString("value " + std::to_string(i));
+            out.setULong(uint64_t(i) << 40);
+        }
+        out.setString(large); // bigger than the staging buffer
+        out.setBool(true);
+    }
+
+    std::vector<uint8_t> file_bytes() {
+        wmemory_t buffer(nullptr);
+        io::deserialize(&buffer, path.c_str());
+        return {buffer.data(), buffer.data() + buffer.size()};
+    }
+
+    void round_trip(const uintmax_t &chunk) {
+        const std::string large(chunk * 3 + 7, 'L');
+        wmemory_t expected(0x40, policy_t::growable);
+        fill(expected, large);
+        {
+            io::stream_writer_t writer(path.c_str(), chunk);
+            fill(writer, large);
+            CHECK(writer.lens() == expected.lens());
+        }
+        const std::vector<uint8_t> written = file_bytes();
+        CHECK(written == std::vector<uint8_t>(expected.data(), expected.data() + expected.lens()));
+
+        io::stream_reader_t reader(path.c_str(), chunk);
+        bool same = true;
+        for (int i = 0; i < 1000; ++i) {
+            same &= reader.get_bytes() == static_cast<char>(i);
+            same &= reader.get_int() == i;
+            same &= reader.get_double() == i * 0.5;
+            same &= (i % 2 ? reader.get_string() : std::string(reader.get_string_view())) == "value " + std::to_string(i);
+            same &= reader.get_uint64() == uint64_t(i) << 40;
+        }
+        CHECK(same);
+        CHECK(reader.get_string() == large);
+        CHECK(reader.get_bool() == true);
+        CHECK(reader.eof());
+    }
+
+    void borrowed_descriptor() {
+        const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        {
+            io::stream_writer_t writer(fd, 0x40);
+            writer.setInt(11);
+        }
+        CHECK(::write(fd, "\x0c\0\0\0", 4) == 4); // the writer flushed and left fd open
+        ::close(fd);
+
+        const int in = ::open(path.c_str(), O_RDONLY);
+        {
+            io::stream_reader_t reader(in, 0x40);
+            CHECK(reader.get_int() == 11 && reader.get_int() == 12 && reader.eof());
+        }
+        CHECK(::close(in) == 0);
+    }
+
+    void write_file(const std::string &bytes) {
+        std::ofstream(path, std::ios::binary) << bytes;
+    }
+
+    // the staging buffer must hold the longest value, a 10-byte varint
+    void small_chunk() {
+        for (const uintmax_t chunk: {0, 4, 9}) {
+            CHECK_THROWS(std::invalid_argument, io::stream_writer_t(path.c_str(), chunk));
+            CHECK_THROWS(std::invalid_argument, io::stream_reader_t(path.c_str(), chunk));
+            CHECK_THROWS(std::invalid_argument, io::stream_writer_t(STDOUT_FILENO, chunk));
+            CHECK_THROWS(std::invalid_argument, io::stream_reader_t(STDIN_FILENO, chunk));
+        }
+
+        // compact values up to the very end of the stream, the last ones shorter than their worst case
+        {
+            io::stream_writer_t writer(path.c_str(), 10);
+            writer.set_encoding(encoding_t::compact);
+            for (int64_t i = 0; i < 300; ++i)
+                writer.setLong(i * i * i * (i % 2 ? -1 : 1));
+            writer.setString("end");
+            writer.setULong(UINT64_MAX);
+            writer.setInt(1);
+        }
+        io::stream_reader_t reader(path.c_str(), 10);
+        reader.set_encoding(encoding_t::compact);
+        bool same = true;
+        for (int64_t i = 0; i < 300; ++i)
+            same &= reader.get_long() == i * i * i * (i % 2 ? -1 : 1);
+        CHECK(same);
+        CHECK(reader.get_string_view() == "end");
+        CHECK(reader.get_uint64() == UINT64_MAX);
+        CHECK(reader.get_int() == 1);
+        CHECK(reader.eof());
+    }
+
+    void early_eof() {
+        write_file(std::string("\x01\x02", 2));
+        {
+            io::stream_reader_t reader(path.c_str(), 10);
+            CHECK_THROWS(std::runtime_error, reader.get_int());
+        }
+        write_file(std::string("\x01\x02\x03\x04", 4));
+        {
+            io::stream_reader_t reader(path.c_str(), 10);
+            CHECK_THROWS(std::runtime_error, reader.get_long());
+        }
+        write_file(std::string("\x05\0\0\0", 4)); // a length prefix cut short
+        {
+            io::stream_reader_t reader(path.c_str(), 0x40);
+            CHECK_THROWS(std::runtime_error, reader.get_string());
+        }
+        write_file(std::string("\x05\0\0\0\0\0\0\0abc", 11)); // characters cut short
+        {
+            io::stream_reader_t reader(path.c_str(), 0x40);
+            CHECK_THROWS(std::runtime_error, reader.get_string_view());
+        }
+        write_file(std::string("\x81\x80", 2)); // a varint without its last byte
+        {
+            io::stream_reader_t reader(path.c_str(), 10);
+            reader.set_encoding(encoding_t::compact);
+            CHECK_THROWS(std::runtime_error, reader.get_int());
+        }
+        write_file(std::string("\x05" "ab", 3));
+        {
+            io::stream_reader_t reader(path.c_str(), 10);
+            reader.set_encoding(encoding_t::compact);
+            CHECK_THROWS(std::runtime_error, reader.get_string());
+        }
+    }
+}
+
+int main() {
+    for (const uintmax_t chunk: {10, 0x40, 0x1000, 0x10000})
+        round_trip(chunk);
+    borrowed_descriptor();
+    small_chunk();
+    early_eof();
+    CHECK_THROWS(std::runtime_error, io::stream_reader_t("/nonexistent/serializer_test"));
+    std::filesystem::remove(path);
+    return test::result();
+}
@@ -0,0 +1,33 @@
+#ifndef SERIALIZER_TEST_H
+#define SERIALIZER_TEST_H
+#include <cstdio>
+#include <cstdlib>
+
+namespace test {
+    inline int failures = 0;
+
+    inline void check(const bool &passed, const char *expression, const char *file, const int &line) {
+        if (!passed) {
+            std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression);
+            ++failures;
+        }
+    }
+
+    // exit code of a test executable, ctest reports it as failed when non-zero
+    inline int result() {
+        if (failures != 0)
+            std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return failures == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+}
+
+// unlike assert, stays on in Release builds
+#define CHECK(expression) test::check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+
+// checks that `statement` throws `exception`
+#define CHECK_THROWS(exception, statement) do {                                      \
+        bool thrown = false;                                                         \
+        try { statement; } catch (const exception &) { thrown = true; }              \
+        test::check(thrown, #statement " throws " #exception, __FILE__, __LINE__);   \
+    } while (false)
+#endif //SERIALIZER_TEST_H
@@ -0,0 +1,69 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <limits>
+
+// setX / get_X: every supported type round-trips, at unaligned offsets and at its limits
+namespace {
+    using namespace utils;
+
+    wmemory_t reader(wmemory_t &written) {
+        return wmemory_t(std::vector<uint8_t>(written.data(), written.data() + written.lens()));
+    }
+
+    void scalars() {
+        wmemory_t buffer(0x200);
+        buffer.setBytes('x'); // everything after it is misaligned
+        buffer.setShort(std::numeric_limits<short>::min());
+        buffer.setInt(std::numeric_limits<int>::min());
+        buffer.setLong(std::numeric_limits<long long>::max());
+        buffer.setFloat(-0.25f);
+        buffer.setDouble(std::numeric_limits<double>::lowest());
+        buffer.setUBytes(0xFF);
+        buffer.setUShort(0xFFFF);
+        buffer.setUInt(0xFFFFFFFF);
+        buffer.setULong(std::numeric_limits<uint64_t>::max());
+        buffer.setBool(true);
+        buffer.setBool(false);
+        CHECK(buffer.lens() == 1 + 2 + 4 + 8 + 4 + 8 + 1 + 2 + 4 + 8 + 1 + 1);
+
+        wmemory_t in = reader(buffer);
+        CHECK(in.get_bytes() == 'x');
+        CHECK(in.get_short() == std::numeric_limits<short>::min());
+        CHECK(in.get_int() == std::numeric_limits<int>::min());
+        CHECK(in.get_llong() == std::numeric_limits<long long>::max());
+        CHECK(in.get_float() == -0.25f);
+        CHECK(in.get_double() == std::numeric_limits<double>::lowest());
+        CHECK(static_cast<uint8_t>(in.get_bytes()) == 0xFF);
+        CHECK(in.get_ushort() == 0xFFFF);
+        CHECK(in.get_uint() == 0xFFFFFFFF);
+        CHECK(in.get_uint64() == std::numeric_limits<uint64_t>::max());
+        CHECK(in.get_bool() == true);
+        CHECK(in.get_bool() == false);
+        CHECK(in.lens() == buffer.lens());
+    }
+
+    void strings() {
+        wmemory_t buffer(0x100);
+        const std::string owned = "owned string";
+        buffer.setString(owned);
+        buffer.setStringView(std::string_view("a view"));
+        buffer.setString("");
+        buffer.setString(std::string_view("with\0zero", 9));
+        CHECK(buffer.lens() == 4 * sizeof(uint64_t) + owned.size() + 6 + 0 + 9);
+
+        wmemory_t in = reader(buffer);
+        CHECK(in.get_string() == owned);
+        const std::string_view view = in.get_string_view();
+        CHECK(view == "a view");
+        CHECK(view.data() == reinterpret_cast<const char *>(in.data()) + sizeof(uint64_t) + owned.size() + sizeof(uint64_t));
+        CHECK(in.get_string().empty());
+        CHECK(in.get_string() == std::string_view("with\0zero", 9));
+    }
+}
+
+int main() {
+    scalars();
+    strings();
+    return test::result();
+}
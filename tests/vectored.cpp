@@ -0,0 +1,88 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <filesystem>
+#include <fstream>
+#include <random>
+
+// vectored io::serialize: the file is the concatenation of the parts, buffered or O_DIRECT
+namespace {
+    using namespace utils;
+
+    const std::filesystem::path directory = std::filesystem::temp_directory_path();
+    const std::string path = (directory / "serializer_test_vectored.bin").string();
+
+    std::vector<uint8_t> file_bytes() {
+        std::ifstream file(path, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+
+    // more parts than IOV_MAX, small ones to gather, large and unaligned ones to pass through
+    std::vector<std::vector<uint8_t> > sample() {
+        std::mt19937 engine(0x5EED);
+        std::vector<std::vector<uint8_t> > parts;
+        for (int i = 0; i < 2000; ++i) {
+            const size_t size = i % 100 == 0 ? 0x10000 + engine() % 0x3000 : engine() % 0x900;
+            std::vector<uint8_t> part(size);
+            for (uint8_t &byte: part)
+                byte = static_cast<uint8_t>(engine());
+            parts.push_back(std::move(part));
+        }
+        return parts;
+    }
+
+    void parts(const int &output) {
+        const std::vector<std::vector<uint8_t> > owned = sample();
+        std::vector<std::span<const uint8_t> > spans;
+        std::vector<uint8_t> expected;
+        for (const std::vector<uint8_t> &part: owned) {
+            spans.emplace_back(part);
+            expected.insert(expected.end(), part.begin(), part.end());
+        }
+        io::serialize(std::span<const std::span<const uint8_t> >(spans), path.c_str(), output);
+        CHECK(file_bytes() == expected);
+
+        // an existing, longer file is truncated
+        io::serialize({std::span<const uint8_t>(owned[1]), std::span<const uint8_t>()}, path.c_str(), output);
+        CHECK(file_bytes() == owned[1]);
+
+        io::serialize(std::span<const std::span<const uint8_t> >(), path.c_str(), output);
+        CHECK(std::filesystem::exists(path));
+        CHECK(std::filesystem::file_size(path) == 0);
+    }
+
+    void buffers(const int &output) {
+        wmemory_t header(0x40), payload(0x10, policy_t::growable);
+        header.setString("header");
+        for (int i = 0; i < 10000; ++i)
+            payload.setInt(i);
+        io::serialize({&header, &payload}, path.c_str(), output);
+
+        wmemory_t file(nullptr);
+        io::deserialize(&file, path.c_str());
+        CHECK(file.size() == header.lens() + payload.lens());
+        CHECK(file.get_string() == "header");
+        bool same = true;
+        for (int i = 0; i < 10000; ++i)
+            same = same && file.get_int() == i;
+        CHECK(same);
+    }
+
+    void failures() {
+        const std::string missing = (directory / "serializer_missing_directory" / "file.bin").string();
+        const uint8_t byte = 0x00;
+        CHECK_THROWS(std::runtime_error, io::serialize({std::span<const uint8_t>(&byte, 1)}, missing.c_str()));
+        CHECK_THROWS(std::runtime_error, io::serialize({std::span<const uint8_t>(&byte, 1)}, missing.c_str(),
+                         io::output_t::direct));
+    }
+}
+
+int main() {
+    for (const int &output: {io::output_t::buffered, io::output_t::direct}) {
+        parts(output);
+        buffers(output);
+    }
+    failures();
+    std::filesystem::remove(path);
+    return test::result();
+}
@@ -0,0 +1,167 @@
+#define __USING_SERIALIZER__
+#include "../serializer.h"
+#include "test.h"
+#include <filesystem>
+
+// read_view_t: same values as the buffer, loaded buffers, sticky errors that leave the position alone, corrupt lengths
+namespace {
+    using namespace utils;
+
+    void values(const int &encoding) {
+        wmemory_t buffer(0x10, policy_t::growable);
+        buffer.set_encoding(encoding);
+        buffer.setInt(-5);
+        buffer.setLong(-1234567890123);
+        buffer.setUShort(0xBEEF);
+        buffer.setDouble(2.5);
+        buffer.setBool(true);
+        buffer.setString("view");
+        buffer.set_array(std::vector<int>{1, -2, 3});
+        buffer.setUInt(99);
+
+        read_view_t view = buffer.view();
+        CHECK(view.size() == buffer.lens());
+        CHECK(view.get_int() == -5);
+        CHECK(view.get_long() == -1234567890123);
+        CHECK(view.get_ushort() == 0xBEEF);
+        CHECK(view.get_double() == 2.5);
+        CHECK(view.get_bool());
+        CHECK(view.get_string_view() == "view");
+        int out[3] = {};
+        CHECK(view.get_array(std::span<int>(out)) == 3);
+        CHECK(out[0] == 1 && out[1] == -2 && out[2] == 3);
+        CHECK(view.get_uint() == 99);
+        CHECK(view.ok());
+        CHECK(view.remaining() == 0);
+        CHECK(buffer.lens() == view.size()); // the buffer's own position didn't move
+    }
+
+    // view() covers the written bytes, read_view() what a loaded buffer has left to read
+    void loaded() {
+        const std::string path = (std::filesystem::temp_directory_path() / "serializer_test_view.bin").string();
+        wmemory_t out(0x40);
+        out.setInt(7);
+        out.setString("loaded");
+        out.setDouble(0.25);
+        io::serialize(&out, path.c_str());
+
+        wmemory_t in(nullptr);
+        io::deserialize(&in, path.c_str());
+        std::filesystem::remove(path);
+        CHECK(in.view().size() == 0);
+        read_view_t view = in.read_view();
+        CHECK(view.size() == out.lens());
+        CHECK(view.get_int() == 7 && view.get_string_view() == "loaded" && view.get_double() == 0.25);
+        CHECK(view.ok() && view.remaining() == 0);
+        CHECK(in.lens() == 0); // the buffer's own position didn't move
+
+        CHECK(in.get_int() == 7);
+        read_view_t rest = in.read_view();
+        CHECK(rest.size() == out.lens() - sizeof(int));
+        CHECK(rest.get_string() == "loaded");
+
+        // a string longer than what remains fails, the flag sticks and the position stays
+        std::vector<uint8_t> bytes(out.data(), out.data() + out.lens() - sizeof(double) - 1);
+        wmemory_t adopted(nullptr);
+        adopted.adopt(std::move(bytes));
+        read_view_t cut = adopted.read_view();
+        CHECK(cut.get_int() == 7);
+        CHECK(cut.get_string_view().empty());
+        CHECK(!cut.ok() && cut.position() == sizeof(int));
+        CHECK(cut.get_short() == 0 && !cut.ok() && cut.position() == sizeof(int));
+
+        // nothing left to read, or a position already past the end
+        wmemory_t read(out);
+        read.skip(read.size() - read.lens());
+        CHECK(read.read_view().size() == 0);
+        read.skip(1);
+        CHECK(read.read_view().size() == 0);
+        CHECK(read.read_view().get_int() == 0 && !read.read_view().get_bool());
+    }
+
+    void records() {
+        wmemory_t buffer(0x100);
+        for (int i = 0; i < 3; ++i) {
+            buffer.setInt(i);
+            buffer.setDouble(i * 0.5);
+        }
+        read_view_t view = buffer.view();
+        int id;
+        double value;
+        for (int i = 0; i < 3; ++i) {
+            CHECK(view.read(id, value));
+            CHECK(id == i && value == i * 0.5);
+        }
+        id = 42;
+        CHECK(!view.read(id, value)); // nothing left, the outputs are untouched
+        CHECK(id == 42);
+    }
+
+    void sticky() {
+        const uint8_t bytes[6] = {1, 0, 0, 0, 2, 0};
+        read_view_t view(bytes, sizeof(bytes));
+        CHECK(view.get_int() == 1);
+        CHECK(view.get_int() == 0); // only two bytes left
+        CHECK(!view.ok());
+        CHECK(view.position() == 4);
+        CHECK(view.get_short() == 0); // would fit, but the flag is sticky
+        CHECK(!view);
+        CHECK(view.position() == 4);
+        CHECK(!view.skip(1));
+
+        view.rewind();
+        CHECK(view.ok());
+        CHECK(view.skip(4));
+        CHECK(view.get_short() == 2);
+    }
+
+    // a length prefix larger than what remains fails without reading past the end
+    void lengths() {
+        for (const int &encoding: {encoding_t::fixed, encoding_t::compact}) {
+            wmemory_t buffer(0x40);
+            buffer.set_encoding(encoding);
+            buffer.setString("truncated string");
+            read_view_t string(buffer.data(), buffer.lens() - 1, encoding);
+            CHECK(string.get_string_view().empty());
+            CHECK(!string.ok());
+            CHECK(string.position() == 0);
+
+            buffer.rewind();
+            buffer.set_array(std::vector<uint64_t>{1, 2, 3, 4});
+            uint64_t out[4] = {};
+            read_view_t array(buffer.data(), buffer.lens() - 1, encoding);
+            CHECK(array.get_array(std::span<uint64_t>(out)) == 0);
+            CHECK(!array.ok());
+            CHECK(array.position() == 0);
+
+            uint64_t small[2] = {};
+            read_view_t fits(buffer.data(), buffer.lens(), encoding);
+            CHECK(fits.get_array(std::span<uint64_t>(small)) == 0); // too many elements for the output
+            CHECK(fits.position() == 0);
+        }
+
+        // a corrupt length close to the integer limit
+        uint8_t bytes[16] = {0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 'x'};
+        read_view_t view(bytes, sizeof(bytes));
+        CHECK(view.get_string_view().empty());
+        CHECK(!view.ok());
+
+        // a varint that runs off the end
+        const uint8_t endless[3] = {0x80, 0x80, 0x80};
+        read_view_t varint(endless, sizeof(endless), encoding_t::compact);
+        CHECK(varint.get_uint() == 0);
+        CHECK(!varint.ok());
+        CHECK(varint.position() == 0);
+    }
+}
+
+int main() {
+    values(encoding_t::fixed);
+    values(encoding_t::compact);
+    values(encoding_t::big);
+    loaded();
+    records();
+    sticky();
+    lengths();
+    return test::result();
+}